@@ -0,0 +1,493 @@
+// Copyright 2023 the Polygon Mesh Processing Library developers.
+// Distributed under a MIT-style license, see LICENSE.txt for details.
+
+#include <pmp/corner_table.h>
+#include <pmp/surface_mesh.h>
+#include <pmp/stop_watch.h>
+#include <pmp/io/io.h>
+#include <pmp/algorithms/clustering.h>
+#include <pmp/algorithms/curvature.h>
+#include <pmp/algorithms/decimation.h>
+#include <pmp/algorithms/fairing.h>
+#include <pmp/algorithms/features.h>
+#include <pmp/algorithms/geodesics.h>
+#include <pmp/algorithms/laplace.h>
+#include <pmp/algorithms/meshlets.h>
+#include <pmp/algorithms/normals.h>
+#include <pmp/algorithms/parameterization.h>
+#include <pmp/algorithms/remeshing.h>
+#include <pmp/algorithms/render_buffers.h>
+#include <pmp/algorithms/reordering.h>
+#include <pmp/algorithms/shapes.h>
+#include <pmp/algorithms/smoothing.h>
+#include <pmp/algorithms/subdivision.h>
+#include <pmp/algorithms/triangulation.h>
+#include <pmp/algorithms/utilities.h>
+#include <pmp/algorithms/vertex_cache.h>
+
+#include <algorithm>
+#include <cmath>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <memory>
+#include <numeric>
+#include <string>
+#include <vector>
+
+#ifndef PMP_BENCHMARK_VERSION
+#define PMP_BENCHMARK_VERSION "unknown"
+#endif
+#ifndef PMP_BENCHMARK_BUILD_TYPE
+#define PMP_BENCHMARK_BUILD_TYPE "unknown"
+#endif
+
+using namespace pmp;
+
+namespace {
+
+// properties of input shapes, required by benchmarks
+enum Requirement
+{
+    None = 0,
+    Triangles = 1, // pure triangle mesh
+    Boundary = 2,  // mesh with boundary, e.g., for parameterization
+    Closed = 4     // mesh without boundary
+};
+
+// a shape with approx. 10 * 4^level vertices
+struct Shape
+{
+    std::string name;
+    std::function<SurfaceMesh(size_t level)> make;
+    int properties;
+};
+
+struct Benchmark
+{
+    std::string name;
+    int requirements;
+    std::function<void(SurfaceMesh&)> run;
+    std::function<void(SurfaceMesh&)> setup{}; // not timed, may be empty
+};
+
+struct Result
+{
+    std::string benchmark;
+    std::string shape;
+    size_t level;
+    size_t n_vertices;
+    size_t n_faces;
+    std::vector<double> times; // in ms
+    size_t peak_rss;           // in bytes, 0 if not available
+    std::string error;
+};
+
+// reset the peak resident set size of the process to the current one.
+// only supported by Linux, where the peak is not reset otherwise.
+bool reset_peak_rss()
+{
+#ifdef __linux__
+    std::ofstream clear_refs("/proc/self/clear_refs");
+    clear_refs << "5";
+    clear_refs.close();
+    return !clear_refs.fail();
+#else
+    return false;
+#endif
+}
+
+// peak resident set size in bytes since the last reset_peak_rss()
+size_t peak_rss()
+{
+    std::ifstream status("/proc/self/status");
+    std::string line;
+    while (std::getline(status, line))
+        if (line.compare(0, 6, "VmHWM:") == 0)
+            return 1024 * std::stoul(line.substr(6)); // in kB
+    return 0;
+}
+
+std::vector<Shape> shapes()
+{
+    return {
+        {"icosphere", [](size_t l) { return icosphere(l); },
+         Triangles | Closed},
+        {"quad_sphere", [](size_t l) { return quad_sphere(l); }, Closed},
+        {"torus",
+         [](size_t l) {
+             const size_t s = size_t(1) << (l > 0 ? l - 1 : 0);
+             return torus(5 * s, 10 * s);
+         },
+         Closed},
+        {"triangulated_plane",
+         [](size_t l) {
+             auto mesh = plane(size_t(3) << l);
+             triangulate(mesh);
+             return mesh;
+         },
+         Triangles | Boundary},
+    };
+}
+
+std::vector<Benchmark> benchmarks(const std::filesystem::path& tmp)
+{
+    // the corner table is built during setup, such that only the traversal
+    // is timed
+    auto table = std::make_shared<std::unique_ptr<CornerTable>>();
+
+    std::vector<Benchmark> result = {
+        {"vertex_normals", None, [](SurfaceMesh& m) { vertex_normals(m); }},
+        {"vertex_normals_corner_table", Triangles,
+         [table](SurfaceMesh& m) { vertex_normals(m, **table); },
+         [table](SurfaceMesh& m) {
+             *table = std::make_unique<CornerTable>(m);
+         }},
+        {"face_normals", None, [](SurfaceMesh& m) { face_normals(m); }},
+        {"curvature", Triangles,
+         [](SurfaceMesh& m) { curvature(m, Curvature::mean, 1); }},
+        {"detect_features", None,
+         [](SurfaceMesh& m) { detect_features(m, 25); }},
+        {"laplace_matrix", None,
+         [](SurfaceMesh& m) {
+             SparseMatrix L;
+             laplace_matrix(m, L);
+         }},
+        {"geodesics", Triangles,
+         [](SurfaceMesh& m) { geodesics(m, {Vertex(0)}); }},
+        {"geodesics_heat", Triangles,
+         [](SurfaceMesh& m) { geodesics_heat(m, {Vertex(0)}); }},
+        {"explicit_smoothing", None,
+         [](SurfaceMesh& m) { explicit_smoothing(m, 10); }},
+        {"implicit_smoothing", Closed,
+         [](SurfaceMesh& m) { implicit_smoothing(m, 0.001); }},
+        {"fair", Triangles | Boundary, [](SurfaceMesh& m) { fair(m); }},
+        {"harmonic_parameterization", Triangles | Boundary,
+         [](SurfaceMesh& m) { harmonic_parameterization(m); }},
+        {"lscm_parameterization", Triangles | Boundary,
+         [](SurfaceMesh& m) { lscm_parameterization(m); }},
+        {"decimate", Triangles,
+         [](SurfaceMesh& m) {
+             decimate(m, static_cast<unsigned int>(m.n_vertices() / 10));
+         }},
+        {"vertex_clustering", None,
+         [](SurfaceMesh& m) { vertex_clustering(m, 32); }},
+        {"uniform_remeshing", Triangles,
+         [](SurfaceMesh& m) { uniform_remeshing(m, mean_edge_length(m), 3); }},
+        {"adaptive_remeshing", Triangles,
+         [](SurfaceMesh& m) {
+             const Scalar l = mean_edge_length(m);
+             adaptive_remeshing(m, 0.5 * l, 2.0 * l, 0.01 * l, 3);
+         }},
+        {"loop_subdivision", Triangles,
+         [](SurfaceMesh& m) { loop_subdivision(m); }},
+        {"catmull_clark_subdivision", None,
+         [](SurfaceMesh& m) { catmull_clark_subdivision(m); }},
+        {"triangulate", None, [](SurfaceMesh& m) { triangulate(m); }},
+        {"reorder", None, [](SurfaceMesh& m) { reorder(m); }},
+        {"corner_normals", None,
+         [](SurfaceMesh& m) { corner_normals(m, Scalar(M_PI / 3)); }},
+        {"render_buffers", None,
+         [](SurfaceMesh& m) { render_buffers(m, 60); }},
+        {"optimize_draw_order", Triangles,
+         [](SurfaceMesh& m) { optimize_draw_order(m, true); }},
+        {"meshlet_lod", Triangles, [](SurfaceMesh& m) { meshlet_lod(m); }},
+        {"garbage_collection", None,
+         [](SurfaceMesh& m) { m.garbage_collection(); },
+         [](SurfaceMesh& m) {
+             for (auto v : m.vertices())
+                 if (v.idx() % 10 == 0)
+                     m.delete_vertex(v);
+         }},
+    };
+
+    // readers and writers, the readers read the file written during setup
+    const std::vector<std::pair<std::string, bool>> formats = {
+        {"obj", false}, {"off", false}, {"off", true}, {"ply", false},
+        {"ply", true},  {"glb", true},  {"stl", true}, {"pmp", true}};
+    for (const auto& [ext, binary] : formats)
+    {
+        const std::string format = ext + (binary ? "_binary" : "");
+        const auto file = tmp / (format + "." + ext);
+        const int requirements = ext == "stl" ? Triangles : None;
+        IOFlags flags;
+        flags.use_binary = binary;
+
+        // STL requires face normals
+        const auto prepare = [ext](SurfaceMesh& m) {
+            if (ext == "stl")
+                face_normals(m);
+        };
+        const auto write_file = [file, flags](SurfaceMesh& m) {
+            write(m, file, flags);
+        };
+        result.push_back(
+            {"write_" + format, requirements, write_file, prepare});
+        result.push_back({"read_" + format, requirements,
+                          [file](SurfaceMesh& m) { read(m, file); },
+                          [prepare, write_file](SurfaceMesh& m) {
+                              prepare(m);
+                              write_file(m);
+                          }});
+    }
+
+    return result;
+}
+
+// run benchmark b on shape s at the given level
+Result run(const Benchmark& b, const Shape& s, size_t level,
+           unsigned int repetitions)
+{
+    Result result{b.name, s.name, level, 0, 0, {}, 0, {}};
+    const bool measure_rss = reset_peak_rss();
+    StopWatch timer;
+    for (unsigned int i = 0; i < repetitions; ++i)
+    {
+        // create a fresh input for every run, such that copy-on-write of
+        // the properties does not distort the timings
+        auto mesh = s.make(level);
+        result.n_vertices = mesh.n_vertices();
+        result.n_faces = mesh.n_faces();
+
+        try
+        {
+            if (b.setup)
+                b.setup(mesh);
+            timer.start();
+            b.run(mesh);
+            timer.stop();
+        }
+        catch (const std::exception& e)
+        {
+            result.error = e.what();
+            break;
+        }
+        result.times.push_back(timer.elapsed());
+    }
+    // the peak RSS during this benchmark. the process-wide maximum would
+    // include all previous benchmarks, so it is not reported.
+    if (measure_rss)
+        result.peak_rss = peak_rss();
+    return result;
+}
+
+std::string quoted(const std::string& s)
+{
+    std::string result = "\"";
+    for (char c : s)
+    {
+        if (c == '"' || c == '\\')
+            result += '\\';
+        if (static_cast<unsigned char>(c) >= 0x20)
+            result += c;
+    }
+    return result + "\"";
+}
+
+// least-squares slope of log(time) over log(n_vertices), i.e., the
+// exponent of the empirical complexity
+double scaling_exponent(const std::vector<const Result*>& curve)
+{
+    std::vector<double> x, y;
+    for (const auto* r : curve)
+    {
+        if (r->times.empty() || r->n_vertices == 0)
+            continue;
+        const double t = *std::min_element(r->times.begin(), r->times.end());
+        if (t <= 0)
+            continue;
+        x.push_back(std::log(double(r->n_vertices)));
+        y.push_back(std::log(t));
+    }
+    if (x.size() < 2)
+        return 0;
+
+    const double n = double(x.size());
+    const double mx = std::accumulate(x.begin(), x.end(), 0.0) / n;
+    const double my = std::accumulate(y.begin(), y.end(), 0.0) / n;
+    double sxy = 0, sxx = 0;
+    for (size_t i = 0; i < x.size(); ++i)
+    {
+        sxy += (x[i] - mx) * (y[i] - my);
+        sxx += (x[i] - mx) * (x[i] - mx);
+    }
+    return sxx > 0 ? sxy / sxx : 0;
+}
+
+void write_json(std::ostream& out, const std::vector<Result>& results,
+                unsigned int repetitions)
+{
+    out << "{\n";
+    out << "  \"version\": " << quoted(PMP_BENCHMARK_VERSION) << ",\n";
+    out << "  \"build_type\": " << quoted(PMP_BENCHMARK_BUILD_TYPE) << ",\n";
+    out << "  \"scalar_bits\": " << 8 * sizeof(Scalar) << ",\n";
+    out << "  \"index_bits\": " << 8 * sizeof(IndexType) << ",\n";
+#ifdef _OPENMP
+    out << "  \"openmp\": true,\n";
+#else
+    out << "  \"openmp\": false,\n";
+#endif
+    out << "  \"repetitions\": " << repetitions << ",\n";
+
+    out << "  \"results\": [";
+    for (size_t i = 0; i < results.size(); ++i)
+    {
+        const auto& r = results[i];
+        out << (i ? ",\n" : "\n") << "    {\"benchmark\": "
+            << quoted(r.benchmark) << ", \"shape\": " << quoted(r.shape)
+            << ", \"level\": " << r.level << ", \"vertices\": " << r.n_vertices
+            << ", \"faces\": " << r.n_faces;
+        if (!r.error.empty())
+        {
+            out << ", \"error\": " << quoted(r.error) << "}";
+            continue;
+        }
+        const double min =
+            *std::min_element(r.times.begin(), r.times.end());
+        const double mean =
+            std::accumulate(r.times.begin(), r.times.end(), 0.0) /
+            double(r.times.size());
+        const double throughput =
+            min > 0 ? 1000.0 * double(r.n_vertices) / min : 0.0;
+        out << ", \"min_ms\": " << min << ", \"mean_ms\": " << mean
+            << ", \"vertices_per_second\": " << throughput;
+        if (r.peak_rss)
+            out << ", \"peak_rss\": " << r.peak_rss;
+        out << "}";
+    }
+    out << "\n  ],\n";
+
+    // scaling curves: results of each benchmark and shape over all levels
+    out << "  \"scaling\": [";
+    bool first = true;
+    for (size_t i = 0; i < results.size(); ++i)
+    {
+        const auto& r = results[i];
+        if (i > 0 && results[i - 1].benchmark == r.benchmark &&
+            results[i - 1].shape == r.shape)
+            continue;
+
+        std::vector<const Result*> curve;
+        for (size_t j = i; j < results.size() &&
+                           results[j].benchmark == r.benchmark &&
+                           results[j].shape == r.shape;
+             ++j)
+            if (results[j].error.empty())
+                curve.push_back(&results[j]);
+        if (curve.empty())
+            continue;
+
+        out << (first ? "\n" : ",\n") << "    {\"benchmark\": "
+            << quoted(r.benchmark) << ", \"shape\": " << quoted(r.shape)
+            << ", \"exponent\": " << scaling_exponent(curve)
+            << ", \"points\": [";
+        for (size_t j = 0; j < curve.size(); ++j)
+            out << (j ? ", " : "") << "[" << curve[j]->n_vertices << ", "
+                << *std::min_element(curve[j]->times.begin(),
+                                     curve[j]->times.end())
+                << "]";
+        out << "]}";
+        first = false;
+    }
+    out << "\n  ]\n}\n";
+}
+
+void usage_and_exit()
+{
+    std::cerr
+        << "Usage:\nbenchmark [-l <min_level>] [-L <max_level>] "
+           "[-r <repetitions>] [-f <filter>] [-o <output>]\n\nOptions\n"
+        << " -l:  smallest resolution level, default 2\n"
+        << " -L:  largest resolution level, default 5\n"
+        << "      (shapes have approx. 10 * 4^level vertices)\n"
+        << " -r:  number of runs per benchmark, default 3\n"
+        << " -f:  only run benchmarks whose name contains <filter>\n"
+        << " -o:  write JSON to <output> instead of stdout\n"
+        << "\n";
+    exit(1);
+}
+
+} // namespace
+
+int main(int argc, char** argv)
+{
+    size_t min_level = 2;
+    size_t max_level = 5;
+    unsigned int repetitions = 3;
+    std::string filter;
+    std::string output;
+
+    // parse command line parameters
+    for (int i = 1; i < argc; ++i)
+    {
+        const std::string arg = argv[i];
+        if (i + 1 == argc)
+            usage_and_exit();
+        const std::string value = argv[++i];
+
+        try
+        {
+            if (arg == "-l")
+                min_level = std::stoul(value);
+            else if (arg == "-L")
+                max_level = std::stoul(value);
+            else if (arg == "-r")
+                repetitions = static_cast<unsigned int>(std::stoul(value));
+            else if (arg == "-f")
+                filter = value;
+            else if (arg == "-o")
+                output = value;
+            else
+                usage_and_exit();
+        }
+        catch (const std::logic_error&)
+        {
+            usage_and_exit();
+        }
+    }
+    if (min_level > max_level || max_level > 8 || repetitions == 0)
+        usage_and_exit();
+
+    // directory for the files of the reader and writer benchmarks
+    const auto tmp = std::filesystem::temp_directory_path() / "pmp_benchmark";
+    std::filesystem::create_directories(tmp);
+
+    std::vector<Result> results;
+    for (const auto& b : benchmarks(tmp))
+    {
+        if (b.name.find(filter) == std::string::npos)
+            continue;
+
+        for (const auto& s : shapes())
+        {
+            if ((b.requirements & s.properties) != b.requirements)
+                continue;
+
+            for (size_t level = min_level; level <= max_level; ++level)
+            {
+                std::cerr << b.name << " " << s.name << " " << level
+                          << std::endl;
+                results.push_back(run(b, s, level, repetitions));
+            }
+        }
+    }
+
+    std::filesystem::remove_all(tmp);
+
+    if (output.empty())
+    {
+        write_json(std::cout, results, repetitions);
+    }
+    else
+    {
+        std::ofstream ofs(output);
+        if (!ofs)
+        {
+            std::cerr << "Failed to open " << output << std::endl;
+            return 1;
+        }
+        write_json(ofs, results, repetitions);
+    }
+    return 0;
+}
@@ -51,12 +51,16 @@ void MeshProcessingViewer::keyboard(int key, int scancode, int action, int mods)
     {
         case GLFW_KEY_A:
         {
+            if (!check_idle())
+                break;
             detect_features(mesh_, 25);
             update_mesh();
             break;
         }
         case GLFW_KEY_D: // dualize mesh
         {
+            if (!check_idle())
+                break;
             dual(mesh_);
             update_mesh();
             break;
@@ -68,6 +72,8 @@ void MeshProcessingViewer::keyboard(int key, int scancode, int action, int mods)
         }
         case GLFW_KEY_O: // change face orientation
         {
+            if (!check_idle())
+                break;
 #ifdef __EMSCRIPTEN__
             // [fileHandle] = await window.showOpenFilePicker();
             instance = this;
@@ -82,6 +88,8 @@ void MeshProcessingViewer::keyboard(int key, int scancode, int action, int mods)
         }
         case GLFW_KEY_M: // merge two faces incident to longest edge
         {
+            if (!check_idle())
+                break;
             Scalar l, ll(0);
             Edge ee;
             for (auto e : mesh_.edges())
@@ -108,6 +116,8 @@ void MeshProcessingViewer::keyboard(int key, int scancode, int action, int mods)
         }
         case GLFW_KEY_T:
         {
+            if (!check_idle())
+                break;
             triangulate(mesh_);
             update_mesh();
             break;
@@ -122,6 +132,9 @@ void MeshProcessingViewer::keyboard(int key, int scancode, int action, int mods)
         case GLFW_KEY_8:
         case GLFW_KEY_9:
         {
+            if (!check_idle())
+                break;
+
             switch (key)
             {
                 case GLFW_KEY_1:
@@ -171,6 +184,9 @@ void MeshProcessingViewer::process_imgui()
 {
     MeshViewer::process_imgui();
 
+    // the mesh must not change while a background job works on a copy
+    ImGui::BeginDisabled(jobs_.is_busy());
+
     ImGui::Spacing();
     ImGui::Spacing();
 
@@ -230,16 +246,11 @@ void MeshProcessingViewer::process_imgui()
         if (ImGui::Button("Implicit Smoothing"))
         {
             Scalar dt = timestep * radius_ * radius_;
-            try
-            {
-                implicit_smoothing(mesh_, dt);
-            }
-            catch (const SolverException& e)
-            {
-                std::cerr << e.what() << std::endl;
-                return;
-            }
-            update_mesh();
+            run_job("Implicit Smoothing",
+                    [dt](SurfaceMesh& mesh, Progress& progress) {
+                        implicit_smoothing(mesh, dt, 1, false, true,
+                                           &progress);
+                    });
         }
     }
 
@@ -270,18 +281,12 @@ void MeshProcessingViewer::process_imgui()
 
         if (ImGui::Button("Decimate"))
         {
-            try
-            {
-                auto nv = mesh_.n_vertices() * 0.01 * target_percentage;
-                decimate(mesh_, nv, aspect_ratio, 0.0, 0.0, normal_deviation,
-                         0.0, 0.01, seam_angle_deviation);
-            }
-            catch (const InvalidInputException& e)
-            {
-                std::cerr << e.what() << std::endl;
-                return;
-            }
-            update_mesh();
+            auto nv = mesh_.n_vertices() * 0.01 * target_percentage;
+            run_job("Decimation", [=](SurfaceMesh& mesh, Progress& progress) {
+                decimate(mesh, nv, aspect_ratio, 0.0, 0.0, normal_deviation,
+                         0.0, 0.01, seam_angle_deviation, 0, 0.0, false,
+                         &progress);
+            });
         }
     }
 
@@ -295,13 +300,12 @@ void MeshProcessingViewer::process_imgui()
             try
             {
                 loop_subdivision(mesh_);
+                update_mesh();
             }
             catch (const InvalidInputException& e)
             {
                 std::cerr << e.what() << std::endl;
-                return;
             }
-            update_mesh();
         }
 
         if (ImGui::Button("Quad-Tri Subdivision"))
@@ -325,35 +329,23 @@ void MeshProcessingViewer::process_imgui()
         if (ImGui::Button("Adaptive Remeshing"))
         {
             auto bb = bounds(mesh_).size();
-
-            try
-            {
-                adaptive_remeshing(mesh_,
-                                   0.001 * bb,  // min length
-                                   1.0 * bb,    // max length
-                                   0.001 * bb); // approx. error
-            }
-            catch (const InvalidInputException& e)
-            {
-                std::cerr << e.what() << std::endl;
-                return;
-            }
-            update_mesh();
+            run_job("Adaptive Remeshing",
+                    [bb](SurfaceMesh& mesh, Progress& progress) {
+                        adaptive_remeshing(mesh,
+                                           0.001 * bb, // min length
+                                           1.0 * bb,   // max length
+                                           0.001 * bb, // approx. error
+                                           10, true, &progress);
+                    });
         }
 
         if (ImGui::Button("Uniform Remeshing"))
         {
             auto l = mean_edge_length(mesh_);
-            try
-            {
-                uniform_remeshing(mesh_, l);
-            }
-            catch (const InvalidInputException& e)
-            {
-                std::cerr << e.what() << std::endl;
-                return;
-            }
-            update_mesh();
+            run_job("Uniform Remeshing",
+                    [l](SurfaceMesh& mesh, Progress& progress) {
+                        uniform_remeshing(mesh, l, 10, true, &progress);
+                    });
         }
     }
 
@@ -398,13 +390,12 @@ void MeshProcessingViewer::process_imgui()
                 try
                 {
                     fill_hole(mesh_, hmin);
+                    update_mesh();
                 }
                 catch (const InvalidInputException& e)
                 {
                     std::cerr << e.what() << std::endl;
-                    return;
                 }
-                update_mesh();
             }
             else
             {
@@ -412,6 +403,8 @@ void MeshProcessingViewer::process_imgui()
             }
         }
     }
+
+    ImGui::EndDisabled();
 }
 
 void MeshProcessingViewer::mouse(int button, int action, int mods)
@@ -419,6 +412,9 @@ void MeshProcessingViewer::mouse(int button, int action, int mods)
     if (action == GLFW_PRESS && button == GLFW_MOUSE_BUTTON_RIGHT &&
         shift_pressed())
     {
+        if (!check_idle())
+            return;
+
         double x, y;
         cursor_pos(x, y);
         Vertex v = pick_vertex(x, y);
@@ -0,0 +1,260 @@
+// Copyright 2023 the Polygon Mesh Processing Library developers.
+// Distributed under a MIT-style license, see LICENSE.txt for details.
+
+#include "pmp/algorithms/clustering.h"
+#include "pmp/algorithms/utilities.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <numeric>
+
+#include <Eigen/Dense>
+
+namespace pmp {
+namespace {
+
+// symmetric 4x4 matrix, upper triangle stored row by row
+using Quadric = std::array<double, 10>;
+
+// add the quadric p p^T of the plane p
+void add_plane(Quadric& q, const dvec4& p)
+{
+    size_t k = 0;
+    for (int i = 0; i < 4; ++i)
+        for (int j = i; j < 4; ++j)
+            q[k++] += p[i] * p[j];
+}
+
+// Minimize the quadric using a truncated pseudo-inverse. Directions that
+// are not constrained by the quadric, e.g., tangential directions in flat
+// regions, keep the coordinates of the centroid c.
+dvec3 minimize(const Quadric& q, const dvec3& c)
+{
+    Eigen::Matrix3d A;
+    A << q[0], q[1], q[2], q[1], q[4], q[5], q[2], q[5], q[7];
+    const Eigen::Vector3d b(q[3], q[6], q[8]);
+    const Eigen::Vector3d x0(c[0], c[1], c[2]);
+
+    Eigen::SelfAdjointEigenSolver<Eigen::Matrix3d> solver;
+    solver.computeDirect(A);
+    const auto& lambda = solver.eigenvalues();
+    const double threshold = 1e-3 * lambda[2];
+
+    const Eigen::Vector3d r = -b - A * x0;
+    Eigen::Vector3d x = x0;
+    for (int i = 0; i < 3; ++i)
+    {
+        if (lambda[i] > 0 && lambda[i] > threshold)
+        {
+            const auto u = solver.eigenvectors().col(i);
+            x += u * (u.dot(r) / lambda[i]);
+        }
+    }
+    return dvec3(x[0], x[1], x[2]);
+}
+
+// plane of face f, scaled by the square root of its area
+dvec4 weighted_plane(const SurfaceMesh& mesh, Face f)
+{
+    // Newell's method for general polygons
+    dvec3 n(0, 0, 0), c(0, 0, 0);
+    size_t valence = 0;
+    for (auto h : mesh.halfedges(f))
+    {
+        const dvec3 p0(mesh.position(mesh.from_vertex(h)));
+        const dvec3 p1(mesh.position(mesh.to_vertex(h)));
+        n += cross(p0, p1);
+        c += p0;
+        ++valence;
+    }
+    c /= double(valence);
+
+    const double l = norm(n);
+    if (l == 0)
+        return dvec4(0, 0, 0, 0);
+    n /= l;
+
+    // the length of n is twice the area of the face
+    const double w = std::sqrt(0.5 * l);
+    return dvec4(w * n, -w * dot(n, c));
+}
+
+// rotate the triangle such that its smallest index comes first
+std::array<IndexType, 3> canonical(IndexType a, IndexType b, IndexType c)
+{
+    if (a < b && a < c)
+        return {a, b, c};
+    if (b < c)
+        return {b, c, a};
+    return {c, a, b};
+}
+
+} // namespace
+
+TriangleSoup vertex_clustering_soup(const SurfaceMesh& mesh,
+                                    unsigned int resolution)
+{
+    if (resolution == 0 || resolution > (1u << 21))
+        throw InvalidInputException("vertex_clustering: Invalid resolution.");
+
+    TriangleSoup soup;
+    if (mesh.n_vertices() == 0)
+        return soup;
+
+    // uniform grid of cubic cells
+    auto bb = bounds(mesh);
+    const dvec3 origin(bb.min());
+    const dvec3 extent(bb.max() - bb.min());
+    const double size = std::max(extent[0], std::max(extent[1], extent[2]));
+    const double cell_size = size > 0 ? size / resolution : 1.0;
+    const uint64_t n = resolution;
+
+    // cell of each vertex
+    const size_t nv = mesh.vertices_size();
+    std::vector<uint64_t> cell(nv);
+#ifdef _OPENMP
+#pragma omp parallel for
+#endif
+    for (size_t i = 0; i < nv; ++i)
+    {
+        const dvec3 p = (dvec3(mesh.position(Vertex(i))) - origin) / cell_size;
+        uint64_t key = 0;
+        for (int j = 0; j < 3; ++j)
+            key = key * n + std::min(uint64_t(std::max(p[j], 0.0)), n - 1);
+        cell[i] = key;
+    }
+
+    // sort vertices by cell, each range of equal cells forms a cluster
+    std::vector<IndexType> order;
+    order.reserve(mesh.n_vertices());
+    for (auto v : mesh.vertices())
+        order.push_back(v.idx());
+    std::stable_sort(order.begin(), order.end(), [&](IndexType a, IndexType b) {
+        return cell[a] < cell[b];
+    });
+
+    std::vector<size_t> start;
+    std::vector<IndexType> cluster(nv, PMP_MAX_INDEX);
+    for (size_t i = 0; i < order.size(); ++i)
+    {
+        if (i == 0 || cell[order[i]] != cell[order[i - 1]])
+            start.push_back(i);
+        cluster[order[i]] = static_cast<IndexType>(start.size() - 1);
+    }
+    start.push_back(order.size());
+    const size_t nc = start.size() - 1;
+
+    // one pass over all faces to compute their planes
+    const size_t nf = mesh.faces_size();
+    std::vector<dvec4> planes(nf);
+#ifdef _OPENMP
+#pragma omp parallel for
+#endif
+    for (size_t i = 0; i < nf; ++i)
+        if (!mesh.is_deleted(Face(i)))
+            planes[i] = weighted_plane(mesh, Face(i));
+
+    // accumulate quadrics and place a representative vertex in each cell
+    soup.positions.resize(nc);
+#ifdef _OPENMP
+#pragma omp parallel for
+#endif
+    for (size_t c = 0; c < nc; ++c)
+    {
+        Quadric q{};
+        dvec3 centroid(0, 0, 0);
+        for (size_t k = start[c]; k < start[c + 1]; ++k)
+        {
+            const Vertex v(order[k]);
+            centroid += dvec3(mesh.position(v));
+            for (auto f : mesh.faces(v))
+                add_plane(q, planes[f.idx()]);
+        }
+        centroid /= double(start[c + 1] - start[c]);
+
+        // keep the representative inside its cell
+        dvec3 p = minimize(q, centroid);
+        const uint64_t key = cell[order[start[c]]];
+        const dvec3 lower =
+            origin + cell_size * dvec3(double(key / (n * n)),
+                                       double(key / n % n), double(key % n));
+        for (int j = 0; j < 3; ++j)
+            p[j] = std::clamp(p[j], lower[j], lower[j] + cell_size);
+        soup.positions[c] = Point(p);
+    }
+
+    // triangle fans of all faces, in the order of the faces
+    std::vector<size_t> offsets(nf + 1, 0);
+    for (auto f : mesh.faces())
+        offsets[f.idx() + 1] = mesh.valence(f) - 2;
+    std::partial_sum(offsets.begin(), offsets.end(), offsets.begin());
+
+    const std::array<IndexType, 3> degenerate{PMP_MAX_INDEX, PMP_MAX_INDEX,
+                                              PMP_MAX_INDEX};
+    auto& triangles = soup.triangles;
+    triangles.resize(offsets.back());
+#ifdef _OPENMP
+#pragma omp parallel for
+#endif
+    for (size_t i = 0; i < nf; ++i)
+    {
+        const Face f(i);
+        if (mesh.is_deleted(f))
+            continue;
+
+        const Halfedge h0 = mesh.halfedge(f);
+        const Vertex v0 = mesh.from_vertex(h0);
+        const IndexType c0 = cluster[v0.idx()];
+        size_t k = offsets[i];
+        for (auto h = mesh.next_halfedge(h0); mesh.to_vertex(h) != v0;
+             h = mesh.next_halfedge(h))
+        {
+            const IndexType c1 = cluster[mesh.from_vertex(h).idx()];
+            const IndexType c2 = cluster[mesh.to_vertex(h).idx()];
+            if (c0 == c1 || c1 == c2 || c2 == c0)
+                triangles[k++] = degenerate;
+            else
+                triangles[k++] = canonical(c0, c1, c2);
+        }
+    }
+
+    // remove degenerate and duplicate triangles
+    triangles.erase(std::remove(triangles.begin(), triangles.end(), degenerate),
+                    triangles.end());
+    std::sort(triangles.begin(), triangles.end());
+    triangles.erase(std::unique(triangles.begin(), triangles.end()),
+                    triangles.end());
+
+    return soup;
+}
+
+void vertex_clustering(SurfaceMesh& mesh, unsigned int resolution)
+{
+    const auto soup = vertex_clustering_soup(mesh, resolution);
+
+    mesh.clear();
+    std::vector<Vertex> vertices(soup.positions.size());
+    for (const auto& t : soup.triangles)
+    {
+        for (auto i : t)
+            if (!vertices[i].is_valid())
+                vertices[i] = mesh.add_vertex(soup.positions[i]);
+
+        try
+        {
+            mesh.add_triangle(vertices[t[0]], vertices[t[1]], vertices[t[2]]);
+        }
+        catch (const TopologyException&)
+        {
+            // skip non-manifold triangles
+        }
+    }
+
+    // remove vertices of skipped triangles
+    for (auto v : mesh.vertices())
+        if (mesh.is_isolated(v))
+            mesh.delete_vertex(v);
+    mesh.garbage_collection();
+}
+
+} // namespace pmp
@@ -0,0 +1,52 @@
+// Copyright 2023 the Polygon Mesh Processing Library developers.
+// Distributed under a MIT-style license, see LICENSE.txt for details.
+
+#pragma once
+
+#include <array>
+#include <vector>
+
+#include "pmp/surface_mesh.h"
+
+namespace pmp {
+
+//! \brief An indexed triangle soup.
+//! \details Unlike SurfaceMesh, a triangle soup can represent arbitrary,
+//! including non-manifold, configurations.
+//! \ingroup algorithms
+struct TriangleSoup
+{
+    std::vector<Point> positions;                     //!< vertex positions
+    std::vector<std::array<IndexType, 3>> triangles; //!< vertex indices
+};
+
+//! \brief Simplify a mesh by vertex clustering.
+//! \details Vertices are clustered in a uniform grid of \p resolution cells
+//! along the longest side of the bounding box. Each cluster is replaced by
+//! the point minimizing the sum of its quadric error metrics, and triangles
+//! collapsing to edges or points are removed. This is much faster but less
+//! accurate than decimate(), and therefore well-suited for preview levels of
+//! detail of large meshes. See \cite lindstrom_2000_out for details.
+//! \details Triangles that would create non-manifold configurations are
+//! skipped. Use vertex_clustering_soup() to keep them. Only vertex positions
+//! are preserved, all other properties are removed.
+//! \param mesh The input mesh, modified in place.
+//! \param resolution The number of grid cells along the longest side of the
+//! bounding box.
+//! \note Polygonal faces are triangulated.
+//! \throw InvalidInputException if \p resolution is zero or larger than
+//! 2^21.
+//! \ingroup algorithms
+void vertex_clustering(SurfaceMesh& mesh, unsigned int resolution);
+
+//! \brief Simplify a mesh by vertex clustering into a triangle soup.
+//! \details Same as vertex_clustering(), but all triangles that do not
+//! degenerate are returned, including duplicate triangles of opposite
+//! orientation and triangles with non-manifold edges or vertices.
+//! \throw InvalidInputException if \p resolution is zero or larger than
+//! 2^21.
+//! \ingroup algorithms
+TriangleSoup vertex_clustering_soup(const SurfaceMesh& mesh,
+                                    unsigned int resolution);
+
+} // namespace pmp
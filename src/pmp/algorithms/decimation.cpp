@@ -3,11 +3,17 @@
 
 #include "pmp/algorithms/decimation.h"
 
-#include <iterator>
+#include <algorithm>
+#include <array>
 #include <limits>
 
+#include <Eigen/Dense>
+
 #include "pmp/algorithms/distance_point_triangle.h"
+#include "pmp/algorithms/normal_cone.h"
 #include "pmp/algorithms/normals.h"
+#include "pmp/algorithms/utilities.h"
+#include "pmp/trace.h"
 
 namespace pmp {
 namespace {
@@ -278,65 +284,133 @@ private:
         j_;
 }; // clang-format on
 
-class NormalCone
+// position followed by up to eight vertex attributes
+using AttributeVector = Eigen::Matrix<double, Eigen::Dynamic, 1, 0, 11, 1>;
+using AttributeMatrix =
+    Eigen::Matrix<double, Eigen::Dynamic, Eigen::Dynamic, 0, 11, 11>;
+
+// Generalized quadrics on positions and vertex attributes, see
+// \cite garland_1998_simplifying. Each quadric Q(x) = x^T A x + 2 b^T x + c
+// is stored as the upper triangle of A followed by b and c, and all
+// quadrics share one flat buffer.
+class AttributeQuadrics
 {
 public:
-    NormalCone() = default;
-
-    // Initialize cone with center (unit vector) and angle (radius in radians)
-    NormalCone(const Normal& normal, Scalar angle = 0.0)
-        : center_normal_(normal), angle_(angle)
+    // allocate n zero quadrics of dimension dim
+    void init(size_t n, Eigen::Index dim)
     {
+        dim_ = dim;
+        stride_ = dim * (dim + 1) / 2 + dim + 1;
+        data_.assign(n * stride_, 0.0);
     }
 
-    // returns center normal
-    const Normal& center_normal() const { return center_normal_; }
+    void clear() { data_.clear(); }
 
-    // returns size of cone (radius in radians)
-    Scalar angle() const { return angle_; }
+    Eigen::Index dim() const { return dim_; }
 
-    // merge *this with n.
-    NormalCone& merge(const Normal& n) { return merge(NormalCone(n)); }
+    // add the quadric of the triangle (x0, x1, x2) to quadric i
+    void add_triangle(size_t i, const AttributeVector& x0,
+                      const AttributeVector& x1, const AttributeVector& x2)
+    {
+        // orthonormal basis of the triangle's plane
+        AttributeVector e1 = x1 - x0;
+        const double l1 = e1.norm();
+        if (l1 < std::numeric_limits<double>::min())
+            return;
+        e1 /= l1;
+        AttributeVector e2 = x2 - x0;
+        e2 -= e1.dot(e2) * e1;
+        const double l2 = e2.norm();
+        if (l2 < std::numeric_limits<double>::min())
+            return;
+        e2 /= l2;
+
+        // A = I - e1 e1^T - e2 e2^T
+        double* q = &data_[i * stride_];
+        for (Eigen::Index r = 0; r < dim_; ++r)
+            for (Eigen::Index c = r; c < dim_; ++c)
+                *q++ += (r == c ? 1.0 : 0.0) - e1[r] * e1[c] - e2[r] * e2[c];
+
+        // b = (x0.e1) e1 + (x0.e2) e2 - x0
+        const double d1 = x0.dot(e1);
+        const double d2 = x0.dot(e2);
+        for (Eigen::Index r = 0; r < dim_; ++r)
+            *q++ += d1 * e1[r] + d2 * e2[r] - x0[r];
+
+        // c = x0.x0 - (x0.e1)^2 - (x0.e2)^2
+        *q += x0.dot(x0) - d1 * d1 - d2 * d2;
+    }
 
-    // merge *this with nc. *this will then enclose both cones.
-    NormalCone& merge(const NormalCone& nc)
+    // add quadric j to quadric i
+    void add(size_t i, size_t j)
     {
-        const Scalar dp = dot(center_normal_, nc.center_normal_);
+        for (size_t k = 0; k < stride_; ++k)
+            data_[i * stride_ + k] += data_[j * stride_ + k];
+    }
 
-        // axes point in same direction
-        if (dp > 0.99999)
-        {
-            angle_ = std::max(angle_, nc.angle_);
-        }
+    // unpack the sum of quadrics i and j
+    void sum(size_t i, size_t j, AttributeMatrix& A, AttributeVector& b,
+             double& c) const
+    {
+        const double* qi = &data_[i * stride_];
+        const double* qj = &data_[j * stride_];
+        A.resize(dim_, dim_);
+        b.resize(dim_);
+        for (Eigen::Index r = 0; r < dim_; ++r)
+            for (Eigen::Index k = r; k < dim_; ++k)
+                A(r, k) = A(k, r) = *qi++ + *qj++;
+        for (Eigen::Index r = 0; r < dim_; ++r)
+            b[r] = *qi++ + *qj++;
+        c = *qi + *qj;
+    }
 
-        // axes point in opposite directions
-        else if (dp < -0.99999)
-        {
-            angle_ = Scalar(2 * M_PI);
-        }
+private:
+    Eigen::Index dim_{0};
+    size_t stride_{0};
+    std::vector<double> data_;
+};
 
-        else
-        {
-            // new angle
-            Scalar center_angle = std::acos(dp);
-            Scalar min_angle = std::min(-angle_, center_angle - nc.angle_);
-            Scalar max_angle = std::max(angle_, center_angle + nc.angle_);
-            angle_ = Scalar(0.5) * (max_angle - min_angle);
-
-            // axis by SLERP
-            Scalar axis_angle = Scalar(0.5) * (min_angle + max_angle);
-            center_normal_ =
-                ((center_normal_ * std::sin(center_angle - axis_angle) +
-                  nc.center_normal_ * std::sin(axis_angle)) /
-                 std::sin(center_angle));
-        }
+// Points assigned to faces for bounding the Hausdorff error. All points are
+// stored in one flat buffer, and the points of each face form a singly
+// linked list through this buffer. Moving points between faces therefore
+// only relinks indices and never allocates.
+class PointLists
+{
+public:
+    // marks the end of a list
+    static constexpr IndexType end = PMP_MAX_INDEX;
 
-        return *this;
+    // remove all points
+    void clear()
+    {
+        points_.clear();
+        next_.clear();
+    }
+
+    // add point p as a single-element list, returns its index
+    IndexType add(const Point& p)
+    {
+        points_.push_back(p);
+        next_.push_back(end);
+        return static_cast<IndexType>(points_.size() - 1);
     }
 
+    // prepend point i to the list starting at head, returns the new head
+    IndexType link(IndexType head, IndexType i)
+    {
+        next_[i] = head;
+        return i;
+    }
+
+    // the point following point i in its list
+    IndexType next(IndexType i) const { return next_[i]; }
+
+    // the position of point i
+    const Point& point(IndexType i) const { return points_[i]; }
+
 private:
-    Normal center_normal_;
-    Scalar angle_;
+    std::vector<Point> points_;
+    std::vector<IndexType> next_;
 };
 
 class Decimation
@@ -347,8 +421,12 @@ public:
     void initialize(Scalar aspect_ratio = 0.0, Scalar edge_length = 0.0,
                     unsigned int max_valence = 0, Scalar normal_deviation = 0.0,
                     Scalar hausdorff_error = 0.0, Scalar seam_threshold = 1e-2,
-                    Scalar seam_angle_deviation = 1);
-    void decimate(unsigned int n_vertices);
+                    Scalar seam_angle_deviation = 1,
+                    bool attribute_quadrics = false);
+    void decimate(unsigned int n_vertices, unsigned int n_faces = 0,
+                  Scalar max_quadric_error = 0.0,
+                  std::vector<ProgressiveMesh::Collapse>* collapses = nullptr,
+                  Progress* progress = nullptr);
 
 private:
     // Store data for an halfedge collapse
@@ -402,7 +480,13 @@ private:
 
     using PriorityQueue = Heap<Vertex, HeapInterface>;
 
-    using Points = std::vector<Point>;
+    // target of a collapse when using attribute quadrics
+    struct Placement
+    {
+        Point position;
+        AttributeVector x; // scaled position and attributes
+        double error;
+    };
 
     // put the vertex v in the priority queue
     void enqueue_vertex(PriorityQueue& queue, Vertex v);
@@ -416,6 +500,18 @@ private:
     // what is the priority of collapsing the halfedge h
     float priority(const CollapseData& cd);
 
+    // geometric quadric error of a collapse, excluding attributes
+    double geometric_error(const CollapseData& cd);
+
+    // optimal placement of the remaining vertex for attribute quadrics
+    const Placement& placement(const CollapseData& cd);
+
+    // set up the attribute quadrics of all vertices
+    void init_attribute_quadrics();
+
+    // apply the attributes of a placement to vertex v
+    void set_attributes(Vertex v, const AttributeVector& x);
+
     // preprocess halfedge collapse
     void preprocess_collapse(const CollapseData& cd);
 
@@ -425,8 +521,11 @@ private:
     // compute aspect ratio for face f
     Scalar aspect_ratio(Face f) const;
 
-    // compute distance from point p to triangle f
-    Scalar distance(Face f, const Point& p) const;
+    // collect the triangles of the given faces
+    void collect_triangles(const std::vector<Face>& faces);
+
+    // index of the collected triangle closest to p and its distance
+    std::pair<size_t, Scalar> closest_triangle(const Point& p) const;
 
     SurfaceMesh& mesh_;
 
@@ -437,7 +536,7 @@ private:
     VertexProperty<int> heap_pos_;
     VertexProperty<Quadric> vquadric_;
     FaceProperty<NormalCone> normal_cone_;
-    FaceProperty<Points> face_points_;
+    FaceProperty<IndexType> face_points_;
 
     VertexProperty<Point> vpoint_;
     FaceProperty<Point> fnormal_;
@@ -455,6 +554,27 @@ private:
     Scalar seam_threshold_;
     Scalar seam_angle_deviation_;
     unsigned int max_valence_;
+
+    // attribute quadrics and optimal placement
+    bool attribute_quadrics_{false};
+    AttributeQuadrics aquadrics_;
+    Scalar attribute_scale_{1};
+    VertexProperty<Normal> vnormal_;
+    VertexProperty<Color> vcolor_;
+    HalfedgeProperty<TexCoord> htex_;
+    Halfedge placement_halfedge_;
+    Placement placement_;
+
+    // faces changed by a collapse
+    std::vector<Face> collapse_faces_;
+
+    // points for Hausdorff error control
+    PointLists point_lists_;
+
+    // scratch buffers for Hausdorff error control
+    std::vector<Face> ring_faces_;
+    std::vector<std::array<Point, 3>> ring_triangles_;
+    std::vector<IndexType> ring_points_;
 };
 
 Decimation::Decimation(SurfaceMesh& mesh) : mesh_(mesh)
@@ -495,8 +615,11 @@ Decimation::~Decimation()
 void Decimation::initialize(Scalar aspect_ratio, Scalar edge_length,
                             unsigned int max_valence, Scalar normal_deviation,
                             Scalar hausdorff_error, Scalar seam_threshold,
-                            Scalar seam_angle_deviation)
+                            Scalar seam_angle_deviation,
+                            bool attribute_quadrics)
 {
+    PMP_TRACE_SCOPE("initialize");
+
     // store parameters
     aspect_ratio_ = aspect_ratio;
     max_valence_ = max_valence;
@@ -505,6 +628,7 @@ void Decimation::initialize(Scalar aspect_ratio, Scalar edge_length,
     hausdorff_error_ = hausdorff_error;
     seam_threshold_ = seam_threshold;
     seam_angle_deviation_ = (180.0 - seam_angle_deviation) / 180.0;
+    attribute_quadrics_ = attribute_quadrics;
 
     // properties
     if (normal_deviation_ > 0.0)
@@ -512,7 +636,8 @@ void Decimation::initialize(Scalar aspect_ratio, Scalar edge_length,
     else
         mesh_.remove_face_property(normal_cone_);
     if (hausdorff_error > 0.0)
-        face_points_ = mesh_.face_property<Points>("f:points");
+        face_points_ =
+            mesh_.face_property<IndexType>("f:points", PointLists::end);
     else
         mesh_.remove_face_property(face_points_);
 
@@ -561,6 +686,11 @@ void Decimation::initialize(Scalar aspect_ratio, Scalar edge_length,
         }
     }
 
+    if (attribute_quadrics_)
+        init_attribute_quadrics();
+    else
+        aquadrics_.clear();
+
     // initialize normal cones
     if (normal_deviation_)
     {
@@ -573,9 +703,10 @@ void Decimation::initialize(Scalar aspect_ratio, Scalar edge_length,
     // initialize faces' point list
     if (hausdorff_error_)
     {
+        point_lists_.clear();
         for (auto f : mesh_.faces())
         {
-            Points().swap(face_points_[f]); // free mem
+            face_points_[f] = PointLists::end;
         }
     }
 
@@ -608,12 +739,20 @@ void Decimation::initialize(Scalar aspect_ratio, Scalar edge_length,
     initialized_ = true;
 }
 
-void Decimation::decimate(unsigned int n_vertices)
+void Decimation::decimate(unsigned int n_vertices, unsigned int n_faces,
+                          Scalar max_quadric_error,
+                          std::vector<ProgressiveMesh::Collapse>* collapses,
+                          Progress* progress)
 {
     // make sure the decimater is initialized
     if (!initialized_)
         initialize();
 
+    PMP_TRACE_SCOPE("collapse_loop");
+    size_t n_collapses = 0;
+    size_t n_heap_pops = 0;
+    size_t n_heap_updates = 0;
+
     std::vector<Vertex> one_ring;
 
     // add properties for priority queue
@@ -630,13 +769,37 @@ void Decimation::decimate(unsigned int n_vertices)
         queue.reset_heap_position(v);
         enqueue_vertex(queue, v);
     }
+    n_heap_updates += mesh_.n_vertices();
+
+    // fraction of the way from the initial to the target size
+    const auto nv0 = mesh_.n_vertices();
+    const auto nf0 = mesh_.n_faces();
+    auto done = [&](size_t nv) {
+        float f = nv0 > n_vertices ? float(nv0 - nv) / (nv0 - n_vertices) : 0;
+        if (nf0 > n_faces)
+            f = std::max(f, float(nf0 - mesh_.n_faces()) / (nf0 - n_faces));
+        return f;
+    };
 
+    bool canceled = false;
     auto nv = mesh_.n_vertices();
-    while (nv > n_vertices && !queue.empty())
+    while (nv > n_vertices && mesh_.n_faces() > n_faces && !queue.empty())
     {
+        if (progress && !progress->checkpoint(done(nv)))
+        {
+            canceled = true;
+            break;
+        }
+
+        // all remaining collapses exceed the error budget
+        if (max_quadric_error > 0 && !attribute_quadrics_ &&
+            vpriority_[queue.front()] > max_quadric_error)
+            break;
+
         // get 1st element
         auto v = queue.front();
         queue.pop_front();
+        ++n_heap_pops;
         auto h = vtarget_[v];
         CollapseData cd(mesh_, h);
 
@@ -644,6 +807,12 @@ void Decimation::decimate(unsigned int n_vertices)
         if (!mesh_.is_collapse_ok(h))
             continue;
 
+        // the priority also measures the attribute error, so check the
+        // geometric error of each collapse separately
+        if (max_quadric_error > 0 && attribute_quadrics_ &&
+            geometric_error(cd) > max_quadric_error)
+            continue;
+
         // are texture seams preserved?
         if (!texcoord_check(cd.v0v1))
             continue;
@@ -655,26 +824,50 @@ void Decimation::decimate(unsigned int n_vertices)
             one_ring.push_back(vv);
         }
 
+        // record collapse
+        if (collapses)
+            collapses->push_back({cd.v0.idx(), cd.v1.idx(), cd.vl.idx(),
+                                  cd.vr.idx()});
+
         // preprocessing -> adjust texcoords
         preprocess_collapse(cd);
 
         // perform collapse
         mesh_.collapse(h);
         --nv;
+        ++n_collapses;
 
         // postprocessing, e.g., update quadrics
         postprocess_collapse(cd);
 
+        // v1 was moved to the optimal placement -> all its neighbors
+        // (a superset of v0's former one-ring) need new priorities
+        if (attribute_quadrics_)
+        {
+            one_ring.clear();
+            one_ring.push_back(cd.v1);
+            for (auto vv : mesh_.vertices(cd.v1))
+                one_ring.push_back(vv);
+        }
+
         // update queue
         for (auto vv : one_ring)
             enqueue_vertex(queue, vv);
+        n_heap_updates += one_ring.size();
     }
 
+    PMP_TRACE_COUNT("collapses", n_collapses);
+    PMP_TRACE_COUNT("heap_pops", n_heap_pops);
+    PMP_TRACE_COUNT("heap_updates", n_heap_updates);
+
     // clean up
     mesh_.garbage_collection();
     mesh_.remove_vertex_property(vpriority_);
     mesh_.remove_vertex_property(heap_pos_);
     mesh_.remove_vertex_property(vtarget_);
+
+    if (canceled)
+        throw CanceledException("decimate: Canceled.");
 }
 
 void Decimation::enqueue_vertex(PriorityQueue& queue, Vertex v)
@@ -772,9 +965,21 @@ bool Decimation::is_collapse_legal(const CollapseData& cd)
             return false;
     }
 
-    // remember the positions of the endpoints
+    // remember the positions of the endpoints and the target position
     const Point p0 = vpoint_[cd.v0];
     const Point p1 = vpoint_[cd.v1];
+    const Point pt = attribute_quadrics_ ? placement(cd).position : p1;
+    const bool moves_v1 = pt != p1;
+
+    // faces remaining after the collapse whose geometry changes
+    collapse_faces_.clear();
+    for (auto f : mesh_.faces(cd.v0))
+        if (f != cd.fl && f != cd.fr)
+            collapse_faces_.push_back(f);
+    if (moves_v1)
+        for (auto f : mesh_.faces(cd.v1))
+            if (f != cd.fl && f != cd.fr)
+                collapse_faces_.push_back(f);
 
     // check for maximum edge length
     if (edge_length_)
@@ -783,7 +988,16 @@ bool Decimation::is_collapse_legal(const CollapseData& cd)
         {
             if (v != cd.v1 && v != cd.vl && v != cd.vr)
             {
-                if (norm(vpoint_[v] - p1) > edge_length_)
+                if (norm(vpoint_[v] - pt) > edge_length_)
+                    return false;
+            }
+        }
+
+        if (moves_v1)
+        {
+            for (auto v : mesh_.vertices(cd.v1))
+            {
+                if (v != cd.v0 && norm(vpoint_[v] - pt) > edge_length_)
                     return false;
             }
         }
@@ -792,27 +1006,26 @@ bool Decimation::is_collapse_legal(const CollapseData& cd)
     // check for flipping normals
     if (normal_deviation_ == 0.0)
     {
-        vpoint_[cd.v0] = p1;
-        for (auto f : mesh_.faces(cd.v0))
+        vpoint_[cd.v0] = vpoint_[cd.v1] = pt;
+        for (auto f : collapse_faces_)
         {
-            if (f != cd.fl && f != cd.fr)
+            Normal n0 = fnormal_[f];
+            Normal n1 = face_normal(mesh_, f);
+            if (dot(n0, n1) < 0.0)
             {
-                Normal n0 = fnormal_[f];
-                Normal n1 = face_normal(mesh_, f);
-                if (dot(n0, n1) < 0.0)
-                {
-                    vpoint_[cd.v0] = p0;
-                    return false;
-                }
+                vpoint_[cd.v0] = p0;
+                vpoint_[cd.v1] = p1;
+                return false;
             }
         }
         vpoint_[cd.v0] = p0;
+        vpoint_[cd.v1] = p1;
     }
 
     // check normal cone
     else
     {
-        vpoint_[cd.v0] = p1;
+        vpoint_[cd.v0] = vpoint_[cd.v1] = pt;
 
         Face fll, frr;
         if (cd.vl.is_valid())
@@ -822,27 +1035,26 @@ bool Decimation::is_collapse_legal(const CollapseData& cd)
             frr = mesh_.face(
                 mesh_.opposite_halfedge(mesh_.next_halfedge(cd.v1v0)));
 
-        for (auto f : mesh_.faces(cd.v0))
+        for (auto f : collapse_faces_)
         {
-            if (f != cd.fl && f != cd.fr)
-            {
-                NormalCone nc = normal_cone_[f];
-                nc.merge(face_normal(mesh_, f));
+            NormalCone nc = normal_cone_[f];
+            nc.merge(face_normal(mesh_, f));
 
-                if (f == fll)
-                    nc.merge(normal_cone_[cd.fl]);
-                if (f == frr)
-                    nc.merge(normal_cone_[cd.fr]);
+            if (f == fll)
+                nc.merge(normal_cone_[cd.fl]);
+            if (f == frr)
+                nc.merge(normal_cone_[cd.fr]);
 
-                if (nc.angle() > 0.5 * normal_deviation_)
-                {
-                    vpoint_[cd.v0] = p0;
-                    return false;
-                }
+            if (nc.angle() > 0.5 * normal_deviation_)
+            {
+                vpoint_[cd.v0] = p0;
+                vpoint_[cd.v1] = p1;
+                return false;
             }
         }
 
         vpoint_[cd.v0] = p0;
+        vpoint_[cd.v1] = p1;
     }
 
     // check aspect ratio
@@ -850,17 +1062,15 @@ bool Decimation::is_collapse_legal(const CollapseData& cd)
     {
         Scalar ar0(0), ar1(0);
 
-        for (auto f : mesh_.faces(cd.v0))
+        for (auto f : collapse_faces_)
         {
-            if (f != cd.fl && f != cd.fr)
-            {
-                // worst aspect ratio after collapse
-                vpoint_[cd.v0] = p1;
-                ar1 = std::max(ar1, aspect_ratio(f));
-                // worst aspect ratio before collapse
-                vpoint_[cd.v0] = p0;
-                ar0 = std::max(ar0, aspect_ratio(f));
-            }
+            // worst aspect ratio after collapse
+            vpoint_[cd.v0] = vpoint_[cd.v1] = pt;
+            ar1 = std::max(ar1, aspect_ratio(f));
+            // worst aspect ratio before collapse
+            vpoint_[cd.v0] = p0;
+            vpoint_[cd.v1] = p1;
+            ar0 = std::max(ar0, aspect_ratio(f));
         }
 
         // aspect ratio is too bad, and it does also not improve
@@ -871,42 +1081,34 @@ bool Decimation::is_collapse_legal(const CollapseData& cd)
     // check Hausdorff error
     if (hausdorff_error_)
     {
-        Points points;
-        bool ok;
-
-        // collect points to be tested
-        for (auto f : mesh_.faces(cd.v0))
-        {
-            std::copy(face_points_[f].begin(), face_points_[f].end(),
-                      std::back_inserter(points));
-        }
-        points.push_back(vpoint_[cd.v0]);
-
-        // test points against all faces
-        vpoint_[cd.v0] = p1;
-        for (auto point : points)
-        {
-            ok = false;
+        // triangles after the collapse
+        vpoint_[cd.v0] = vpoint_[cd.v1] = pt;
+        collect_triangles(collapse_faces_);
+        vpoint_[cd.v0] = p0;
+        vpoint_[cd.v1] = p1;
 
-            for (auto f : mesh_.faces(cd.v0))
+        // test the moved vertices and the points of their faces
+        if (closest_triangle(p0).second >= hausdorff_error_)
+            return false;
+        if (moves_v1 && closest_triangle(p1).second >= hausdorff_error_)
+            return false;
+        auto points_ok = [&](Face f) {
+            for (auto i = face_points_[f]; i != PointLists::end;
+                 i = point_lists_.next(i))
             {
-                if (f != cd.fl && f != cd.fr)
-                {
-                    if (distance(f, point) < hausdorff_error_)
-                    {
-                        ok = true;
-                        break;
-                    }
-                }
+                if (closest_triangle(point_lists_.point(i)).second >=
+                    hausdorff_error_)
+                    return false;
             }
-
-            if (!ok)
-            {
-                vpoint_[cd.v0] = p0;
+            return true;
+        };
+        for (auto f : mesh_.faces(cd.v0))
+            if (!points_ok(f))
                 return false;
-            }
-        }
-        vpoint_[cd.v0] = p0;
+        if (moves_v1)
+            for (auto f : mesh_.faces(cd.v1))
+                if (f != cd.fl && f != cd.fr && !points_ok(f))
+                    return false;
     }
 
     // collapse passed all tests -> ok
@@ -1002,15 +1204,182 @@ bool Decimation::texcoord_check(Halfedge h)
 }
 
 float Decimation::priority(const CollapseData& cd)
+{
+    if (attribute_quadrics_)
+        return static_cast<float>(placement(cd).error);
+
+    return static_cast<float>(geometric_error(cd));
+}
+
+double Decimation::geometric_error(const CollapseData& cd)
 {
     // computer quadric error metric
     Quadric Q = vquadric_[cd.v0];
     Q += vquadric_[cd.v1];
-    return Q(vpoint_[cd.v1]);
+    return Q(attribute_quadrics_ ? placement(cd).position : vpoint_[cd.v1]);
+}
+
+const Decimation::Placement& Decimation::placement(const CollapseData& cd)
+{
+    if (placement_halfedge_ == cd.v0v1)
+        return placement_;
+    placement_halfedge_ = cd.v0v1;
+
+    AttributeMatrix A;
+    AttributeVector b;
+    double c;
+    aquadrics_.sum(cd.v0.idx(), cd.v1.idx(), A, b, c);
+    auto& x = placement_.x;
+
+    const Point& p0 = vpoint_[cd.v0];
+    const Point& p1 = vpoint_[cd.v1];
+
+    // vertices on boundaries, features, or outside the selection stay fixed
+    bool movable = !mesh_.is_boundary(cd.v0) && !mesh_.is_boundary(cd.v1);
+    if (has_features_ && (vfeature_[cd.v0] || vfeature_[cd.v1]))
+        movable = false;
+    if (has_selection_ && !vselected_[cd.v1])
+        movable = false;
+
+    // minimize the quadric, but stay close to the edge
+    bool solved = false;
+    if (movable)
+    {
+        Eigen::LDLT<AttributeMatrix> ldlt(A);
+        if (ldlt.info() == Eigen::Success && ldlt.rcond() > 1e-10)
+        {
+            x = ldlt.solve(-b);
+            const Point p(x[0], x[1], x[2]);
+            solved = x.allFinite() &&
+                     norm(p - Scalar(0.5) * (p0 + p1)) <= norm(p1 - p0);
+        }
+    }
+
+    // otherwise keep the position of v1 and optimize the attributes only
+    if (!solved)
+    {
+        const auto m = A.rows() - 3;
+        x.resize(A.rows());
+        x.head(3) << p1[0], p1[1], p1[2];
+        if (m > 0)
+        {
+            Eigen::LDLT<AttributeMatrix> ldlt(A.bottomRightCorner(m, m));
+            x.tail(m) = ldlt.solve(
+                -(b.tail(m) + A.bottomLeftCorner(m, 3) * x.head(3)));
+        }
+    }
+
+    placement_.position = Point(x[0], x[1], x[2]);
+    placement_.error = std::max(0.0, x.dot(A * x) + 2.0 * b.dot(x) + c);
+    return placement_;
+}
+
+void Decimation::init_attribute_quadrics()
+{
+    vnormal_ = mesh_.get_vertex_property<Normal>("v:normal");
+    vcolor_ = mesh_.get_vertex_property<Color>("v:color");
+    htex_ = mesh_.get_halfedge_property<TexCoord>("h:tex");
+
+    Eigen::Index dim = 3;
+    if (vnormal_)
+        dim += 3;
+    if (vcolor_)
+        dim += 3;
+    if (htex_)
+        dim += 2;
+
+    // weight attributes as if the mesh was scaled to unit size
+    attribute_scale_ = bounds(mesh_).size();
+    if (attribute_scale_ <= 0)
+        attribute_scale_ = 1;
+
+    aquadrics_.init(mesh_.vertices_size(), dim);
+    placement_halfedge_ = Halfedge();
+
+    // position and attributes at the corner pointed to by h
+    auto corner = [&](Halfedge h) {
+        const Vertex v = mesh_.to_vertex(h);
+        AttributeVector x(dim);
+        Eigen::Index k = 0;
+        for (int i = 0; i < 3; ++i)
+            x[k++] = vpoint_[v][i];
+        if (vnormal_)
+            for (int i = 0; i < 3; ++i)
+                x[k++] = attribute_scale_ * vnormal_[v][i];
+        if (vcolor_)
+            for (int i = 0; i < 3; ++i)
+                x[k++] = attribute_scale_ * vcolor_[v][i];
+        if (htex_)
+            for (int i = 0; i < 2; ++i)
+                x[k++] = attribute_scale_ * htex_[h][i];
+        return x;
+    };
+
+    for (auto f : mesh_.faces())
+    {
+        const Halfedge h0 = mesh_.halfedge(f);
+        const Halfedge h1 = mesh_.next_halfedge(h0);
+        const Halfedge h2 = mesh_.next_halfedge(h1);
+        const AttributeVector x0 = corner(h0);
+        const AttributeVector x1 = corner(h1);
+        const AttributeVector x2 = corner(h2);
+        for (auto h : {h0, h1, h2})
+            aquadrics_.add_triangle(mesh_.to_vertex(h).idx(), x0, x1, x2);
+    }
+}
+
+void Decimation::set_attributes(Vertex v, const AttributeVector& x)
+{
+    Eigen::Index k = 3;
+
+    if (vnormal_)
+    {
+        const Normal n(x[k], x[k + 1], x[k + 2]);
+        if (norm(n) > 0)
+            vnormal_[v] = normalize(n);
+        k += 3;
+    }
+
+    if (vcolor_)
+    {
+        for (int i = 0; i < 3; ++i)
+            vcolor_[v][i] = std::clamp(Scalar(x[k + i] / attribute_scale_),
+                                       Scalar(0), Scalar(1));
+        k += 3;
+    }
+
+    if (htex_)
+    {
+        const TexCoord t(x[k] / attribute_scale_, x[k + 1] / attribute_scale_);
+
+        // texture coordinates on seams are kept
+        Halfedge first;
+        for (auto h : mesh_.halfedges(v))
+        {
+            const Halfedge in = mesh_.opposite_halfedge(h);
+            if (mesh_.is_boundary(in))
+                continue;
+            if (!first.is_valid())
+                first = in;
+            else if (norm(htex_[in] - htex_[first]) > seam_threshold_)
+                return;
+        }
+
+        for (auto h : mesh_.halfedges(v))
+        {
+            const Halfedge in = mesh_.opposite_halfedge(h);
+            if (!mesh_.is_boundary(in))
+                htex_[in] = t;
+        }
+    }
 }
 
 void Decimation::preprocess_collapse(const CollapseData& cd)
 {
+    // target of the collapse, used in postprocess_collapse()
+    if (attribute_quadrics_)
+        placement(cd);
+
     Halfedge h = cd.v0v1;
     Halfedge o = mesh_.opposite_halfedge(h);
     Halfedge v1v2, v2v1, v0v2;
@@ -1064,7 +1433,17 @@ void Decimation::preprocess_collapse(const CollapseData& cd)
 
 void Decimation::postprocess_collapse(const CollapseData& cd)
 {
+    // position of v1 before the collapse
+    const Point p1 = vpoint_[cd.v1];
+
     // update error quadrics
+    if (attribute_quadrics_)
+    {
+        aquadrics_.add(cd.v1.idx(), cd.v0.idx());
+        vpoint_[cd.v1] = placement_.position;
+        set_attributes(cd.v1, placement_.x);
+        placement_halfedge_ = Halfedge();
+    }
     vquadric_[cd.v1] += vquadric_[cd.v0];
 
     // update normal cones
@@ -1093,54 +1472,42 @@ void Decimation::postprocess_collapse(const CollapseData& cd)
     // update Hausdorff error
     if (hausdorff_error_)
     {
-        Points points;
-
         // collect points to be distributed
+        ring_points_.clear();
+        auto unlink_points = [&](Face f) {
+            for (auto i = face_points_[f]; i != PointLists::end;
+                 i = point_lists_.next(i))
+                ring_points_.push_back(i);
+            face_points_[f] = PointLists::end;
+        };
 
         // points of v1's one-ring
         for (auto f : mesh_.faces(cd.v1))
-        {
-            std::copy(face_points_[f].begin(), face_points_[f].end(),
-                      std::back_inserter(points));
-            face_points_[f].clear();
-        }
+            unlink_points(f);
 
         // points of the 2 removed triangles
         if (cd.fl.is_valid())
-        {
-            std::copy(face_points_[cd.fl].begin(), face_points_[cd.fl].end(),
-                      std::back_inserter(points));
-            Points().swap(face_points_[cd.fl]); // free mem
-        }
+            unlink_points(cd.fl);
         if (cd.fr.is_valid())
-        {
-            std::copy(face_points_[cd.fr].begin(), face_points_[cd.fr].end(),
-                      std::back_inserter(points));
-            Points().swap(face_points_[cd.fr]); // free mem
-        }
-
-        // the removed vertex
-        points.push_back(vpoint_[cd.v0]);
+            unlink_points(cd.fr);
 
-        // test points against all faces
-        Scalar d, dd;
-        Face ff;
+        // the removed vertex and the former position of v1
+        ring_points_.push_back(point_lists_.add(vpoint_[cd.v0]));
+        if (vpoint_[cd.v1] != p1)
+            ring_points_.push_back(point_lists_.add(p1));
 
-        for (auto point : points)
+        // assign each point to its closest face
+        collapse_faces_.clear();
+        for (auto f : mesh_.faces(cd.v1))
+            collapse_faces_.push_back(f);
+        collect_triangles(collapse_faces_);
+        if (ring_faces_.empty())
+            return;
+        for (auto i : ring_points_)
         {
-            dd = std::numeric_limits<Scalar>::max();
-
-            for (auto f : mesh_.faces(cd.v1))
-            {
-                d = distance(f, point);
-                if (d < dd)
-                {
-                    ff = f;
-                    dd = d;
-                }
-            }
-
-            face_points_[ff].push_back(point);
+            const auto& p = point_lists_.point(i);
+            const auto f = ring_faces_[closest_triangle(p).first];
+            face_points_[f] = point_lists_.link(face_points_[f], i);
         }
     }
 }
@@ -1174,17 +1541,38 @@ Scalar Decimation::aspect_ratio(Face f) const
     return l / a;
 }
 
-Scalar Decimation::distance(Face f, const Point& p) const
+void Decimation::collect_triangles(const std::vector<Face>& faces)
 {
-    auto fvit = mesh_.vertices(f);
+    ring_faces_.clear();
+    ring_triangles_.clear();
+    for (auto f : faces)
+    {
+        auto fvit = mesh_.vertices(f);
+        const Point& p0 = vpoint_[*fvit];
+        const Point& p1 = vpoint_[*(++fvit)];
+        const Point& p2 = vpoint_[*(++fvit)];
 
-    const Point p0 = vpoint_[*fvit];
-    const Point p1 = vpoint_[*(++fvit)];
-    const Point p2 = vpoint_[*(++fvit)];
+        ring_faces_.push_back(f);
+        ring_triangles_.push_back({p0, p1, p2});
+    }
+}
 
+std::pair<size_t, Scalar> Decimation::closest_triangle(const Point& p) const
+{
+    size_t closest = 0;
+    Scalar dmin = std::numeric_limits<Scalar>::max();
     Point n;
-
-    return dist_point_triangle(p, p0, p1, p2, n);
+    for (size_t i = 0; i < ring_triangles_.size(); ++i)
+    {
+        const auto& t = ring_triangles_[i];
+        const Scalar d = dist_point_triangle(p, t[0], t[1], t[2], n);
+        if (d < dmin)
+        {
+            closest = i;
+            dmin = d;
+        }
+    }
+    return {closest, dmin};
 }
 
 Decimation::CollapseData::CollapseData(SurfaceMesh& sm, Halfedge h) : mesh(sm)
@@ -1217,13 +1605,40 @@ Decimation::CollapseData::CollapseData(SurfaceMesh& sm, Halfedge h) : mesh(sm)
 void decimate(SurfaceMesh& mesh, unsigned int n_vertices, Scalar aspect_ratio,
               Scalar edge_length, unsigned int max_valence,
               Scalar normal_deviation, Scalar hausdorff_error,
-              Scalar seam_threshold, Scalar seam_angle_deviation)
+              Scalar seam_threshold, Scalar seam_angle_deviation,
+              unsigned int n_faces, Scalar max_quadric_error,
+              bool attribute_quadrics, Progress* progress)
 {
+    PMP_TRACE_SCOPE("decimate");
+
     Decimation decimator(mesh);
+    decimator.initialize(aspect_ratio, edge_length, max_valence,
+                         normal_deviation, hausdorff_error, seam_threshold,
+                         seam_angle_deviation, attribute_quadrics);
+    decimator.decimate(n_vertices, n_faces, max_quadric_error, nullptr,
+                       progress);
+}
+
+ProgressiveMesh progressive_mesh(const SurfaceMesh& mesh,
+                                 unsigned int n_vertices, Scalar aspect_ratio,
+                                 Scalar edge_length, unsigned int max_valence,
+                                 Scalar normal_deviation,
+                                 Scalar hausdorff_error, Scalar seam_threshold,
+                                 Scalar seam_angle_deviation,
+                                 unsigned int n_faces, Scalar max_quadric_error)
+{
+    SurfaceMesh original = mesh;
+    original.garbage_collection();
+
+    SurfaceMesh decimated = original;
+    std::vector<ProgressiveMesh::Collapse> collapses;
+    Decimation decimator(decimated);
     decimator.initialize(aspect_ratio, edge_length, max_valence,
                          normal_deviation, hausdorff_error, seam_threshold,
                          seam_angle_deviation);
-    decimator.decimate(n_vertices);
+    decimator.decimate(n_vertices, n_faces, max_quadric_error, &collapses);
+
+    return ProgressiveMesh(original, collapses);
 }
 
 } // namespace pmp
@@ -3,7 +3,9 @@
 
 #pragma once
 
+#include "pmp/progress.h"
 #include "pmp/surface_mesh.h"
+#include "pmp/algorithms/progressive_mesh.h"
 
 namespace pmp {
 
@@ -11,6 +13,10 @@ namespace pmp {
 //! criteria.
 //! \details Performs incremental greedy mesh decimation based on halfedge
 //! collapses. See \cite kobbelt_1998_general and \cite garland_1997_surface for details.
+//! Decimation stops as soon as one of the targets \p n_vertices, \p n_faces,
+//! or \p max_quadric_error is reached, or when no collapse satisfies the
+//! remaining criteria. To decimate up to a maximum Hausdorff distance, set
+//! \p n_vertices to zero and specify \p hausdorff_error.
 //! \param mesh Target mesh. Modified in place.
 //! \param n_vertices Target number of vertices.
 //! \param aspect_ratio Minimum aspect ratio of the triangles.
@@ -20,13 +26,45 @@ namespace pmp {
 //! \param hausdorff_error Maximum deviation from the original surface.
 //! \param seam_threshold Threshold for texture seams.
 //! \param seam_angle_deviation Maximum texture seam deviation.
+//! \param n_faces Target number of faces.
+//! \param max_quadric_error Maximum quadric error, i.e., sum of squared
+//! distances to the planes of the original faces, of a collapse. With
+//! \p attribute_quadrics, only the geometric part of the error is compared.
+//! Zero disables this target.
+//! \param attribute_quadrics Use quadrics that also measure the deviation of
+//! the vertex normals \c v:normal, vertex colors \c v:color, and texture
+//! coordinates \c h:tex, if present, and place the remaining vertex of each
+//! collapse at its optimal position and attributes. See
+//! \cite garland_1998_simplifying for details. Vertices on boundaries and
+//! features keep their position.
+//! \param progress Optional progress and cancellation state, polled before
+//! each collapse. On cancellation, the mesh is left partially decimated.
 //! \pre Input mesh needs to be a triangle mesh.
 //! \throw InvalidInputException if the input precondition is violated.
+//! \throw CanceledException if \p progress is canceled.
 //! \ingroup algorithms
 void decimate(SurfaceMesh& mesh, unsigned int n_vertices,
               Scalar aspect_ratio = 0.0, Scalar edge_length = 0.0,
               unsigned int max_valence = 0, Scalar normal_deviation = 0.0,
               Scalar hausdorff_error = 0.0, Scalar seam_threshold = 1e-2,
-              Scalar seam_angle_deviation = 1);
+              Scalar seam_angle_deviation = 1, unsigned int n_faces = 0,
+              Scalar max_quadric_error = 0.0, bool attribute_quadrics = false,
+              Progress* progress = nullptr);
+
+//! \brief Record a progressive mesh by decimating a copy of \p mesh.
+//! \details Performs a single decimation pass with the same criteria as
+//! decimate() and records its collapse sequence. Any level of detail
+//! between the decimated and the input mesh can then be extracted from the
+//! result by ProgressiveMesh::extract().
+//! \note Texture coordinates are not part of the progressive mesh.
+//! \pre Input mesh needs to be a triangle mesh.
+//! \throw InvalidInputException if the input precondition is violated.
+//! \ingroup algorithms
+ProgressiveMesh progressive_mesh(
+    const SurfaceMesh& mesh, unsigned int n_vertices, Scalar aspect_ratio = 0.0,
+    Scalar edge_length = 0.0, unsigned int max_valence = 0,
+    Scalar normal_deviation = 0.0, Scalar hausdorff_error = 0.0,
+    Scalar seam_threshold = 1e-2, Scalar seam_angle_deviation = 1,
+    unsigned int n_faces = 0, Scalar max_quadric_error = 0.0);
 
 } // namespace pmp
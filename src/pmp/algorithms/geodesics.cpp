@@ -3,7 +3,9 @@
 
 #include "pmp/algorithms/geodesics.h"
 #include "pmp/algorithms/laplace.h"
+#include "pmp/trace.h"
 
+#include <algorithm>
 #include <cassert>
 #include <set>
 #include <map>
@@ -14,7 +16,8 @@ namespace {
 class Geodesics
 {
 public:
-    Geodesics(SurfaceMesh& mesh, bool use_virtual_edges = true);
+    Geodesics(SurfaceMesh& mesh, bool use_virtual_edges = true,
+              Progress* progress = nullptr);
     ~Geodesics();
     unsigned int compute(
         const std::vector<Vertex>& seed,
@@ -64,6 +67,8 @@ private:
                     Scalar r1 = std::numeric_limits<Scalar>::max());
 
     SurfaceMesh& mesh_;
+    Progress* progress_;
+    bool canceled_{false};
 
     bool use_virtual_edges_;
     VirtualEdges virtual_edges_;
@@ -74,8 +79,9 @@ private:
     VertexProperty<bool> processed_;
 };
 
-Geodesics::Geodesics(SurfaceMesh& mesh, bool use_virtual_edges)
-    : mesh_(mesh), use_virtual_edges_(use_virtual_edges)
+Geodesics::Geodesics(SurfaceMesh& mesh, bool use_virtual_edges,
+                     Progress* progress)
+    : mesh_(mesh), progress_(progress), use_virtual_edges_(use_virtual_edges)
 {
     distance_ = mesh_.vertex_property<Scalar>("geodesic:distance");
     processed_ = mesh_.add_vertex_property<bool>("geodesic:processed");
@@ -91,6 +97,8 @@ Geodesics::~Geodesics()
 
 void Geodesics::find_virtual_edges()
 {
+    PMP_TRACE_SCOPE("find_virtual_edges");
+
     Halfedge hh, hhh;
     Vertex vh0, vh1, vhn, start_vh0, start_vh1;
     Point pp, p0, p1, pn, p, d0, d1;
@@ -230,6 +238,9 @@ unsigned int Geodesics::compute(const std::vector<Vertex>& seed, Scalar maxdist,
     // clean up
     delete front_;
 
+    if (canceled_)
+        throw CanceledException("geodesics: Canceled.");
+
     return num;
 }
 
@@ -299,10 +310,22 @@ unsigned int Geodesics::init_front(const std::vector<Vertex>& seed,
 unsigned int Geodesics::propagate_front(Scalar maxdist, unsigned int maxnum,
                                         std::vector<Vertex>* neighbors)
 {
+    PMP_TRACE_SCOPE("propagate_front");
+
     unsigned int num(0);
 
+    // fraction of processed vertices or neighbors
+    const auto total = std::min<size_t>(maxnum, mesh_.n_vertices());
+
     while (!front_->empty())
     {
+        if (progress_ &&
+            !progress_->checkpoint(total ? float(num) / total : 0.0f))
+        {
+            canceled_ = true;
+            break;
+        }
+
         // find minimum vertex, remove it from queue
         auto v = *front_->begin();
         front_->erase(front_->begin());
@@ -330,6 +353,8 @@ unsigned int Geodesics::propagate_front(Scalar maxdist, unsigned int maxnum,
         }
     }
 
+    PMP_TRACE_COUNT("heap_pops", num);
+
     return num;
 }
 
@@ -533,14 +558,25 @@ void distance_to_texture_coordinates(SurfaceMesh& mesh)
 
 unsigned int geodesics(SurfaceMesh& mesh, const std::vector<Vertex>& seed,
                        Scalar maxdist, unsigned int maxnum,
-                       std::vector<Vertex>* neighbors)
+                       std::vector<Vertex>* neighbors, Progress* progress)
 {
-    return Geodesics(mesh, true /*virtual edges*/)
+    PMP_TRACE_SCOPE("geodesics");
+
+    return Geodesics(mesh, true /*virtual edges*/, progress)
         .compute(seed, maxdist, maxnum, neighbors);
 }
 
-void geodesics_heat(SurfaceMesh& mesh, const std::vector<Vertex>& seed)
+void geodesics_heat(SurfaceMesh& mesh, const std::vector<Vertex>& seed,
+                    Progress* progress)
 {
+    PMP_TRACE_SCOPE("geodesics_heat");
+
+    // the distances are only written after both solves
+    auto checkpoint = [progress](float fraction) {
+        if (progress && !progress->checkpoint(fraction))
+            throw CanceledException("geodesics_heat: Canceled.");
+    };
+
     const unsigned int n = mesh.n_vertices();
 
     // setup all matrices
@@ -550,6 +586,7 @@ void geodesics_heat(SurfaceMesh& mesh, const std::vector<Vertex>& seed)
     divergence_matrix(mesh, D);
     mass_matrix(mesh, M);
     L = D * G;
+    checkpoint(0.2);
 
     // diffusion time step (squared mean edge length)
     double h = max_diagonal_length(mesh);
@@ -563,6 +600,7 @@ void geodesics_heat(SurfaceMesh& mesh, const std::vector<Vertex>& seed)
         b.coeffRef(s.idx()) = 1.0;
     }
     Eigen::VectorXd heat = cholesky_solve(A, b);
+    checkpoint(0.6);
 
     // compute and normalize heat gradient
     Eigen::VectorXd grad = G * heat;
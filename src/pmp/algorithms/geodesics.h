@@ -6,6 +6,7 @@
 #include <limits>
 #include <vector>
 
+#include "pmp/progress.h"
 #include "pmp/surface_mesh.h"
 
 namespace pmp {
@@ -21,14 +22,18 @@ namespace pmp {
 //! \param[in] maxnum The maximum number of neighbors up to which to
 //! compute the geodesic distances.
 //! \param[out] neighbors The vector of neighbor vertices.
+//! \param progress Optional progress and cancellation state, polled per
+//! heap pop.
 //! \return The number of neighbors that have been found.
 //! \pre Input mesh needs to be a triangle mesh.
+//! \throw CanceledException if \p progress is canceled. Distances of
+//! unprocessed vertices are left undefined.
 //! \ingroup algorithms
 unsigned int geodesics(
     SurfaceMesh& mesh, const std::vector<Vertex>& seeds,
     Scalar maxdist = std::numeric_limits<Scalar>::max(),
     unsigned int maxnum = std::numeric_limits<unsigned int>::max(),
-    std::vector<Vertex>* neighbors = nullptr);
+    std::vector<Vertex>* neighbors = nullptr, Progress* progress = nullptr);
 
 //! \brief Compute geodesic distance from a set of seed vertices
 //! \details Compute geodesic distances based on the heat method,
@@ -36,9 +41,14 @@ unsigned int geodesics(
 //! See \cite crane_2013_geodesics for details.
 //! \param mesh The input mesh, modified in place.
 //! \param seeds The vector of seed vertices.
+//! \param progress Optional progress and cancellation state, polled between
+//! the solver steps.
 //! \note This algorithm works on general polygon meshes.
+//! \throw CanceledException if \p progress is canceled. The mesh is left
+//! unchanged in this case.
 //! \ingroup algorithms
-void geodesics_heat(SurfaceMesh& mesh, const std::vector<Vertex>& seeds);
+void geodesics_heat(SurfaceMesh& mesh, const std::vector<Vertex>& seeds,
+                    Progress* progress = nullptr);
 
 //! \brief Use the normalized distances as texture coordinates
 //! \details Stores the normalized distances in a vertex property of type
@@ -11,6 +11,7 @@
 
 #include "pmp/algorithms/fairing.h"
 #include "pmp/algorithms/normals.h"
+#include "pmp/trace.h"
 
 namespace pmp {
 namespace {
@@ -18,7 +19,7 @@ namespace {
 class HoleFilling
 {
 public:
-    explicit HoleFilling(SurfaceMesh& mesh);
+    explicit HoleFilling(SurfaceMesh& mesh, Progress* progress = nullptr);
     void fill_hole(Halfedge h);
 
 private:
@@ -49,6 +50,13 @@ private:
     // throws InvalidInputException in case of a non-manifold hole.
     void triangulate_hole(Halfedge h);
 
+    // report progress, throws CanceledException if canceled
+    void checkpoint(float fraction) const
+    {
+        if (progress_ && !progress_->checkpoint(fraction))
+            throw CanceledException("fill_hole: Canceled.");
+    }
+
     // compute the weight of the triangle (i,j,k).
     Weight compute_weight(int i, int j, int k) const;
 
@@ -89,6 +97,7 @@ private:
 
     // mesh and properties
     SurfaceMesh& mesh_;
+    Progress* progress_;
     VertexProperty<Point> points_;
     VertexProperty<bool> vlocked_;
     EdgeProperty<bool> elocked_;
@@ -100,7 +109,8 @@ private:
     std::vector<std::vector<int>> index_;
 };
 
-HoleFilling::HoleFilling(SurfaceMesh& mesh) : mesh_(mesh)
+HoleFilling::HoleFilling(SurfaceMesh& mesh, Progress* progress)
+    : mesh_(mesh), progress_(progress)
 {
     points_ = mesh_.vertex_property<Point>("v:point");
 }
@@ -157,14 +167,14 @@ void HoleFilling::fill_hole(Halfedge h)
         triangulate_hole(h); // do minimal triangulation
         refine();            // refine filled-in edges
     }
-    catch (InvalidInputException& e)
+    catch (...)
     {
         // clean up
         hole_.clear();
         mesh_.remove_vertex_property(vlocked_);
         mesh_.remove_edge_property(elocked_);
 
-        throw e;
+        throw;
     }
 
     // clean up
@@ -175,6 +185,8 @@ void HoleFilling::fill_hole(Halfedge h)
 
 void HoleFilling::triangulate_hole(Halfedge h)
 {
+    PMP_TRACE_SCOPE("triangulate_hole");
+
     // trace hole
     hole_.clear();
     Halfedge hit = h;
@@ -210,6 +222,8 @@ void HoleFilling::triangulate_hole(Halfedge h)
     // n-gons with n>2
     for (j = 2; j < n; ++j)
     {
+        checkpoint(0.3f * j / n);
+
         // for all n-gons [i,i+j]
         for (i = 0; i < n - j; ++i)
         {
@@ -304,6 +318,8 @@ HoleFilling::Weight HoleFilling::compute_weight(int i, int j, int k) const
 
 void HoleFilling::refine()
 {
+    PMP_TRACE_SCOPE("refine");
+
     const int n = hole_.size();
     Scalar l, lmin, lmax;
 
@@ -321,11 +337,13 @@ void HoleFilling::refine()
     // do some iterations
     for (int iter = 0; iter < 10; ++iter)
     {
+        checkpoint(0.3f + 0.06f * iter);
         split_long_edges(lmax);
         collapse_short_edges(lmin);
         flip_edges();
         relaxation();
     }
+    checkpoint(0.9f);
     fairing();
 }
 
@@ -536,6 +554,8 @@ void HoleFilling::relaxation()
 
 void HoleFilling::fairing()
 {
+    PMP_TRACE_SCOPE("fairing");
+
     // did the refinement insert new vertices?
     // if yes, then trigger fairing; otherwise don't.
     bool new_vertices = false;
@@ -567,9 +587,11 @@ void HoleFilling::fairing()
 }
 } // namespace
 
-void fill_hole(SurfaceMesh& mesh, Halfedge h)
+void fill_hole(SurfaceMesh& mesh, Halfedge h, Progress* progress)
 {
-    HoleFilling(mesh).fill_hole(h);
+    PMP_TRACE_SCOPE("fill_hole");
+
+    HoleFilling(mesh, progress).fill_hole(h);
 }
 
 } // namespace pmp
@@ -3,6 +3,7 @@
 
 #pragma once
 
+#include "pmp/progress.h"
 #include "pmp/surface_mesh.h"
 
 namespace pmp {
@@ -16,9 +17,16 @@ namespace pmp {
 //! \pre The specified halfedge is valid.
 //! \pre The specified halfedge is a boundary halfedge.
 //! \pre The specified halfedge is not adjacent to a non-manifold hole.
+//! \param mesh The mesh, modified in place.
+//! \param h A boundary halfedge of the hole.
+//! \param progress Optional progress and cancellation state, polled during
+//! the triangulation and per refinement iteration. If canceled during the
+//! triangulation, the hole is left open. Otherwise, it is left filled but not
+//! fully refined or faired.
 //! \throw InvalidInputException in case on of the input preconditions is violated
+//! \throw CanceledException if \p progress is canceled.
 //! \note This algorithm works on general polygon meshes.
 //! \ingroup algorithms
-void fill_hole(SurfaceMesh& mesh, Halfedge h);
+void fill_hole(SurfaceMesh& mesh, Halfedge h, Progress* progress = nullptr);
 
 } // namespace pmp
@@ -0,0 +1,650 @@
+// Copyright 2023 the Polygon Mesh Processing Library developers.
+// Distributed under a MIT-style license, see LICENSE.txt for details.
+
+#include "pmp/algorithms/meshlets.h"
+#include "pmp/algorithms/decimation.h"
+#include "pmp/algorithms/distance_point_triangle.h"
+#include "pmp/algorithms/normal_cone.h"
+#include "pmp/algorithms/normals.h"
+#include "pmp/io/helpers.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <string>
+
+namespace pmp {
+namespace {
+
+// meshlets of a group are decimated together
+constexpr size_t max_group_size = 4;
+
+// a meshlet under construction, with triangles as position indices
+struct Cluster
+{
+    std::vector<Face> faces;
+    std::vector<uint32_t> triangles;
+    Meshlet meshlet;
+};
+
+void check_input(const SurfaceMesh& mesh, unsigned int max_vertices,
+                 unsigned int max_triangles, const std::string& function)
+{
+    if (!mesh.is_triangle_mesh())
+        throw InvalidInputException(function + ": Not a triangle mesh.");
+    if (max_vertices < 3 || max_vertices > 256)
+        throw InvalidInputException(
+            function + ": Number of vertices must be in [3, 256].");
+    if (max_triangles < 1)
+        throw InvalidInputException(
+            function + ": Number of triangles must be positive.");
+}
+
+// bounding sphere by Ritter's algorithm
+void bounding_sphere(const std::vector<Point>& points, Point& center,
+                     Scalar& radius)
+{
+    const auto farthest = [&](const Point& p) {
+        return *std::max_element(points.begin(), points.end(),
+                                 [&](const Point& a, const Point& b) {
+                                     return sqrnorm(a - p) < sqrnorm(b - p);
+                                 });
+    };
+    const Point p0 = farthest(points.front());
+    const Point p1 = farthest(p0);
+    center = Scalar(0.5) * (p0 + p1);
+    radius = Scalar(0.5) * norm(p1 - p0);
+
+    // grow the sphere to contain points outside of it
+    for (const auto& p : points)
+    {
+        const Scalar d = norm(p - center);
+        if (d > radius)
+        {
+            const Scalar r = Scalar(0.5) * (radius + d);
+            center += (r - radius) / d * (p - center);
+            radius = r;
+        }
+    }
+}
+
+// bounding sphere and normal cone of a cluster
+void culling_data(const SurfaceMesh& mesh, Cluster& cluster,
+                  const std::vector<Point>& positions)
+{
+    std::vector<Point> points;
+    points.reserve(cluster.triangles.size());
+    for (auto i : cluster.triangles)
+        points.push_back(positions[i]);
+    bounding_sphere(points, cluster.meshlet.center, cluster.meshlet.radius);
+
+    NormalCone cone(face_normal(mesh, cluster.faces.front()));
+    for (auto f : cluster.faces)
+        cone.merge(face_normal(mesh, f));
+    cluster.meshlet.cone_axis = cone.center_normal();
+    cluster.meshlet.cone_angle = cone.angle();
+}
+
+// Greedily grow clusters over the available faces, starting at the first
+// available face of faces and adding the adjacent face with the fewest new
+// vertices. Unless connected is set, clusters continue with the next
+// available face when no adjacent face is left. Assigned faces are marked as
+// not available.
+void grow_clusters(const SurfaceMesh& mesh, const std::vector<Face>& faces,
+                   unsigned int max_vertices, unsigned int max_triangles,
+                   bool connected, std::vector<bool>& available,
+                   const std::vector<uint32_t>& position_index,
+                   const std::vector<Point>& positions,
+                   std::vector<Cluster>& clusters)
+{
+    std::vector<int> local(mesh.vertices_size(), -1);
+    std::vector<Vertex> vertices;
+    std::vector<Face> frontier;
+
+    size_t next = 0;
+    for (auto seed : faces)
+    {
+        if (!available[seed.idx()])
+            continue;
+
+        Cluster cluster;
+        vertices.clear();
+        frontier.assign(1, seed);
+        Point centroid_sum(0, 0, 0);
+
+        while (cluster.faces.size() < max_triangles)
+        {
+            // candidate with the fewest new vertices, ties are broken by
+            // the distance to the centroid to keep clusters compact
+            Face best;
+            size_t best_new = 4;
+            Scalar best_distance = std::numeric_limits<Scalar>::max();
+            const Point centroid =
+                vertices.empty() ? Point(0, 0, 0)
+                                 : centroid_sum / Scalar(vertices.size());
+            for (size_t i = 0; i < frontier.size();)
+            {
+                const auto f = frontier[i];
+                if (!available[f.idx()])
+                {
+                    frontier[i] = frontier.back();
+                    frontier.pop_back();
+                    continue;
+                }
+                size_t n_new = 0;
+                Point center(0, 0, 0);
+                for (auto v : mesh.vertices(f))
+                {
+                    n_new += local[v.idx()] < 0;
+                    center += mesh.position(v);
+                }
+                const Scalar distance = sqrnorm(center / 3 - centroid);
+                if (n_new < best_new ||
+                    (n_new == best_new && distance < best_distance))
+                {
+                    best = f;
+                    best_new = n_new;
+                    best_distance = distance;
+                }
+                ++i;
+            }
+            if (!best.is_valid() && !connected)
+            {
+                while (next < faces.size() && !available[faces[next].idx()])
+                    ++next;
+                if (next < faces.size())
+                {
+                    best = faces[next];
+                    best_new = 0;
+                    for (auto v : mesh.vertices(best))
+                        best_new += local[v.idx()] < 0;
+                }
+            }
+            if (!best.is_valid() || vertices.size() + best_new > max_vertices)
+                break;
+
+            // add it and its neighbors to the frontier
+            available[best.idx()] = false;
+            cluster.faces.push_back(best);
+            for (auto v : mesh.vertices(best))
+            {
+                if (local[v.idx()] < 0)
+                {
+                    local[v.idx()] = static_cast<int>(vertices.size());
+                    vertices.push_back(v);
+                    centroid_sum += mesh.position(v);
+                }
+                cluster.triangles.push_back(position_index[v.idx()]);
+            }
+            for (auto h : mesh.halfedges(best))
+            {
+                const auto f = mesh.face(mesh.opposite_halfedge(h));
+                if (f.is_valid() && available[f.idx()])
+                    frontier.push_back(f);
+            }
+        }
+
+        for (auto v : vertices)
+            local[v.idx()] = -1;
+
+        culling_data(mesh, cluster, positions);
+        clusters.push_back(std::move(cluster));
+    }
+}
+
+// group adjacent clusters, returns the group of each cluster
+std::vector<size_t> group_clusters(const SurfaceMesh& mesh,
+                                   const std::vector<Cluster>& clusters,
+                                   size_t& n_groups)
+{
+    std::vector<size_t> cluster_of(mesh.faces_size());
+    for (size_t c = 0; c < clusters.size(); ++c)
+        for (auto f : clusters[c].faces)
+            cluster_of[f.idx()] = c;
+
+    // number of shared edges of adjacent clusters
+    std::vector<std::vector<std::pair<size_t, size_t>>> adjacency(
+        clusters.size());
+    for (size_t c = 0; c < clusters.size(); ++c)
+        for (auto f : clusters[c].faces)
+            for (auto h : mesh.halfedges(f))
+            {
+                const auto g = mesh.face(mesh.opposite_halfedge(h));
+                if (!g.is_valid() || cluster_of[g.idx()] == c)
+                    continue;
+                const auto neighbor = cluster_of[g.idx()];
+                auto it = std::find_if(
+                    adjacency[c].begin(), adjacency[c].end(),
+                    [&](const auto& a) { return a.first == neighbor; });
+                if (it == adjacency[c].end())
+                    adjacency[c].emplace_back(neighbor, 1);
+                else
+                    ++it->second;
+            }
+
+    // greedily add the neighbor sharing the most edges with the group
+    const auto none = std::numeric_limits<size_t>::max();
+    std::vector<size_t> group(clusters.size(), none);
+    std::vector<size_t> members;
+    n_groups = 0;
+    for (size_t c = 0; c < clusters.size(); ++c)
+    {
+        if (group[c] != none)
+            continue;
+        group[c] = n_groups;
+        members.assign(1, c);
+        while (members.size() < max_group_size)
+        {
+            size_t best = none, best_shared = 0;
+            for (auto m : members)
+                for (const auto& [neighbor, shared] : adjacency[m])
+                    if (group[neighbor] == none && shared > best_shared)
+                    {
+                        best = neighbor;
+                        best_shared = shared;
+                    }
+            if (best == none)
+                break;
+            group[best] = n_groups;
+            members.push_back(best);
+        }
+        ++n_groups;
+    }
+
+    // add single clusters to the adjacent group sharing the most edges
+    std::vector<size_t> group_size(n_groups, 0);
+    for (auto g : group)
+        ++group_size[g];
+    for (size_t c = 0; c < clusters.size(); ++c)
+    {
+        if (group_size[group[c]] > 1)
+            continue;
+        size_t best = none, best_shared = 0;
+        for (const auto& [neighbor, shared] : adjacency[c])
+            if (shared > best_shared)
+            {
+                best = group[neighbor];
+                best_shared = shared;
+            }
+        if (best != none)
+        {
+            --group_size[group[c]];
+            group[c] = best;
+            ++group_size[best];
+        }
+    }
+
+    // number the remaining groups consecutively
+    std::vector<size_t> renumber(n_groups, none);
+    n_groups = 0;
+    for (auto& g : group)
+    {
+        if (renumber[g] == none)
+            renumber[g] = n_groups++;
+        g = renumber[g];
+    }
+    return group;
+}
+
+// sort clusters from coarse to fine, number positions by first use, and
+// convert triangles to meshlet vertices
+Meshlets finalize(std::vector<Cluster>& clusters,
+                  const std::vector<Point>& positions)
+{
+    std::stable_sort(clusters.begin(), clusters.end(),
+                     [](const Cluster& a, const Cluster& b) {
+                         return a.meshlet.level > b.meshlet.level;
+                     });
+
+    Meshlets result;
+    const auto none = std::numeric_limits<uint32_t>::max();
+    std::vector<uint32_t> renumber(positions.size(), none);
+    std::vector<int> local(positions.size(), -1);
+    for (auto& cluster : clusters)
+    {
+        auto& meshlet = cluster.meshlet;
+        meshlet.vertex_offset = static_cast<uint32_t>(result.vertices.size());
+        meshlet.triangle_offset =
+            static_cast<uint32_t>(result.triangles.size());
+        meshlet.n_triangles =
+            static_cast<uint32_t>(cluster.triangles.size() / 3);
+
+        for (auto i : cluster.triangles)
+        {
+            if (renumber[i] == none)
+            {
+                renumber[i] = static_cast<uint32_t>(result.positions.size());
+                result.positions.push_back(positions[i]);
+            }
+            if (local[i] < 0)
+            {
+                local[i] = static_cast<int>(result.vertices.size() -
+                                            meshlet.vertex_offset);
+                result.vertices.push_back(renumber[i]);
+            }
+            result.triangles.push_back(static_cast<uint8_t>(local[i]));
+        }
+        meshlet.n_vertices = static_cast<uint32_t>(result.vertices.size() -
+                                                   meshlet.vertex_offset);
+        for (auto i : cluster.triangles)
+            local[i] = -1;
+
+        result.meshlets.push_back(meshlet);
+    }
+    return result;
+}
+
+} // namespace
+
+Meshlets meshlets(const SurfaceMesh& mesh, unsigned int max_vertices,
+                  unsigned int max_triangles)
+{
+    check_input(mesh, max_vertices, max_triangles, "meshlets");
+
+    std::vector<uint32_t> position_index(mesh.vertices_size());
+    std::vector<Point> positions(mesh.vertices_size());
+    for (auto v : mesh.vertices())
+    {
+        position_index[v.idx()] = v.idx();
+        positions[v.idx()] = mesh.position(v);
+    }
+
+    std::vector<Face> faces(mesh.faces_begin(), mesh.faces_end());
+    std::vector<bool> available(mesh.faces_size(), false);
+    for (auto f : faces)
+        available[f.idx()] = true;
+
+    std::vector<Cluster> clusters;
+    grow_clusters(mesh, faces, max_vertices, max_triangles, true, available,
+                  position_index, positions, clusters);
+
+    return finalize(clusters, positions);
+}
+
+Meshlets meshlet_lod(const SurfaceMesh& mesh, unsigned int max_vertices,
+                     unsigned int max_triangles)
+{
+    check_input(mesh, max_vertices, max_triangles, "meshlet_lod");
+
+    // a working copy keeps the index of each vertex position, which does not
+    // change during decimation
+    SurfaceMesh work(mesh);
+    work.garbage_collection();
+    auto vindex = work.vertex_property<uint32_t>("v:meshlet_index");
+    std::vector<uint32_t> position_index(work.vertices_size());
+    std::vector<Point> positions(work.vertices_size());
+    for (auto v : work.vertices())
+    {
+        vindex[v] = position_index[v.idx()] = v.idx();
+        positions[v.idx()] = work.position(v);
+    }
+
+    // finest level
+    std::vector<Face> faces(work.faces_begin(), work.faces_end());
+    std::vector<bool> available(work.faces_size(), true);
+    std::vector<Cluster> clusters, level;
+    grow_clusters(work, faces, max_vertices, max_triangles, true, available,
+                  position_index, positions, level);
+
+    for (uint32_t l = 1; level.size() > 1; ++l)
+    {
+        size_t n_groups = 0;
+        const auto group = group_clusters(work, level, n_groups);
+        auto fgroup = work.face_property<size_t>("f:meshlet_group");
+        for (size_t c = 0; c < level.size(); ++c)
+            for (auto f : level[c].faces)
+                fgroup[f] = group[c];
+
+        // only vertices inside of a group may be removed
+        auto selected = work.vertex_property<bool>("v:selected");
+        std::vector<std::pair<uint32_t, size_t>> removable;
+        for (auto v : work.vertices())
+        {
+            size_t g = n_groups;
+            bool inside = true;
+            for (auto f : work.faces(v))
+            {
+                if (g == n_groups)
+                    g = fgroup[f];
+                else if (g != fgroup[f])
+                    inside = false;
+            }
+            selected[v] = inside && g != n_groups;
+            if (selected[v])
+                removable.emplace_back(vindex[v], g);
+        }
+        if (removable.empty())
+            break;
+
+        const auto n_faces = work.n_faces();
+        decimate(work, 0, 0.0, 0.0, 0, 0.0, 0.0, 1e-2, 1,
+                 static_cast<unsigned int>(n_faces / 2));
+        work.remove_vertex_property(selected);
+        if (work.n_faces() > n_faces * 85 / 100)
+            break;
+
+        // group error: distance of removed vertices to the simplified group,
+        // at least the error of the meshlets of the group
+        std::vector<std::vector<Face>> group_faces(n_groups);
+        fgroup = work.get_face_property<size_t>("f:meshlet_group");
+        for (auto f : work.faces())
+            group_faces[fgroup[f]].push_back(f);
+
+        vindex = work.get_vertex_property<uint32_t>("v:meshlet_index");
+        position_index.assign(work.vertices_size(), 0);
+        std::vector<bool> present(positions.size(), false);
+        for (auto v : work.vertices())
+        {
+            position_index[v.idx()] = vindex[v];
+            present[vindex[v]] = true;
+        }
+
+        std::vector<Scalar> group_error(n_groups, 0);
+        for (size_t c = 0; c < level.size(); ++c)
+            group_error[group[c]] =
+                std::max(group_error[group[c]], level[c].meshlet.error);
+        for (const auto& [i, g] : removable)
+        {
+            if (present[i])
+                continue;
+            Scalar dist = std::numeric_limits<Scalar>::max();
+            Point nearest;
+            for (auto f : group_faces[g])
+            {
+                auto fv = work.vertices(f);
+                const auto& p0 = work.position(*fv);
+                const auto& p1 = work.position(*++fv);
+                const auto& p2 = work.position(*++fv);
+                dist = std::min(dist, dist_point_triangle(positions[i], p0, p1,
+                                                          p2, nearest));
+            }
+            group_error[g] = std::max(group_error[g], dist);
+        }
+
+        for (size_t c = 0; c < level.size(); ++c)
+            level[c].meshlet.parent_error = group_error[group[c]];
+        for (auto& cluster : level)
+            clusters.push_back(std::move(cluster));
+        level.clear();
+
+        // split each group into meshlets of the next level
+        available.assign(work.faces_size(), false);
+        for (size_t g = 0; g < n_groups; ++g)
+        {
+            for (auto f : group_faces[g])
+                available[f.idx()] = true;
+            const auto begin = level.size();
+            grow_clusters(work, group_faces[g], max_vertices, max_triangles,
+                          false, available, position_index, positions, level);
+            for (auto c = begin; c < level.size(); ++c)
+            {
+                level[c].meshlet.level = l;
+                level[c].meshlet.error = group_error[g];
+            }
+        }
+        work.remove_face_property(fgroup);
+    }
+
+    for (auto& cluster : level)
+        clusters.push_back(std::move(cluster));
+
+    return finalize(clusters, positions);
+}
+
+void Meshlets::write(const std::filesystem::path& file) const
+{
+    FILE* out = fopen(file.string().c_str(), "wb");
+    if (!out)
+        throw IOException("Failed to open file: " + file.string());
+
+    // header
+    fwrite("PMPML", 1, 5, out);
+    tfwrite(out, static_cast<uint32_t>(n_levels()));
+
+    // levels from coarse to fine, each with its meshlets, the positions they
+    // use first, and their vertices and triangles
+    size_t n_positions = 0;
+    for (size_t begin = 0, end = 0; begin < meshlets.size(); begin = end)
+    {
+        while (end < meshlets.size() &&
+               meshlets[end].level == meshlets[begin].level)
+            ++end;
+
+        const auto& first = meshlets[begin];
+        const auto& last = meshlets[end - 1];
+        const size_t vertices_end = last.vertex_offset + last.n_vertices;
+        const size_t triangles_end =
+            last.triangle_offset + 3 * size_t(last.n_triangles);
+        size_t positions_end = n_positions;
+        for (size_t i = first.vertex_offset; i < vertices_end; ++i)
+            positions_end = std::max<size_t>(positions_end, vertices[i] + 1);
+
+        tfwrite(out, static_cast<uint32_t>(end - begin));
+        tfwrite(out, static_cast<uint32_t>(positions_end - n_positions));
+        tfwrite(out, static_cast<uint32_t>(vertices_end - first.vertex_offset));
+        tfwrite(out,
+                static_cast<uint32_t>(triangles_end - first.triangle_offset));
+
+        fwrite(positions.data() + n_positions, sizeof(Point),
+               positions_end - n_positions, out);
+        for (size_t i = begin; i < end; ++i)
+        {
+            const auto& m = meshlets[i];
+            tfwrite(out, m.n_vertices);
+            tfwrite(out, m.n_triangles);
+            tfwrite(out, m.center);
+            tfwrite(out, m.radius);
+            tfwrite(out, m.cone_axis);
+            tfwrite(out, m.cone_angle);
+            tfwrite(out, m.error);
+            tfwrite(out, m.parent_error);
+        }
+        fwrite(vertices.data() + first.vertex_offset, sizeof(uint32_t),
+               vertices_end - first.vertex_offset, out);
+        fwrite(triangles.data() + first.triangle_offset, 1,
+               triangles_end - first.triangle_offset, out);
+        n_positions = positions_end;
+    }
+
+    const bool failed = ferror(out);
+    fclose(out);
+    if (failed)
+        throw IOException("Failed to write file: " + file.string());
+}
+
+void Meshlets::read(const std::filesystem::path& file, size_t n_levels)
+{
+    FILE* in = fopen(file.string().c_str(), "rb");
+    if (!in)
+        throw IOException("Failed to open file: " + file.string());
+
+    meshlets.clear();
+    vertices.clear();
+    triangles.clear();
+    positions.clear();
+
+    char magic[5];
+    uint32_t n_file_levels{0};
+    bool ok = fread(magic, 1, 5, in) == 5 && !strncmp(magic, "PMPML", 5);
+    ok = ok && fread(&n_file_levels, sizeof(n_file_levels), 1, in) == 1;
+    auto remaining = remaining_bytes(in);
+
+    for (size_t l = 0; ok && l < std::min<size_t>(n_levels, n_file_levels);
+         ++l)
+    {
+        uint32_t nm{0}, np{0}, nv{0}, nt{0};
+        ok = fread(&nm, sizeof(nm), 1, in) == 1 &&
+             fread(&np, sizeof(np), 1, in) == 1 &&
+             fread(&nv, sizeof(nv), 1, in) == 1 &&
+             fread(&nt, sizeof(nt), 1, in) == 1;
+        if (!ok)
+            break;
+
+        // bound the counts by the file size before allocating
+        constexpr size_t meshlet_size =
+            sizeof(Meshlet::n_vertices) + sizeof(Meshlet::n_triangles) +
+            sizeof(Meshlet::center) + sizeof(Meshlet::radius) +
+            sizeof(Meshlet::cone_axis) + sizeof(Meshlet::cone_angle) +
+            sizeof(Meshlet::error) + sizeof(Meshlet::parent_error);
+        const size_t level_size = np * sizeof(Point) + nm * meshlet_size +
+                                  nv * sizeof(uint32_t) + size_t(nt);
+        ok = level_size <= remaining;
+        if (!ok)
+            break;
+        remaining -= level_size;
+
+        const size_t p0 = positions.size(), m0 = meshlets.size();
+        const size_t v0 = vertices.size(), t0 = triangles.size();
+        positions.resize(p0 + np);
+        meshlets.resize(m0 + nm);
+        vertices.resize(v0 + nv);
+        triangles.resize(t0 + nt);
+
+        ok = fread(positions.data() + p0, sizeof(Point), np, in) == np;
+        size_t vertex_offset = v0, triangle_offset = t0;
+        for (size_t i = m0; ok && i < meshlets.size(); ++i)
+        {
+            auto& m = meshlets[i];
+            ok = fread(&m.n_vertices, sizeof(m.n_vertices), 1, in) == 1 &&
+                 fread(&m.n_triangles, sizeof(m.n_triangles), 1, in) == 1 &&
+                 fread(&m.center, sizeof(m.center), 1, in) == 1 &&
+                 fread(&m.radius, sizeof(m.radius), 1, in) == 1 &&
+                 fread(&m.cone_axis, sizeof(m.cone_axis), 1, in) == 1 &&
+                 fread(&m.cone_angle, sizeof(m.cone_angle), 1, in) == 1 &&
+                 fread(&m.error, sizeof(m.error), 1, in) == 1 &&
+                 fread(&m.parent_error, sizeof(m.parent_error), 1, in) == 1;
+            m.level = static_cast<uint32_t>(n_file_levels - 1 - l);
+            m.vertex_offset = static_cast<uint32_t>(vertex_offset);
+            m.triangle_offset = static_cast<uint32_t>(triangle_offset);
+            vertex_offset += m.n_vertices;
+            triangle_offset += 3 * size_t(m.n_triangles);
+        }
+        ok = ok && vertex_offset == vertices.size() &&
+             triangle_offset == triangles.size();
+        ok = ok &&
+             fread(vertices.data() + v0, sizeof(uint32_t), nv, in) == nv &&
+             fread(triangles.data() + t0, 1, nt, in) == nt;
+
+        // check indices
+        for (size_t i = v0; ok && i < vertices.size(); ++i)
+            ok = vertices[i] < positions.size();
+        for (size_t i = m0; ok && i < meshlets.size(); ++i)
+        {
+            const auto& m = meshlets[i];
+            for (size_t j = 0; ok && j < 3 * size_t(m.n_triangles); ++j)
+                ok = triangles[m.triangle_offset + j] < m.n_vertices;
+        }
+    }
+    fclose(in);
+
+    if (!ok)
+    {
+        meshlets.clear();
+        vertices.clear();
+        triangles.clear();
+        positions.clear();
+        throw IOException("Failed to read file: " + file.string());
+    }
+}
+
+} // namespace pmp
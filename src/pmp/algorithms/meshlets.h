@@ -0,0 +1,118 @@
+// Copyright 2023 the Polygon Mesh Processing Library developers.
+// Distributed under a MIT-style license, see LICENSE.txt for details.
+
+#pragma once
+
+#include <cstdint>
+#include <filesystem>
+#include <limits>
+#include <vector>
+
+#include "pmp/surface_mesh.h"
+
+namespace pmp {
+
+//! \brief A cluster of at most 256 vertices and a bounded number of
+//! triangles, as used by mesh shaders and GPU-driven culling.
+//! \sa Meshlets
+//! \ingroup algorithms
+struct Meshlet
+{
+    uint32_t vertex_offset{0};   //!< first entry in Meshlets::vertices
+    uint32_t triangle_offset{0}; //!< first entry in Meshlets::triangles
+    uint32_t n_vertices{0};      //!< number of vertices
+    uint32_t n_triangles{0};     //!< number of triangles
+
+    //! \name Culling
+    //!@{
+    Point center{0, 0, 0}; //!< center of the bounding sphere
+    Scalar radius{0};      //!< radius of the bounding sphere
+    Normal cone_axis{0, 0, 1}; //!< axis of the cone of face normals
+    //! \brief Opening angle of the cone of face normals in radians.
+    //! \details The meshlet faces away from a viewer at direction \c d from
+    //! all of its points if <tt>dot(d, cone_axis) < -sin(cone_angle)</tt>.
+    //! Angles of \f$\pi/2\f$ or more prevent culling.
+    Scalar cone_angle{0};
+    //!@}
+
+    //! \name Level of detail
+    //!@{
+    uint32_t level{0}; //!< level of detail, zero is the finest
+    //! Simplification error of this meshlet w.r.t. the finest level.
+    Scalar error{0};
+    //! \brief Error of the coarser meshlets replacing this one.
+    //! \details A consistent cut through the hierarchy renders the meshlets
+    //! with <tt>error <= threshold < parent_error</tt>.
+    Scalar parent_error{std::numeric_limits<Scalar>::max()};
+    //!@}
+};
+
+//! \brief A mesh partitioned into meshlets, possibly at several levels of
+//! detail.
+//! \details Meshlets are sorted from the coarsest to the finest level, and
+//! positions are numbered by their first use in this order. The binary
+//! format of write() follows the same order, such that a prefix of the
+//! file contains the coarse levels and can be displayed while the remaining
+//! levels are loaded.
+//! \sa meshlets(), meshlet_lod()
+//! \ingroup algorithms
+struct Meshlets
+{
+    std::vector<Meshlet> meshlets; //!< the meshlets
+    std::vector<uint32_t> vertices; //!< position index of meshlet vertices
+    std::vector<uint8_t> triangles; //!< three meshlet vertices per triangle
+    std::vector<Point> positions;   //!< vertex positions
+
+    //! \return the number of levels of detail
+    size_t n_levels() const
+    {
+        return meshlets.empty()
+                   ? 0
+                   : meshlets.front().level - meshlets.back().level + 1;
+    }
+
+    //! \brief Write to a compact binary file, one level after the other.
+    //! \throw IOException in case of failure to write the file.
+    void write(const std::filesystem::path& file) const;
+
+    //! \brief Read the \p n_levels coarsest levels from a binary file
+    //! written by write().
+    //! \details Stops reading after these levels, such that coarse levels
+    //! can be loaded first.
+    //! \throw IOException in case of failure to read the file.
+    void read(const std::filesystem::path& file,
+              size_t n_levels = std::numeric_limits<size_t>::max());
+};
+
+//! \brief Partition a triangle mesh into meshlets.
+//! \details Meshlets are grown greedily over adjacent faces, preferring
+//! faces that add few vertices. Each meshlet gets a bounding sphere and a
+//! cone of its face normals for culling.
+//! \param mesh The mesh to partition.
+//! \param max_vertices Maximum number of vertices per meshlet, at most 256.
+//! \param max_triangles Maximum number of triangles per meshlet.
+//! \pre Input mesh needs to be a triangle mesh.
+//! \throw InvalidInputException if the input precondition is violated or if
+//! the limits are out of range.
+//! \ingroup algorithms
+Meshlets meshlets(const SurfaceMesh& mesh, unsigned int max_vertices = 64,
+                  unsigned int max_triangles = 124);
+
+//! \brief Build a hierarchy of meshlets at several levels of detail.
+//! \details Starting from the meshlets of \p mesh, groups of about four
+//! adjacent meshlets are decimated by decimate() with their shared
+//! borders fixed, and the result is split into new meshlets. This is
+//! repeated until a single meshlet is left or decimation stalls. Since
+//! group borders do not change, meshlets of different levels can be mixed
+//! without cracks, see Meshlet::parent_error.
+//! \param mesh The mesh to partition.
+//! \param max_vertices Maximum number of vertices per meshlet, at most 256.
+//! \param max_triangles Maximum number of triangles per meshlet.
+//! \pre Input mesh needs to be a triangle mesh.
+//! \throw InvalidInputException if the input precondition is violated or if
+//! the limits are out of range.
+//! \ingroup algorithms
+Meshlets meshlet_lod(const SurfaceMesh& mesh, unsigned int max_vertices = 64,
+                     unsigned int max_triangles = 124);
+
+} // namespace pmp
@@ -176,6 +176,52 @@ void vertex_normals(SurfaceMesh& mesh)
         vnormal[v] = vertex_normal(mesh, v);
 }
 
+void vertex_normals(SurfaceMesh& mesh, const CornerTable& table)
+{
+    if (table.n_vertices() != mesh.vertices_size() ||
+        table.n_faces() != mesh.faces_size())
+        throw InvalidInputException(
+            "vertex_normals: Corner table does not match the mesh.");
+
+    auto vpoint = mesh.get_vertex_property<Point>("v:point");
+    auto vnormal = mesh.vertex_property<Normal>("v:normal");
+    for (auto v : mesh.vertices())
+        vnormal[v] = Normal(0, 0, 0);
+
+    // add the face normal, weighted by the corner angle, to the vertex of
+    // each corner. the corners of a face are consecutive.
+    const auto nf = static_cast<IndexType>(table.n_faces());
+    for (IndexType f = 0; f < nf; ++f)
+    {
+        Vertex v[3];
+        Point p[3];
+        for (unsigned int i = 0; i < 3; ++i)
+        {
+            v[i] = table.vertex(CornerTable::corner(Face(f), i));
+            p[i] = vpoint[v[i]];
+        }
+        const Normal n = normalize(cross(p[1] - p[0], p[2] - p[0]));
+
+        for (unsigned int i = 0; i < 3; ++i)
+        {
+            const Point p1 = p[(i + 1) % 3] - p[i];
+            const Point p2 = p[(i + 2) % 3] - p[i];
+
+            // check whether we can robustly compute angle
+            const Scalar denom = sqrt(dot(p1, p1) * dot(p2, p2));
+            if (denom > std::numeric_limits<Scalar>::min())
+            {
+                const Scalar angle = acos(
+                    std::clamp(dot(p1, p2) / denom, Scalar(-1), Scalar(1)));
+                vnormal[v[i]] += angle * n;
+            }
+        }
+    }
+
+    for (auto v : mesh.vertices())
+        vnormal[v] = normalize(vnormal[v]);
+}
+
 void face_normals(SurfaceMesh& mesh)
 {
     auto fnormal = mesh.face_property<Normal>("f:normal");
@@ -183,4 +229,43 @@ void face_normals(SurfaceMesh& mesh)
         fnormal[f] = face_normal(mesh, f);
 }
 
+void corner_normals(SurfaceMesh& mesh, Scalar crease_angle)
+{
+    // compute face normals once
+    const size_t nf = mesh.faces_size();
+    std::vector<Normal> fnormals(nf);
+#ifdef _OPENMP
+#pragma omp parallel for
+#endif
+    for (size_t i = 0; i < nf; ++i)
+        if (!mesh.is_deleted(Face(i)))
+            fnormals[i] = face_normal(mesh, Face(i));
+    const auto face_normal_of = [&](Face f) { return fnormals[f.idx()]; };
+
+    // each corner belongs to exactly one vertex, such that vertices can be
+    // processed in parallel
+    auto hnormal = mesh.halfedge_property<Normal>("h:normal");
+    hnormal.detach(); // before writing from several threads
+    const size_t nv = mesh.vertices_size();
+#ifdef _OPENMP
+#pragma omp parallel
+#endif
+    {
+        std::vector<Normal> normals;
+#ifdef _OPENMP
+#pragma omp for
+#endif
+        for (size_t i = 0; i < nv; ++i)
+        {
+            const Vertex v(i);
+            if (mesh.is_deleted(v))
+                continue;
+            fan_normals(mesh, v, crease_angle, face_normal_of, normals);
+            size_t k = 0;
+            for (auto h : mesh.halfedges(v))
+                hnormal[mesh.opposite_halfedge(h)] = normals[k++];
+        }
+    }
+}
+
 } // namespace pmp
@@ -3,6 +3,12 @@
 
 #pragma once
 
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <vector>
+
+#include "pmp/corner_table.h"
 #include "pmp/surface_mesh.h"
 
 namespace pmp {
@@ -14,6 +20,19 @@ namespace pmp {
 //! \ingroup algorithms
 void vertex_normals(SurfaceMesh& mesh);
 
+//! \brief Compute vertex normals for the whole \p mesh using the corner
+//! table \p table of \p mesh.
+//! \details Computes the same angle-weighted normals as vertex_normals(), up
+//! to rounding, and stores them in the vertex property "v:normal". The
+//! normals are accumulated face by face, which reads the compact corner
+//! table instead of the halfedge connectivity and normalizes each face
+//! normal only once.
+//! \pre \p table has to be built from \p mesh, and \p mesh must not have
+//! changed since.
+//! \throw InvalidInputException if \p table does not match \p mesh.
+//! \ingroup algorithms
+void vertex_normals(SurfaceMesh& mesh, const CornerTable& table);
+
 //! \brief Compute face normals for the whole \p mesh.
 //! \details Calls face_normal() for each face and adds a new face
 //! property of type Normal named "f:normal".
@@ -42,4 +61,104 @@ Normal face_normal(const SurfaceMesh& mesh, Face f);
 //! \ingroup algorithms
 Normal corner_normal(const SurfaceMesh& mesh, Halfedge h, Scalar crease_angle);
 
+//! \brief Compute corner normals for the whole \p mesh.
+//! \details Adds a new halfedge property of type Normal named "h:normal"
+//! that holds the normal of the corner at the target vertex of each
+//! halfedge, or a zero normal for boundary halfedges. Face normals are
+//! computed once, and the corners of all vertices are computed in parallel
+//! by fan_normals(). \p crease_angle is in radians, not degrees.
+//! \note This algorithm works on general polygon meshes.
+//! \ingroup algorithms
+void corner_normals(SurfaceMesh& mesh, Scalar crease_angle);
+
+//! \brief Compute the normals of the corners at vertex \p v.
+//! \details The corners are the incoming halfedges opposite to the outgoing
+//! halfedges of \p v in the order of SurfaceMesh::halfedges(v). They are
+//! grouped into smoothing fans, which are separated by boundaries and by
+//! edges whose incident face normals deviate by more than \p crease_angle.
+//! All corners of a fan get the same normal, i.e., the angle-weighted
+//! average of the normals of its faces, such that they can share a vertex
+//! when rendering. Boundary corners get a zero normal.
+//! \param mesh The mesh.
+//! \param v The vertex.
+//! \param crease_angle The crease angle in radians.
+//! \param face_normal Returns the normal of a face, e.g., from precomputed
+//! normals.
+//! \param normals Returns the normal of each corner.
+//! \note This algorithm works on general polygon meshes.
+//! \ingroup algorithms
+template <class FaceNormal>
+void fan_normals(const SurfaceMesh& mesh, Vertex v, Scalar crease_angle,
+                 const FaceNormal& face_normal, std::vector<Normal>& normals)
+{
+    normals.clear();
+    const Point p0 = mesh.position(v);
+
+    // face normals and corner angles, zero angle for boundary corners
+    std::vector<Scalar> angles;
+    for (auto h : mesh.halfedges(v))
+    {
+        const Halfedge hc = mesh.opposite_halfedge(h);
+        if (mesh.is_boundary(hc))
+        {
+            normals.emplace_back(0, 0, 0);
+            angles.push_back(-1);
+            continue;
+        }
+        const Point d1 =
+            mesh.position(mesh.to_vertex(mesh.next_halfedge(hc))) - p0;
+        const Point d2 = mesh.position(mesh.from_vertex(hc)) - p0;
+        const Scalar denom = std::sqrt(dot(d1, d1) * dot(d2, d2));
+        Scalar angle = 0;
+        if (denom > std::numeric_limits<Scalar>::min())
+            angle = std::acos(std::clamp(dot(d1, d2) / denom, Scalar(-1),
+                                         Scalar(1)));
+        normals.push_back(face_normal(mesh.face(hc)));
+        angles.push_back(angle);
+    }
+
+    // corners i and i+1 are on either side of the outgoing halfedge i
+    const size_t n = normals.size();
+    const Scalar cos_crease_angle = std::cos(crease_angle);
+    const auto smooth = [&](size_t i) {
+        const size_t j = (i + 1) % n;
+        return angles[i] >= 0 && angles[j] >= 0 &&
+               dot(normals[i], normals[j]) >= cos_crease_angle;
+    };
+
+    // start at the beginning of a fan, if there is any break
+    size_t start = 0;
+    while (start < n && smooth((start + n - 1) % n))
+        ++start;
+    if (start == n)
+        start = 0;
+
+    // average each fan, single faces keep their exact normal
+    std::vector<Normal> result(n);
+    for (size_t k = 0; k < n;)
+    {
+        const size_t first = k;
+        Normal sum(0, 0, 0);
+        do
+        {
+            const size_t i = (start + k) % n;
+            if (angles[i] > 0)
+                sum += angles[i] * normals[i];
+            ++k;
+        } while (k < n && smooth((start + k - 1) % n));
+
+        for (size_t l = first; l < k; ++l)
+        {
+            const size_t i = (start + l) % n;
+            if (angles[i] < 0)
+                result[i] = Normal(0, 0, 0);
+            else if (k - first == 1)
+                result[i] = normals[i];
+            else
+                result[i] = normalize(sum);
+        }
+    }
+    normals.swap(result);
+}
+
 } // namespace pmp
@@ -2,11 +2,16 @@
 // Distributed under a MIT-style license, see LICENSE.txt for details.
 
 #include "pmp/algorithms/numerics.h"
+#include "pmp/trace.h"
 
 namespace pmp {
 
-DenseMatrix cholesky_solve(const SparseMatrix& A, const DenseMatrix& b)
+DenseMatrix cholesky_solve(const SparseMatrix& A, const DenseMatrix& b,
+                           Progress* progress)
 {
+    PMP_TRACE_SCOPE("cholesky_solve");
+    PMP_TRACE_COUNT("solves", 1);
+
     Eigen::SimplicialLDLT<SparseMatrix> solver;
     solver.compute(A);
     if (solver.info() != Eigen::Success)
@@ -16,6 +21,9 @@ DenseMatrix cholesky_solve(const SparseMatrix& A, const DenseMatrix& b)
         throw SolverException(what);
     }
 
+    if (progress && progress->is_canceled())
+        throw CanceledException(std::string{__func__} + ": Canceled.");
+
     const DenseMatrix x = solver.solve(b);
     if (solver.info() != Eigen::Success)
     {
@@ -29,7 +37,7 @@ DenseMatrix cholesky_solve(const SparseMatrix& A, const DenseMatrix& b)
 DenseMatrix cholesky_solve(
     const SparseMatrix& A, const DenseMatrix& B,
     const std::function<bool(unsigned int)>& is_constrained,
-    const DenseMatrix& C)
+    const DenseMatrix& C, Progress* progress)
 {
     // if nothing is fixed, then use unconstrained solve
     int n_constraints(0);
@@ -37,7 +45,10 @@ DenseMatrix cholesky_solve(
         if (is_constrained(i))
             ++n_constraints;
     if (!n_constraints)
-        return cholesky_solve(A, B);
+        return cholesky_solve(A, B, progress);
+
+    PMP_TRACE_SCOPE("cholesky_solve");
+    PMP_TRACE_COUNT("solves", 1);
 
     // build index map; n is #dofs
     int n = 0;
@@ -89,6 +100,9 @@ DenseMatrix cholesky_solve(
         throw SolverException(what);
     }
 
+    if (progress && progress->is_canceled())
+        throw CanceledException(std::string{__func__} + ": Canceled.");
+
     // solve system
     const DenseMatrix XX = solver.solve(BB);
     if (solver.info() != Eigen::Success)
@@ -3,6 +3,7 @@
 
 #pragma once
 
+#include "pmp/progress.h"
 #include "pmp/surface_mesh.h"
 #include <Eigen/Sparse>
 #include <Eigen/Dense>
@@ -23,7 +24,11 @@ using Triplet = Eigen::Triplet<double>;
 //! \pre The matrix A has to be sparse, symmetric, and positive definite.
 //! \param A The system matrix.
 //! \param B The right hand side.
-DenseMatrix cholesky_solve(const SparseMatrix& A, const DenseMatrix& B);
+//! \param progress Optional cancellation state, polled between factorization
+//! and solve.
+//! \throw CanceledException if \p progress is canceled.
+DenseMatrix cholesky_solve(const SparseMatrix& A, const DenseMatrix& B,
+                           Progress* progress = nullptr);
 
 //! Solve the linear system A*X=B with given hard constraints using sparse Cholesky decomposition.
 //! Returns the solution vector or matrix X.
@@ -32,10 +37,13 @@ DenseMatrix cholesky_solve(const SparseMatrix& A, const DenseMatrix& B);
 //! \param B The right hand side.
 //! \param is_constrained A function returning whether or not X(i) is constrained or not.
 //! \param C A matrix storing the Dirichlet constraints: X(i) should be C(i) is entry i is constrained.
+//! \param progress Optional cancellation state, polled between factorization
+//! and solve.
+//! \throw CanceledException if \p progress is canceled.
 DenseMatrix cholesky_solve(
     const SparseMatrix& A, const DenseMatrix& B,
     const std::function<bool(unsigned int)>& is_constrained,
-    const DenseMatrix& C);
+    const DenseMatrix& C, Progress* progress = nullptr);
 
 //! Constructs a selector matrix for a mesh with N vertices.
 //! Returns a matrix built from the rows of the NxN identity matrix that belong to selected vertices.
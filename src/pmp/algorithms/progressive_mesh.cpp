@@ -0,0 +1,239 @@
+// Copyright 2023 the Polygon Mesh Processing Library developers.
+// Distributed under a MIT-style license, see LICENSE.txt for details.
+
+#include "pmp/algorithms/progressive_mesh.h"
+#include "pmp/io/helpers.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+
+namespace pmp {
+
+ProgressiveMesh::ProgressiveMesh(const SurfaceMesh& mesh,
+                                 const std::vector<Collapse>& collapses)
+{
+    if (mesh.n_vertices() != mesh.vertices_size() ||
+        mesh.n_faces() != mesh.faces_size())
+        throw InvalidInputException(
+            "ProgressiveMesh: Mesh contains deleted elements.");
+
+    if (!mesh.is_triangle_mesh())
+        throw InvalidInputException("ProgressiveMesh: Not a triangle mesh.");
+
+    const auto nv = mesh.n_vertices();
+    if (collapses.size() > nv)
+        throw InvalidInputException("ProgressiveMesh: Too many collapses.");
+
+    // removed vertices are numbered in reverse order of their removal,
+    // the remaining ones keep their relative order
+    std::vector<IndexType> vmap(nv, PMP_MAX_INDEX);
+    for (size_t i = 0; i < collapses.size(); ++i)
+    {
+        const auto v0 = collapses[i].v0;
+        if (v0 >= nv || vmap[v0] != PMP_MAX_INDEX)
+            throw InvalidInputException(
+                "ProgressiveMesh: Invalid collapse sequence.");
+        vmap[v0] = static_cast<IndexType>(nv - 1 - i);
+    }
+    IndexType n_base = 0;
+    for (size_t i = 0; i < nv; ++i)
+        if (vmap[i] == PMP_MAX_INDEX)
+            vmap[i] = n_base++;
+
+    auto map = [&](IndexType v) {
+        return v == PMP_MAX_INDEX ? PMP_MAX_INDEX : vmap[v];
+    };
+
+    positions_.resize(nv);
+    for (auto v : mesh.vertices())
+        positions_[vmap[v.idx()]] = mesh.position(v);
+
+    triangles_.reserve(mesh.n_faces());
+    for (auto f : mesh.faces())
+    {
+        std::array<IndexType, 3> t;
+        size_t i = 0;
+        for (auto v : mesh.vertices(f))
+            t[i++] = vmap[v.idx()];
+        triangles_.push_back(t);
+    }
+
+    collapses_.reserve(collapses.size());
+    for (const auto& c : collapses)
+        collapses_.push_back({map(c.v0), map(c.v1), map(c.vl), map(c.vr)});
+}
+
+SurfaceMesh ProgressiveMesh::extract(size_t n_vertices,
+                                     size_t* n_skipped) const
+{
+    n_vertices = std::clamp(n_vertices, n_base_vertices(), this->n_vertices());
+    std::vector<bool> collapsed(collapses_.size(), false);
+    for (size_t i = 0; i < this->n_vertices() - n_vertices; ++i)
+        collapsed[i] = true;
+    return apply_collapses(collapsed, n_skipped);
+}
+
+SurfaceMesh ProgressiveMesh::extract(
+    const std::function<bool(const Collapse&)>& refine, size_t* n_skipped) const
+{
+    std::vector<bool> present(n_vertices(), false);
+    std::fill(present.begin(), present.begin() + n_base_vertices(), true);
+    auto is_present = [&](IndexType v) {
+        return v == PMP_MAX_INDEX || present[v];
+    };
+
+    // undo collapses from coarse to fine
+    std::vector<bool> collapsed(collapses_.size(), true);
+    for (size_t i = collapses_.size(); i-- > 0;)
+    {
+        const auto& c = collapses_[i];
+        if (is_present(c.v1) && is_present(c.vl) && is_present(c.vr) &&
+            refine(c))
+        {
+            collapsed[i] = false;
+            present[c.v0] = true;
+        }
+    }
+
+    return apply_collapses(collapsed, n_skipped);
+}
+
+SurfaceMesh ProgressiveMesh::apply_collapses(const std::vector<bool>& collapsed,
+                                             size_t* n_skipped) const
+{
+    // find the vertex each vertex has been collapsed into. the remaining
+    // vertex of a collapse is removed by a later collapse, if at all.
+    std::vector<IndexType> target(n_vertices());
+    for (size_t i = 0; i < target.size(); ++i)
+        target[i] = static_cast<IndexType>(i);
+    for (size_t i = collapses_.size(); i-- > 0;)
+    {
+        const auto& c = collapses_[i];
+        if (collapsed[i])
+            target[c.v0] = target[c.v1];
+    }
+
+    SurfaceMesh mesh;
+    size_t skipped = 0;
+    std::vector<Vertex> vertices(n_vertices());
+    for (size_t i = 0; i < n_vertices(); ++i)
+        if (target[i] == i)
+            vertices[i] = mesh.add_vertex(positions_[i]);
+
+    for (const auto& t : triangles_)
+    {
+        const auto v0 = target[t[0]];
+        const auto v1 = target[t[1]];
+        const auto v2 = target[t[2]];
+        if (v0 == v1 || v1 == v2 || v2 == v0)
+            continue;
+
+        try
+        {
+            mesh.add_triangle(vertices[v0], vertices[v1], vertices[v2]);
+        }
+        catch (const TopologyException&)
+        {
+            // triangles of inconsistent selective refinements
+            ++skipped;
+        }
+    }
+
+    if (n_skipped)
+        *n_skipped = skipped;
+    return mesh;
+}
+
+void ProgressiveMesh::write(const std::filesystem::path& file) const
+{
+    FILE* out = fopen(file.string().c_str(), "wb");
+    if (!out)
+        throw IOException("Failed to open file: " + file.string());
+
+    // header
+    fwrite("PMPPM", 1, 5, out);
+    tfwrite(out, positions_.size());
+    tfwrite(out, triangles_.size());
+    tfwrite(out, collapses_.size());
+
+    // data, the removed vertex of each collapse is implicit
+    fwrite(positions_.data(), sizeof(Point), positions_.size(), out);
+    fwrite(triangles_.data(), sizeof(IndexType), 3 * triangles_.size(), out);
+    for (const auto& c : collapses_)
+    {
+        tfwrite(out, c.v1);
+        tfwrite(out, c.vl);
+        tfwrite(out, c.vr);
+    }
+
+    const bool failed = ferror(out);
+    fclose(out);
+    if (failed)
+        throw IOException("Failed to write file: " + file.string());
+}
+
+void ProgressiveMesh::read(const std::filesystem::path& file)
+{
+    FILE* in = fopen(file.string().c_str(), "rb");
+    if (!in)
+        throw IOException("Failed to open file: " + file.string());
+
+    char magic[5];
+    size_t nv{0}, nt{0}, nc{0};
+    bool ok = fread(magic, 1, 5, in) == 5 && !strncmp(magic, "PMPPM", 5);
+    ok = ok && fread(&nv, sizeof(nv), 1, in) == 1;
+    ok = ok && fread(&nt, sizeof(nt), 1, in) == 1;
+    ok = ok && fread(&nc, sizeof(nc), 1, in) == 1;
+    ok = ok && nc <= nv;
+
+    // bound the counts by the file size before allocating
+    auto remaining = ok ? remaining_bytes(in) : 0;
+    auto fits = [&remaining](size_t count, size_t size) {
+        if (count > remaining / size)
+            return false;
+        remaining -= count * size;
+        return true;
+    };
+    ok = ok && fits(nv, sizeof(Point)) && fits(nt, 3 * sizeof(IndexType)) &&
+         fits(nc, 3 * sizeof(IndexType));
+
+    if (ok)
+    {
+        positions_.resize(nv);
+        triangles_.resize(nt);
+        collapses_.resize(nc);
+        ok = fread(positions_.data(), sizeof(Point), nv, in) == nv &&
+             fread(triangles_.data(), sizeof(IndexType), 3 * nt, in) == 3 * nt;
+        for (size_t i = 0; ok && i < nc; ++i)
+        {
+            auto& c = collapses_[i];
+            c.v0 = static_cast<IndexType>(nv - 1 - i);
+            ok = fread(&c.v1, sizeof(IndexType), 1, in) == 1 &&
+                 fread(&c.vl, sizeof(IndexType), 1, in) == 1 &&
+                 fread(&c.vr, sizeof(IndexType), 1, in) == 1;
+        }
+    }
+    fclose(in);
+
+    // check indices, the vertices of a collapse are present before it
+    for (size_t i = 0; ok && i < nt; ++i)
+        for (auto v : triangles_[i])
+            ok = ok && v < nv;
+    for (size_t i = 0; ok && i < nc; ++i)
+    {
+        const auto& c = collapses_[i];
+        ok = c.v1 < c.v0 && (c.vl < c.v0 || c.vl == PMP_MAX_INDEX) &&
+             (c.vr < c.v0 || c.vr == PMP_MAX_INDEX);
+    }
+
+    if (!ok)
+    {
+        positions_.clear();
+        triangles_.clear();
+        collapses_.clear();
+        throw IOException("Failed to read file: " + file.string());
+    }
+}
+
+} // namespace pmp
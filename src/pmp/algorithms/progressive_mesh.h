@@ -0,0 +1,105 @@
+// Copyright 2023 the Polygon Mesh Processing Library developers.
+// Distributed under a MIT-style license, see LICENSE.txt for details.
+
+#pragma once
+
+#include <array>
+#include <filesystem>
+#include <functional>
+#include <vector>
+
+#include "pmp/surface_mesh.h"
+
+namespace pmp {
+
+//! \brief A progressive triangle mesh.
+//! \details Stores a sequence of halfedge collapses, as recorded by
+//! progressive_mesh(), together with the original mesh. Vertices are
+//! numbered such that the mesh with \c n vertices consists of vertices
+//! \c 0 to \c n-1, and the i-th collapse removes vertex
+//! <tt>n_vertices()-1-i</tt>. Any level of detail can therefore be
+//! extracted in linear time without repeating the decimation.
+//! \ingroup algorithms
+class ProgressiveMesh
+{
+public:
+    //! \brief Collapse of vertex \c v0 into vertex \c v1.
+    //! \details \c vl and \c vr are the opposite vertices of the left and
+    //! right triangle removed by the collapse, or \c PMP_MAX_INDEX at the
+    //! boundary. Undoing a collapse is the corresponding vertex split.
+    struct Collapse
+    {
+        IndexType v0; //!< removed vertex
+        IndexType v1; //!< remaining vertex
+        IndexType vl; //!< left vertex
+        IndexType vr; //!< right vertex
+    };
+
+    //! Construct an empty progressive mesh.
+    ProgressiveMesh() = default;
+
+    //! \brief Construct from a mesh and a sequence of collapses on it.
+    //! \details The collapses are given in the order they are applied and
+    //! reference the vertex indices of \p mesh.
+    //! \throw InvalidInputException if \p mesh is not a triangle mesh or
+    //! contains deleted elements.
+    ProgressiveMesh(const SurfaceMesh& mesh,
+                    const std::vector<Collapse>& collapses);
+
+    //! \return the number of vertices of the finest mesh
+    size_t n_vertices() const { return positions_.size(); }
+
+    //! \return the number of vertices of the coarsest mesh
+    size_t n_base_vertices() const
+    {
+        return positions_.size() - collapses_.size();
+    }
+
+    //! \return the number of recorded collapses
+    size_t n_collapses() const { return collapses_.size(); }
+
+    //! \return the i-th collapse
+    const Collapse& collapse(size_t i) const { return collapses_[i]; }
+
+    //! \return the position of vertex \p v
+    const Point& position(IndexType v) const { return positions_[v]; }
+
+    //! \brief Extract the mesh with \p n_vertices vertices.
+    //! \details \p n_vertices is clamped to the range
+    //! [n_base_vertices(), n_vertices()]. Triangles that would result in
+    //! non-manifold configurations are skipped, which only happens if the
+    //! collapses were not recorded on a manifold mesh. Their number is
+    //! stored in \p n_skipped, if given.
+    SurfaceMesh extract(size_t n_vertices, size_t* n_skipped = nullptr) const;
+
+    //! \brief View-dependent extraction.
+    //! \details Starting from the coarsest mesh, a collapse is undone if
+    //! \p refine returns true for it and all of its vertices \c v1, \c vl,
+    //! and \c vr are present. This allows to refine the mesh selectively,
+    //! e.g., close to the viewer or inside the view frustum. Refinements
+    //! that do not follow the recorded order can lead to non-manifold
+    //! configurations. The triangles causing them are skipped, leaving holes
+    //! in the mesh, and their number is stored in \p n_skipped, if given.
+    SurfaceMesh extract(const std::function<bool(const Collapse&)>& refine,
+                        size_t* n_skipped = nullptr) const;
+
+    //! \brief Write to a compact binary file.
+    //! \throw IOException in case of failure to write the file.
+    void write(const std::filesystem::path& file) const;
+
+    //! \brief Read from a binary file written by write().
+    //! \throw IOException in case of failure to read the file.
+    void read(const std::filesystem::path& file);
+
+private:
+    // build the mesh obtained by applying the collapses marked in collapsed,
+    // counting the skipped non-manifold triangles in n_skipped, if given
+    SurfaceMesh apply_collapses(const std::vector<bool>& collapsed,
+                                size_t* n_skipped) const;
+
+    std::vector<Point> positions_;
+    std::vector<std::array<IndexType, 3>> triangles_;
+    std::vector<Collapse> collapses_;
+};
+
+} // namespace pmp
@@ -15,6 +15,7 @@
 #include "pmp/algorithms/differential_geometry.h"
 #include "pmp/algorithms/distance_point_triangle.h"
 #include "pmp/bounding_box.h"
+#include "pmp/trace.h"
 
 namespace pmp {
 namespace {
@@ -249,7 +250,7 @@ void TriangleKdTree::nearest_recurse(Node* node, const Point& point,
 class Remeshing
 {
 public:
-    Remeshing(SurfaceMesh& mesh);
+    Remeshing(SurfaceMesh& mesh, Progress* progress = nullptr);
 
     void uniform_remeshing(Scalar edge_length, unsigned int iterations = 10,
                            bool use_projection = true);
@@ -262,6 +263,15 @@ private:
     void preprocessing();
     void postprocessing();
 
+    // perform remeshing iterations, false if canceled
+    bool remesh(unsigned int iterations);
+
+    // report progress, true if canceled
+    bool canceled(float fraction)
+    {
+        return progress_ && !progress_->checkpoint(fraction);
+    }
+
     void split_long_edges();
     void collapse_short_edges();
     void flip_edges();
@@ -285,6 +295,7 @@ private:
     }
 
     SurfaceMesh& mesh_;
+    Progress* progress_;
     std::shared_ptr<SurfaceMesh> refmesh_;
 
     bool use_projection_;
@@ -311,8 +322,8 @@ private:
     VertexProperty<Scalar> refsizing_;
 };
 
-Remeshing::Remeshing(SurfaceMesh& mesh)
-    : mesh_(mesh), refmesh_(nullptr), kd_tree_(nullptr)
+Remeshing::Remeshing(SurfaceMesh& mesh, Progress* progress)
+    : mesh_(mesh), progress_(progress), refmesh_(nullptr), kd_tree_(nullptr)
 {
     if (!mesh_.is_triangle_mesh())
         throw InvalidInputException("Input is not a triangle mesh!");
@@ -329,34 +340,30 @@ Remeshing::Remeshing(SurfaceMesh& mesh)
 void Remeshing::uniform_remeshing(Scalar edge_length, unsigned int iterations,
                                   bool use_projection)
 {
+    PMP_TRACE_SCOPE("uniform_remeshing");
+
     uniform_ = true;
     use_projection_ = use_projection;
     target_edge_length_ = edge_length;
 
     preprocessing();
 
-    for (unsigned int i = 0; i < iterations; ++i)
-    {
-        split_long_edges();
-
-        vertex_normals(mesh_);
-
-        collapse_short_edges();
-
-        flip_edges();
-
-        tangential_smoothing(5);
-    }
-
-    remove_caps();
+    const bool completed = remesh(iterations);
+    if (completed)
+        remove_caps();
 
     postprocessing();
+
+    if (!completed)
+        throw CanceledException(std::string{__func__} + ": Canceled.");
 }
 
 void Remeshing::adaptive_remeshing(Scalar min_edge_length,
                                    Scalar max_edge_length, Scalar approx_error,
                                    unsigned int iterations, bool use_projection)
 {
+    PMP_TRACE_SCOPE("adaptive_remeshing");
+
     uniform_ = false;
     min_edge_length_ = min_edge_length;
     max_edge_length_ = max_edge_length;
@@ -365,26 +372,50 @@ void Remeshing::adaptive_remeshing(Scalar min_edge_length,
 
     preprocessing();
 
+    const bool completed = remesh(iterations);
+    if (completed)
+        remove_caps();
+
+    postprocessing();
+
+    if (!completed)
+        throw CanceledException(std::string{__func__} + ": Canceled.");
+}
+
+bool Remeshing::remesh(unsigned int iterations)
+{
+    // the mesh is valid between the steps of each iteration
     for (unsigned int i = 0; i < iterations; ++i)
     {
+        if (canceled(float(i) / iterations))
+            return false;
+
         split_long_edges();
 
         vertex_normals(mesh_);
 
+        if (canceled((i + 0.25f) / iterations))
+            return false;
+
         collapse_short_edges();
 
+        if (canceled((i + 0.5f) / iterations))
+            return false;
+
         flip_edges();
 
+        if (canceled((i + 0.75f) / iterations))
+            return false;
+
         tangential_smoothing(5);
     }
-
-    remove_caps();
-
-    postprocessing();
+    return !canceled(1.0f);
 }
 
 void Remeshing::preprocessing()
 {
+    PMP_TRACE_SCOPE("preprocessing");
+
     // properties
     vfeature_ = mesh_.vertex_property<bool>("v:feature", false);
     efeature_ = mesh_.edge_property<bool>("e:feature", false);
@@ -566,6 +597,7 @@ void Remeshing::preprocessing()
         }
 
         // build kd-tree
+        PMP_TRACE_SCOPE("kd_tree");
         kd_tree_ = std::make_unique<TriangleKdTree>(refmesh_, 0);
     }
 }
@@ -638,6 +670,9 @@ void Remeshing::project_to_reference(Vertex v)
 
 void Remeshing::split_long_edges()
 {
+    PMP_TRACE_SCOPE("split_long_edges");
+
+    size_t n_splits = 0;
     Vertex vnew, v0, v1;
     Edge enew, e0, e1;
     Face f0, f1, f2, f3;
@@ -663,6 +698,7 @@ void Remeshing::split_long_edges()
 
                 vnew = mesh_.add_vertex((p0 + p1) * 0.5f);
                 mesh_.split(e, vnew);
+                ++n_splits;
 
                 // need normal or sizing for adaptive refinement
                 vnormal_[vnew] = vertex_normal(mesh_, vnew);
@@ -684,6 +720,8 @@ void Remeshing::split_long_edges()
             }
         }
     }
+
+    PMP_TRACE_COUNT("splits", n_splits);
 }
 
 void Remeshing::collapse_short_edges()
@@ -693,6 +731,9 @@ void Remeshing::collapse_short_edges()
     bool ok, b0, b1, l0, l1, f0, f1;
     int i;
     bool hcol01, hcol10;
+    size_t n_collapses = 0;
+
+    PMP_TRACE_SCOPE("collapse_short_edges");
 
     for (ok = false, i = 0; !ok && i < 10; ++i)
     {
@@ -795,6 +836,7 @@ void Remeshing::collapse_short_edges()
                         if (hcol10)
                         {
                             mesh_.collapse(h10);
+                            ++n_collapses;
                             ok = false;
                         }
                     }
@@ -815,6 +857,7 @@ void Remeshing::collapse_short_edges()
                         if (hcol01)
                         {
                             mesh_.collapse(h01);
+                            ++n_collapses;
                             ok = false;
                         }
                     }
@@ -824,10 +867,15 @@ void Remeshing::collapse_short_edges()
     }
 
     mesh_.garbage_collection();
+
+    PMP_TRACE_COUNT("collapses", n_collapses);
 }
 
 void Remeshing::flip_edges()
 {
+    PMP_TRACE_SCOPE("flip_edges");
+
+    size_t n_flips = 0;
     Vertex v0, v1, v2, v3;
     Halfedge h;
     int val0, val1, val2, val3;
@@ -903,6 +951,7 @@ void Remeshing::flip_edges()
                     if (ve_before > ve_after && mesh_.is_flip_ok(e))
                     {
                         mesh_.flip(e);
+                        ++n_flips;
                         --valence[v0];
                         --valence[v1];
                         ++valence[v2];
@@ -915,10 +964,14 @@ void Remeshing::flip_edges()
     }
 
     mesh_.remove_vertex_property(valence);
+
+    PMP_TRACE_COUNT("flips", n_flips);
 }
 
 void Remeshing::tangential_smoothing(unsigned int iterations)
 {
+    PMP_TRACE_SCOPE("tangential_smoothing");
+
     Vertex v1, v2, v3, vv;
     Edge e;
     Scalar w, ww;
@@ -931,6 +984,7 @@ void Remeshing::tangential_smoothing(unsigned int iterations)
     // for vertices introduced by splitting
     if (use_projection_)
     {
+        PMP_TRACE_SCOPE("projection");
         for (auto v : mesh_.vertices())
         {
             if (!mesh_.is_boundary(v) && !vlocked_[v])
@@ -1027,6 +1081,7 @@ void Remeshing::tangential_smoothing(unsigned int iterations)
     // project at the end
     if (use_projection_)
     {
+        PMP_TRACE_SCOPE("projection");
         for (auto v : mesh_.vertices())
         {
             if (!mesh_.is_boundary(v) && !vlocked_[v])
@@ -1042,6 +1097,8 @@ void Remeshing::tangential_smoothing(unsigned int iterations)
 
 void Remeshing::remove_caps()
 {
+    PMP_TRACE_SCOPE("remove_caps");
+
     Halfedge h;
     Vertex v, vb, vd;
     Face fb, fd;
@@ -1179,18 +1236,21 @@ Point Remeshing::weighted_centroid(Vertex v)
 } // namespace
 
 void uniform_remeshing(SurfaceMesh& mesh, Scalar edge_length,
-                       unsigned int iterations, bool use_projection)
+                       unsigned int iterations, bool use_projection,
+                       Progress* progress)
 {
-    Remeshing(mesh).uniform_remeshing(edge_length, iterations, use_projection);
+    Remeshing(mesh, progress)
+        .uniform_remeshing(edge_length, iterations, use_projection);
 }
 
 void adaptive_remeshing(SurfaceMesh& mesh, Scalar min_edge_length,
                         Scalar max_edge_length, Scalar approx_error,
-                        unsigned int iterations, bool use_projection)
+                        unsigned int iterations, bool use_projection,
+                        Progress* progress)
 {
-    Remeshing(mesh).adaptive_remeshing(min_edge_length, max_edge_length,
-                                       approx_error, iterations,
-                                       use_projection);
+    Remeshing(mesh, progress)
+        .adaptive_remeshing(min_edge_length, max_edge_length, approx_error,
+                            iterations, use_projection);
 }
 
 } // namespace pmp
@@ -3,6 +3,7 @@
 
 #pragma once
 
+#include "pmp/progress.h"
 #include "pmp/surface_mesh.h"
 
 namespace pmp {
@@ -15,12 +16,15 @@ namespace pmp {
 //! \param edge_length The target edge length.
 //! \param iterations The number of iterations
 //! \param use_projection Use back-projection to the input surface.
+//! \param progress Optional progress and cancellation state, polled between
+//! the steps of each iteration.
 //! \pre Input mesh needs to be a triangle mesh.
 //! \throw InvalidInputException if the input precondition is violated.
+//! \throw CanceledException if \p progress is canceled.
 //! \ingroup algorithms
 void uniform_remeshing(SurfaceMesh& mesh, Scalar edge_length,
-                       unsigned int iterations = 10,
-                       bool use_projection = true);
+                       unsigned int iterations = 10, bool use_projection = true,
+                       Progress* progress = nullptr);
 
 //! \brief Perform adaptive remeshing.
 //! \details Performs incremental remeshing based
@@ -32,12 +36,16 @@ void uniform_remeshing(SurfaceMesh& mesh, Scalar edge_length,
 //! \param approx_error The maximum approximation error.
 //! \param iterations The number of iterations.
 //! \param use_projection Use back-projection to the input surface.
+//! \param progress Optional progress and cancellation state, polled between
+//! the steps of each iteration.
 //! \pre Input mesh needs to be a triangle mesh.
 //! \throw InvalidInputException if the input precondition is violated.
+//! \throw CanceledException if \p progress is canceled.
 //! \ingroup algorithms
 void adaptive_remeshing(SurfaceMesh& mesh, Scalar min_edge_length,
                         Scalar max_edge_length, Scalar approx_error,
                         unsigned int iterations = 10,
-                        bool use_projection = true);
+                        bool use_projection = true,
+                        Progress* progress = nullptr);
 
 } // namespace pmp
@@ -0,0 +1,465 @@
+// Copyright 2023 the Polygon Mesh Processing Library developers.
+// Distributed under a MIT-style license, see LICENSE.txt for details.
+
+#include "pmp/algorithms/render_buffers.h"
+#include "pmp/algorithms/normals.h"
+#include "pmp/algorithms/vertex_cache.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace pmp {
+namespace {
+
+// attributes of a corner, corners with equal attributes are merged
+struct CornerAttributes
+{
+    vec3 normal;
+    vec2 texcoord;
+    vec3 color;
+
+    bool operator==(const CornerAttributes& other) const
+    {
+        return normal == other.normal && texcoord == other.texcoord &&
+               color == other.color;
+    }
+};
+
+// squared area of a triangle
+Scalar area(const vec3& p0, const vec3& p1, const vec3& p2)
+{
+    return sqrnorm(cross(p1 - p0, p2 - p0));
+}
+
+// Triangulate a polygon such that the sum of squared triangle areas is
+// minimized. This prevents overlapping/folding triangles for non-convex
+// polygons.
+void tessellate(const std::vector<vec3>& points, std::vector<ivec3>& triangles)
+{
+    const int n = static_cast<int>(points.size());
+
+    triangles.clear();
+    triangles.reserve(n - 2);
+
+    // triangle? nothing to do
+    if (n == 3)
+    {
+        triangles.emplace_back(0, 1, 2);
+        return;
+    }
+
+    // quad? simply compare to two options
+    if (n == 4)
+    {
+        if (area(points[0], points[1], points[2]) +
+                area(points[0], points[2], points[3]) <
+            area(points[0], points[1], points[3]) +
+                area(points[1], points[2], points[3]))
+        {
+            triangles.emplace_back(0, 1, 2);
+            triangles.emplace_back(0, 2, 3);
+        }
+        else
+        {
+            triangles.emplace_back(0, 1, 3);
+            triangles.emplace_back(1, 2, 3);
+        }
+        return;
+    }
+
+    // n-gon with n>4? compute triangulation by dynamic programming over
+    // the sub-polygons [i,k], storing their area and best split
+    std::vector<Scalar> weight(n * n, std::numeric_limits<Scalar>::max());
+    std::vector<int> split(n * n, -1);
+    for (int i = 0; i < n - 1; ++i)
+        weight[i * n + i + 1] = 0.0;
+
+    for (int j = 2; j < n; ++j)
+    {
+        for (int i = 0; i < n - j; ++i)
+        {
+            const int k = i + j;
+            for (int m = i + 1; m < k; ++m)
+            {
+                const Scalar w = weight[i * n + m] +
+                                 area(points[i], points[m], points[k]) +
+                                 weight[m * n + k];
+                if (w < weight[i * n + k])
+                {
+                    weight[i * n + k] = w;
+                    split[i * n + k] = m;
+                }
+            }
+        }
+    }
+
+    // build triangles from triangulation table
+    std::vector<ivec2> todo;
+    todo.reserve(n);
+    todo.emplace_back(0, n - 1);
+    while (!todo.empty())
+    {
+        const ivec2 range = todo.back();
+        todo.pop_back();
+        const int start = range[0];
+        const int end = range[1];
+        if (end - start < 2)
+            continue;
+        const int m = split[start * n + end];
+
+        triangles.emplace_back(start, m, end);
+        todo.emplace_back(start, m);
+        todo.emplace_back(m, end);
+    }
+}
+
+// Normals of the corners at v in the order of mesh.halfedges(v), see
+// fan_normals(). Crease angles below one degree result in face normals,
+// above 170 degrees in vertex normals.
+template <class FaceNormal>
+void vertex_corner_normals(const SurfaceMesh& mesh, Vertex v,
+                           Scalar crease_angle, const FaceNormal& face_normal,
+                           std::vector<Normal>& normals)
+{
+    if (crease_angle < 1)
+    {
+        normals.clear();
+        for (auto h : mesh.halfedges(v))
+        {
+            const Halfedge hc = mesh.opposite_halfedge(h);
+            normals.push_back(mesh.is_boundary(hc) ? Normal(0, 0, 0)
+                                                   : face_normal(mesh.face(hc)));
+        }
+        return;
+    }
+    const Scalar angle =
+        crease_angle > 170 ? Scalar(M_PI) : crease_angle / 180 * Scalar(M_PI);
+    fan_normals(mesh, v, angle, face_normal, normals);
+}
+
+// computes the corners at a vertex and their attributes
+class CornerBuilder
+{
+public:
+    CornerBuilder(const SurfaceMesh& mesh, bool use_colors)
+        : mesh_(mesh),
+          vtex_(mesh.get_vertex_property<TexCoord>("v:tex")),
+          htex_(mesh.get_halfedge_property<TexCoord>("h:tex")),
+          vcolor_(mesh.get_vertex_property<Color>("v:color")),
+          fcolor_(mesh.get_face_property<Color>("f:color")),
+          use_colors_((vcolor_ || fcolor_) && use_colors)
+    {
+    }
+
+    bool has_texcoords() const { return htex_ || vtex_; }
+    bool has_colors() const { return use_colors_; }
+
+    // Collect the corners at v, i.e., the incoming halfedges with faces, and
+    // compute their attributes, given the normals computed by
+    // vertex_corner_normals().
+    void build(Vertex v, const std::vector<Normal>& normals)
+    {
+        corners.clear();
+        attributes.clear();
+        size_t i = 0;
+        for (auto h : mesh_.halfedges(v))
+        {
+            const Halfedge hc = mesh_.opposite_halfedge(h);
+            const Normal& n = normals[i++];
+            if (mesh_.is_boundary(hc))
+                continue;
+            const Face f = mesh_.face(hc);
+            corners.push_back(hc);
+
+            CornerAttributes a;
+            a.normal = vec3(n);
+            a.texcoord = htex_   ? vec2(htex_[hc])
+                         : vtex_ ? vec2(vtex_[v])
+                                 : vec2(0, 0);
+            a.color = !use_colors_ ? vec3(0, 0, 0)
+                      : vcolor_    ? vec3(vcolor_[v])
+                                   : vec3(fcolor_[f]);
+            attributes.push_back(a);
+        }
+    }
+
+    std::vector<Halfedge> corners;
+    std::vector<CornerAttributes> attributes;
+
+private:
+    const SurfaceMesh& mesh_;
+    VertexProperty<TexCoord> vtex_;
+    HalfedgeProperty<TexCoord> htex_;
+    VertexProperty<Color> vcolor_;
+    FaceProperty<Color> fcolor_;
+    bool use_colors_;
+};
+
+void point_cloud_buffers(const SurfaceMesh& mesh, bool use_colors,
+                         RenderBuffers& buffers)
+{
+    auto normals = mesh.get_vertex_property<Normal>("v:normal");
+    auto vcolor = mesh.get_vertex_property<Color>("v:color");
+
+    for (auto v : mesh.vertices())
+    {
+        buffers.positions.push_back(vec3(mesh.position(v)));
+        if (normals)
+            buffers.normals.push_back(vec3(normals[v]));
+        if (vcolor && use_colors)
+            buffers.colors.push_back(vec3(vcolor[v]));
+        buffers.vertices.push_back(v);
+    }
+}
+
+// update the buffer vertices of the corners at the given vertices
+bool update_corners(const SurfaceMesh& mesh, RenderBuffers& buffers,
+                    std::vector<Vertex>& vertices,
+                    std::vector<unsigned int>& updated)
+{
+    std::sort(vertices.begin(), vertices.end());
+    vertices.erase(std::unique(vertices.begin(), vertices.end()),
+                   vertices.end());
+
+    // point clouds have one buffer vertex per vertex
+    if (buffers.corners.empty())
+    {
+        auto normals = mesh.get_vertex_property<Normal>("v:normal");
+        auto vcolor = mesh.get_vertex_property<Color>("v:color");
+        for (auto v : vertices)
+        {
+            const auto idx = v.idx();
+            if (idx >= buffers.vertices.size() || buffers.vertices[idx] != v)
+                return false;
+            buffers.positions[idx] = vec3(mesh.position(v));
+            if (normals && !buffers.normals.empty())
+                buffers.normals[idx] = vec3(normals[v]);
+            if (vcolor && !buffers.colors.empty())
+                buffers.colors[idx] = vec3(vcolor[v]);
+            updated.push_back(idx);
+        }
+        return true;
+    }
+
+    CornerBuilder builder(mesh, buffers.use_colors);
+    if (builder.has_texcoords() != !buffers.texcoords.empty() ||
+        builder.has_colors() != !buffers.colors.empty())
+        return false;
+
+    const auto face_normal_of = [&](Face f) { return face_normal(mesh, f); };
+    std::vector<Normal> normals;
+    for (auto v : vertices)
+    {
+        vertex_corner_normals(mesh, v, buffers.crease_angle, face_normal_of,
+                              normals);
+        builder.build(v, normals);
+        const auto& corners = builder.corners;
+        const auto& attributes = builder.attributes;
+        const size_t n = corners.size();
+        for (size_t i = 0; i < n; ++i)
+        {
+            const auto idx = buffers.corners[corners[i].idx()];
+            if (idx == RenderBuffers::invalid_index)
+                return false;
+
+            // the corners of a fan share a buffer vertex and have to remain
+            // equal, a new crease or seam requires a new buffer vertex
+            const size_t j = (i + n - 1) % n;
+            if (buffers.corners[corners[j].idx()] == idx &&
+                !(attributes[j] == attributes[i]))
+                return false;
+
+            buffers.positions[idx] = vec3(mesh.position(v));
+            buffers.normals[idx] = attributes[i].normal;
+            if (builder.has_texcoords())
+                buffers.texcoords[idx] = attributes[i].texcoord;
+            if (builder.has_colors())
+                buffers.colors[idx] = attributes[i].color;
+            updated.push_back(idx);
+        }
+    }
+
+    std::sort(updated.begin(), updated.end());
+    updated.erase(std::unique(updated.begin(), updated.end()), updated.end());
+    return true;
+}
+
+} // namespace
+
+RenderBuffers render_buffers(const SurfaceMesh& mesh, Scalar crease_angle,
+                             bool use_colors)
+{
+    RenderBuffers buffers;
+    buffers.crease_angle = crease_angle;
+    buffers.use_colors = use_colors;
+    if (mesh.n_faces() == 0)
+    {
+        point_cloud_buffers(mesh, use_colors, buffers);
+        return buffers;
+    }
+
+    // face normals are needed for all crease angles
+    const size_t nf = mesh.faces_size();
+    std::vector<Normal> face_normals(nf);
+#ifdef _OPENMP
+#pragma omp parallel for
+#endif
+    for (size_t i = 0; i < nf; ++i)
+        if (!mesh.is_deleted(Face(i)))
+            face_normals[i] = face_normal(mesh, Face(i));
+    const auto face_normal_of = [&](Face f) { return face_normals[f.idx()]; };
+
+    // corner normals of all vertices in parallel, in the order of their
+    // outgoing halfedges
+    const size_t nv = mesh.vertices_size();
+    std::vector<Normal> hnormals(mesh.halfedges_size());
+#ifdef _OPENMP
+#pragma omp parallel
+#endif
+    {
+        std::vector<Normal> normals;
+#ifdef _OPENMP
+#pragma omp for
+#endif
+        for (size_t i = 0; i < nv; ++i)
+        {
+            const Vertex v(i);
+            if (mesh.is_deleted(v))
+                continue;
+            vertex_corner_normals(mesh, v, crease_angle, face_normal_of,
+                                  normals);
+            size_t k = 0;
+            for (auto h : mesh.halfedges(v))
+                hnormals[h.idx()] = normals[k++];
+        }
+    }
+
+    CornerBuilder builder(mesh, use_colors);
+    std::vector<Normal> normals;
+    buffers.corners.assign(mesh.halfedges_size(), RenderBuffers::invalid_index);
+
+    // one representative buffer vertex per mesh vertex, used for edges
+    std::vector<unsigned int> vertex_index(mesh.vertices_size(),
+                                           RenderBuffers::invalid_index);
+
+    for (auto v : mesh.vertices())
+    {
+        normals.clear();
+        for (auto h : mesh.halfedges(v))
+            normals.push_back(hnormals[h.idx()]);
+        builder.build(v, normals);
+        const auto& corners = builder.corners;
+        const auto& attributes = builder.attributes;
+
+        // merge the corners of each fan, i.e., consecutive corners with equal
+        // attributes. start at the beginning of a fan, such that a fan
+        // wrapping around the vertex is merged, too.
+        const size_t n = corners.size();
+        const auto continues_fan = [&](size_t i) {
+            return attributes[i] == attributes[(i + n - 1) % n];
+        };
+        size_t start = 0;
+        while (start < n && continues_fan(start))
+            ++start;
+        if (start == n)
+            start = 0;
+
+        unsigned int idx = RenderBuffers::invalid_index;
+        for (size_t k = 0; k < n; ++k)
+        {
+            const size_t i = (start + k) % n;
+            if (k == 0 || !continues_fan(i))
+            {
+                idx = static_cast<unsigned int>(buffers.positions.size());
+                buffers.positions.push_back(vec3(mesh.position(v)));
+                buffers.normals.push_back(attributes[i].normal);
+                if (builder.has_texcoords())
+                    buffers.texcoords.push_back(attributes[i].texcoord);
+                if (builder.has_colors())
+                    buffers.colors.push_back(attributes[i].color);
+                buffers.vertices.push_back(v);
+            }
+            buffers.corners[corners[i].idx()] = idx;
+        }
+
+        if (!corners.empty())
+            vertex_index[v.idx()] = buffers.corners[corners[0].idx()];
+    }
+
+    // tessellate faces into triangles
+    std::vector<Halfedge> face_corners;
+    std::vector<vec3> points;
+    std::vector<ivec3> triangles;
+    buffers.triangles.reserve(3 * mesh.n_faces());
+    for (auto f : mesh.faces())
+    {
+        face_corners.clear();
+        points.clear();
+        for (auto h : mesh.halfedges(f))
+        {
+            face_corners.push_back(h);
+            points.push_back(vec3(mesh.position(mesh.to_vertex(h))));
+        }
+
+        tessellate(points, triangles);
+        for (const auto& t : triangles)
+            for (int k = 0; k < 3; ++k)
+                buffers.triangles.push_back(
+                    buffers.corners[face_corners[t[k]].idx()]);
+    }
+    optimize_vertex_cache(buffers.triangles, buffers.positions.size());
+
+    // edges and feature edges, using any corner of their vertices
+    auto efeature = mesh.get_edge_property<bool>("e:feature");
+    buffers.edges.reserve(2 * mesh.n_edges());
+    for (auto e : mesh.edges())
+    {
+        const auto i0 = vertex_index[mesh.vertex(e, 0).idx()];
+        const auto i1 = vertex_index[mesh.vertex(e, 1).idx()];
+        buffers.edges.push_back(i0);
+        buffers.edges.push_back(i1);
+        if (efeature && efeature[e])
+        {
+            buffers.features.push_back(i0);
+            buffers.features.push_back(i1);
+        }
+    }
+
+    return buffers;
+}
+
+bool update_render_buffers(const SurfaceMesh& mesh, RenderBuffers& buffers,
+                           const std::vector<Vertex>& vertices,
+                           std::vector<unsigned int>& updated)
+{
+    updated.clear();
+    if (buffers.corners.size() != (mesh.n_faces() ? mesh.halfedges_size() : 0))
+        return false;
+
+    // moving a vertex changes the normals of the corners of its faces
+    std::vector<Vertex> affected(vertices);
+    for (auto v : vertices)
+        for (auto f : mesh.faces(v))
+            for (auto w : mesh.vertices(f))
+                affected.push_back(w);
+
+    return update_corners(mesh, buffers, affected, updated);
+}
+
+bool update_render_buffers(const SurfaceMesh& mesh, RenderBuffers& buffers,
+                           const std::vector<Face>& faces,
+                           std::vector<unsigned int>& updated)
+{
+    updated.clear();
+    if (buffers.corners.size() != (mesh.n_faces() ? mesh.halfedges_size() : 0))
+        return false;
+
+    std::vector<Vertex> affected;
+    for (auto f : faces)
+        for (auto v : mesh.vertices(f))
+            affected.push_back(v);
+
+    return update_corners(mesh, buffers, affected, updated);
+}
+
+} // namespace pmp
@@ -0,0 +1,100 @@
+// Copyright 2023 the Polygon Mesh Processing Library developers.
+// Distributed under a MIT-style license, see LICENSE.txt for details.
+
+#pragma once
+
+#include <limits>
+#include <vector>
+
+#include "pmp/surface_mesh.h"
+
+namespace pmp {
+
+//! \brief Indexed vertex and index arrays for rendering a SurfaceMesh.
+//! \details Each buffer vertex is a unique combination of position, normal,
+//! texture coordinate, and color of a mesh vertex. The corners of a vertex
+//! therefore share a buffer vertex unless they are separated by a crease or
+//! a texture or color seam.
+//! \sa render_buffers()
+//! \ingroup algorithms
+struct RenderBuffers
+{
+    //! Marks halfedges without a corner, i.e., boundary halfedges.
+    static constexpr unsigned int invalid_index =
+        std::numeric_limits<unsigned int>::max();
+
+    //! \name Per buffer vertex
+    //!@{
+    std::vector<vec3> positions; //!< positions
+    std::vector<vec3> normals;   //!< normals, empty for points without normals
+    std::vector<vec2> texcoords; //!< texture coordinates, may be empty
+    std::vector<vec3> colors;    //!< colors, may be empty
+    std::vector<Vertex> vertices; //!< mesh vertex
+    //!@}
+
+    //! \name Index lists
+    //!@{
+    std::vector<unsigned int> triangles; //!< three indices per triangle
+    std::vector<unsigned int> edges;     //!< two indices per mesh edge
+    std::vector<unsigned int> features;  //!< two indices per feature edge
+    //!@}
+
+    //! \brief The buffer vertex of the corner at the target vertex of each
+    //! halfedge of the mesh.
+    //! \details Contains \c invalid_index for boundary or deleted halfedges.
+    //! Empty for point clouds.
+    std::vector<unsigned int> corners;
+
+    Scalar crease_angle{180}; //!< crease angle the buffers were built with
+    bool use_colors{true};    //!< whether the buffers were built with colors
+};
+
+//! \brief Build indexed buffers for rendering \p mesh.
+//! \details Polygons are tessellated by minimizing the sum of squared
+//! triangle areas, and the triangle list is optimized for the vertex cache
+//! by optimize_vertex_cache(). Vertex colors are taken from the property
+//! \c "v:color" or, if not present, face colors from \c "f:color". Texture
+//! coordinates are taken from \c "h:tex" or \c "v:tex". Meshes without faces
+//! are treated as point clouds with one buffer vertex per vertex and normals
+//! from \c "v:normal", if present.
+//! \param mesh The mesh to render.
+//! \param crease_angle Angle in degrees between the normals of adjacent
+//! faces above which their edge separates smoothing fans, see fan_normals().
+//! Values below one result in face normals, values above 170 in vertex
+//! normals.
+//! \param use_colors Whether to include colors.
+//! \note This function does not require an OpenGL context.
+//! \ingroup algorithms
+RenderBuffers render_buffers(const SurfaceMesh& mesh, Scalar crease_angle = 180,
+                             bool use_colors = true);
+
+//! \brief Update \p buffers after moving \p vertices of \p mesh.
+//! \details Recomputes the positions of the buffer vertices of \p vertices
+//! and the normals, texture coordinates, and colors of all corners of their
+//! incident faces. The cost only depends on the size of the neighborhood of
+//! \p vertices, such that interactive edits of large meshes are cheap.
+//! \param mesh The mesh \p buffers were built from by render_buffers().
+//! \param buffers The buffers to update.
+//! \param vertices The vertices whose positions or attributes changed.
+//! \param updated Returns the sorted indices of all updated buffer vertices.
+//! \return \c false if the buffers cannot be updated in place, e.g., if the
+//! number of halfedges of the mesh changed, or if a new crease or seam splits
+//! a buffer vertex. Rebuild the buffers by render_buffers() in this case.
+//! \pre The connectivity of \p mesh did not change since building the
+//! buffers.
+//! \note The tessellation of polygons is kept.
+//! \ingroup algorithms
+bool update_render_buffers(const SurfaceMesh& mesh, RenderBuffers& buffers,
+                           const std::vector<Vertex>& vertices,
+                           std::vector<unsigned int>& updated);
+
+//! \brief Update \p buffers after changing attributes of \p faces of
+//! \p mesh, e.g., their colors.
+//! \details Recomputes the attributes of all corners at the vertices of
+//! \p faces. See the overload for vertices for details.
+//! \ingroup algorithms
+bool update_render_buffers(const SurfaceMesh& mesh, RenderBuffers& buffers,
+                           const std::vector<Face>& faces,
+                           std::vector<unsigned int>& updated);
+
+} // namespace pmp
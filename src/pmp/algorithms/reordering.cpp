@@ -0,0 +1,205 @@
+// Copyright 2023 the Polygon Mesh Processing Library developers.
+// Distributed under a MIT-style license, see LICENSE.txt for details.
+
+#include "pmp/algorithms/reordering.h"
+#include "pmp/algorithms/utilities.h"
+
+#include <algorithm>
+#include <cstdint>
+
+namespace pmp {
+namespace {
+
+// spread the lower 21 bits of x such that there are two zero bits between
+// each pair of bits
+uint64_t expand_bits(uint64_t x)
+{
+    x &= 0x1fffff;
+    x = (x | x << 32) & 0x1f00000000ffff;
+    x = (x | x << 16) & 0x1f0000ff0000ff;
+    x = (x | x << 8) & 0x100f00f00f00f00f;
+    x = (x | x << 4) & 0x10c30c30c30c30c3;
+    x = (x | x << 2) & 0x1249249249249249;
+    return x;
+}
+
+std::vector<Vertex> morton_order(const SurfaceMesh& mesh)
+{
+    auto bb = bounds(mesh);
+    const auto extent = bb.max() - bb.min();
+    const Scalar size = std::max(extent[0], std::max(extent[1], extent[2]));
+    const Scalar scale = size > 0 ? Scalar(0x1fffff) / size : Scalar(0);
+
+    std::vector<uint64_t> keys(mesh.vertices_size());
+    for (auto v : mesh.vertices())
+    {
+        const Point p = (mesh.position(v) - bb.min()) * scale;
+        keys[v.idx()] = expand_bits(uint64_t(p[0])) |
+                        expand_bits(uint64_t(p[1])) << 1 |
+                        expand_bits(uint64_t(p[2])) << 2;
+    }
+
+    std::vector<Vertex> order(mesh.vertices_begin(), mesh.vertices_end());
+    std::stable_sort(order.begin(), order.end(), [&](Vertex a, Vertex b) {
+        return keys[a.idx()] < keys[b.idx()];
+    });
+    return order;
+}
+
+// breadth-first search from v, returns the last vertex found and the
+// number of levels
+std::pair<Vertex, size_t> bfs_levels(const SurfaceMesh& mesh, Vertex v,
+                                     std::vector<size_t>& stamp,
+                                     size_t current_stamp)
+{
+    std::vector<Vertex> level{v}, next_level;
+    stamp[v.idx()] = current_stamp;
+    Vertex last = v;
+    size_t n_levels = 0;
+
+    while (!level.empty())
+    {
+        ++n_levels;
+
+        // prefer the vertex of minimum valence in the last level
+        last = *std::min_element(level.begin(), level.end(),
+                                 [&](Vertex a, Vertex b) {
+                                     return mesh.valence(a) < mesh.valence(b);
+                                 });
+
+        next_level.clear();
+        for (auto vv : level)
+        {
+            for (auto vn : mesh.vertices(vv))
+            {
+                if (stamp[vn.idx()] != current_stamp)
+                {
+                    stamp[vn.idx()] = current_stamp;
+                    next_level.push_back(vn);
+                }
+            }
+        }
+        level.swap(next_level);
+    }
+
+    return {last, n_levels};
+}
+
+std::vector<Vertex> reverse_cuthill_mckee_order(const SurfaceMesh& mesh)
+{
+    const auto nv = mesh.vertices_size();
+
+    std::vector<size_t> valence(nv);
+    for (auto v : mesh.vertices())
+        valence[v.idx()] = mesh.valence(v);
+
+    // process vertices by increasing valence to find start vertices
+    std::vector<Vertex> candidates(mesh.vertices_begin(), mesh.vertices_end());
+    std::stable_sort(candidates.begin(), candidates.end(),
+                     [&](Vertex a, Vertex b) {
+                         return valence[a.idx()] < valence[b.idx()];
+                     });
+
+    std::vector<bool> visited(nv, false);
+    std::vector<size_t> stamp(nv, 0);
+    size_t current_stamp = 0;
+
+    std::vector<Vertex> order;
+    order.reserve(mesh.n_vertices());
+    std::vector<Vertex> neighbors;
+
+    for (auto start : candidates)
+    {
+        if (visited[start.idx()])
+            continue;
+
+        // find a pseudo-peripheral start vertex for this component
+        auto [far, n_levels] = bfs_levels(mesh, start, stamp, ++current_stamp);
+        for (int i = 0; i < 4; ++i)
+        {
+            auto [far2, n_levels2] =
+                bfs_levels(mesh, far, stamp, ++current_stamp);
+            if (n_levels2 <= n_levels)
+                break;
+            far = far2;
+            n_levels = n_levels2;
+        }
+
+        // Cuthill-McKee: breadth-first search visiting neighbors by
+        // increasing valence
+        size_t head = order.size();
+        order.push_back(far);
+        visited[far.idx()] = true;
+        while (head < order.size())
+        {
+            const Vertex v = order[head++];
+            neighbors.clear();
+            for (auto vn : mesh.vertices(v))
+                if (!visited[vn.idx()])
+                {
+                    visited[vn.idx()] = true;
+                    neighbors.push_back(vn);
+                }
+            std::stable_sort(neighbors.begin(), neighbors.end(),
+                             [&](Vertex a, Vertex b) {
+                                 return valence[a.idx()] < valence[b.idx()];
+                             });
+            order.insert(order.end(), neighbors.begin(), neighbors.end());
+        }
+    }
+
+    std::reverse(order.begin(), order.end());
+    return order;
+}
+
+} // namespace
+
+void reorder(SurfaceMesh& mesh, ReorderingMethod method)
+{
+    mesh.garbage_collection();
+
+    // order vertices
+    std::vector<Vertex> vertex_order;
+    switch (method)
+    {
+        case ReorderingMethod::Morton:
+            vertex_order = morton_order(mesh);
+            break;
+        case ReorderingMethod::ReverseCuthillMcKee:
+            vertex_order = reverse_cuthill_mckee_order(mesh);
+            break;
+    }
+
+    std::vector<IndexType> vmap(mesh.vertices_size());
+    for (size_t i = 0; i < vertex_order.size(); ++i)
+        vmap[vertex_order[i].idx()] = static_cast<IndexType>(i);
+
+    // order edges by their smallest new vertex index
+    std::vector<std::pair<IndexType, IndexType>> ekeys(mesh.edges_size());
+    for (auto e : mesh.edges())
+    {
+        const auto i0 = vmap[mesh.vertex(e, 0).idx()];
+        const auto i1 = vmap[mesh.vertex(e, 1).idx()];
+        ekeys[e.idx()] = std::minmax(i0, i1);
+    }
+    std::vector<Edge> edge_order(mesh.edges_begin(), mesh.edges_end());
+    std::stable_sort(edge_order.begin(), edge_order.end(),
+                     [&](Edge a, Edge b) {
+                         return ekeys[a.idx()] < ekeys[b.idx()];
+                     });
+
+    // order faces by their smallest new vertex index
+    std::vector<IndexType> fkeys(mesh.faces_size(), PMP_MAX_INDEX);
+    for (auto f : mesh.faces())
+        for (auto v : mesh.vertices(f))
+            fkeys[f.idx()] = std::min(fkeys[f.idx()], vmap[v.idx()]);
+    std::vector<Face> face_order(mesh.faces_begin(), mesh.faces_end());
+    std::stable_sort(face_order.begin(), face_order.end(),
+                     [&](Face a, Face b) {
+                         return fkeys[a.idx()] < fkeys[b.idx()];
+                     });
+
+    mesh.permute(vertex_order, edge_order, face_order);
+}
+
+} // namespace pmp
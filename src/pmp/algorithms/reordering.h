@@ -0,0 +1,33 @@
+// Copyright 2023 the Polygon Mesh Processing Library developers.
+// Distributed under a MIT-style license, see LICENSE.txt for details.
+
+#pragma once
+
+#include "pmp/surface_mesh.h"
+
+namespace pmp {
+
+//! Strategies for reordering mesh elements.
+//! \ingroup algorithms
+enum class ReorderingMethod
+{
+    //! Sort vertices along a Morton (Z-order) space-filling curve.
+    Morton,
+    //! Reverse Cuthill-McKee ordering, minimizing matrix bandwidth.
+    ReverseCuthillMcKee
+};
+
+//! \brief Reorder mesh elements to improve memory locality.
+//! \details Vertices are sorted according to \p method. Edges and faces
+//! are then sorted by their smallest incident vertex index, such that
+//! neighboring elements are close in memory. All properties are permuted
+//! consistently. Reverse Cuthill-McKee ordering also reduces the bandwidth of
+//! matrices such as the one computed by laplace_matrix(), which speeds up
+//! their factorization.
+//! \note Deleted elements are removed by calling garbage_collection() first.
+//! \note This algorithm works on general polygon meshes.
+//! \ingroup algorithms
+void reorder(SurfaceMesh& mesh,
+             ReorderingMethod method = ReorderingMethod::Morton);
+
+} // namespace pmp
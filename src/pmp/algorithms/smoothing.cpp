@@ -4,12 +4,15 @@
 #include "pmp/algorithms/smoothing.h"
 #include "pmp/algorithms/differential_geometry.h"
 #include "pmp/algorithms/laplace.h"
+#include "pmp/trace.h"
 
 namespace pmp {
 
 void explicit_smoothing(SurfaceMesh& mesh, unsigned int iterations,
                         bool use_uniform_laplace)
 {
+    PMP_TRACE_SCOPE("explicit_smoothing");
+
     if (!mesh.n_vertices())
         return;
 
@@ -51,8 +54,10 @@ void explicit_smoothing(SurfaceMesh& mesh, unsigned int iterations,
 
 void implicit_smoothing(SurfaceMesh& mesh, Scalar timestep,
                         unsigned int iterations, bool use_uniform_laplace,
-                        bool rescale)
+                        bool rescale, Progress* progress)
 {
+    PMP_TRACE_SCOPE("implicit_smoothing");
+
     if (!mesh.n_vertices())
         return;
 
@@ -83,6 +88,10 @@ void implicit_smoothing(SurfaceMesh& mesh, Scalar timestep,
 
     for (unsigned int iter = 0; iter < iterations; ++iter)
     {
+        // the mesh is valid between iterations
+        if (progress && !progress->checkpoint(float(iter) / iterations))
+            throw CanceledException("implicit_smoothing: Canceled.");
+
         if (!use_uniform_laplace)
         {
             mass_matrix(mesh, M);
@@ -97,7 +106,7 @@ void implicit_smoothing(SurfaceMesh& mesh, Scalar timestep,
         auto is_constrained = [&](unsigned int i) {
             return mesh.is_boundary(Vertex(i));
         };
-        X = cholesky_solve(A, B, is_constrained, X);
+        X = cholesky_solve(A, B, is_constrained, X, progress);
         matrix_to_coordinates(X, mesh);
 
         if (rescale)
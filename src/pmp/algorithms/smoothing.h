@@ -3,6 +3,7 @@
 
 #pragma once
 
+#include "pmp/progress.h"
 #include "pmp/surface_mesh.h"
 
 namespace pmp {
@@ -25,10 +26,15 @@ void explicit_smoothing(SurfaceMesh& mesh, unsigned int iterations = 10,
 //! \param iterations The number of iterations performed.
 //! \param use_uniform_laplace Use uniform or cotan Laplacian. Default: cotan.
 //! \param rescale Re-center and re-scale model after smoothing. Default: true.
+//! \param progress Optional progress and cancellation state, polled before
+//! each solver step and between factorization and solve.
 //! \throw SolverException in case of a failure to solve the linear system.
+//! \throw CanceledException if \p progress is canceled. The mesh keeps the
+//! result of the iterations done so far.
 //! \ingroup algorithms
 void implicit_smoothing(SurfaceMesh& mesh, Scalar timestep = 0.001,
                         unsigned int iterations = 1,
-                        bool use_uniform_laplace = false, bool rescale = true);
+                        bool use_uniform_laplace = false, bool rescale = true,
+                        Progress* progress = nullptr);
 
 } // namespace pmp
@@ -3,12 +3,28 @@
 
 #include "pmp/algorithms/subdivision.h"
 #include "pmp/algorithms/differential_geometry.h"
+#include "pmp/trace.h"
 
 namespace pmp {
+namespace {
+
+// report progress, true if canceled
+bool canceled(Progress* progress, float fraction)
+{
+    return progress && !progress->checkpoint(fraction);
+}
+
+} // namespace
 
 void catmull_clark_subdivision(SurfaceMesh& mesh,
-                               BoundaryHandling boundary_handling)
+                               BoundaryHandling boundary_handling,
+                               Progress* progress)
 {
+    PMP_TRACE_SCOPE("catmull_clark_subdivision");
+
+    if (canceled(progress, 0.0f))
+        throw CanceledException(std::string{__func__} + ": Canceled.");
+
     auto points_ = mesh.vertex_property<Point>("v:point");
     auto vfeature_ = mesh.get_vertex_property<bool>("v:feature");
     auto efeature_ = mesh.get_edge_property<bool>("e:feature");
@@ -133,6 +149,15 @@ void catmull_clark_subdivision(SurfaceMesh& mesh,
         }
     }
 
+    // last chance to cancel before modifying the mesh
+    if (canceled(progress, 0.5f))
+    {
+        mesh.remove_vertex_property(vpoint);
+        mesh.remove_edge_property(epoint);
+        mesh.remove_face_property(fpoint);
+        throw CanceledException(std::string{__func__} + ": Canceled.");
+    }
+
     // assign new positions to old vertices
     for (auto v : mesh.vertices())
     {
@@ -185,8 +210,14 @@ void catmull_clark_subdivision(SurfaceMesh& mesh,
     mesh.remove_face_property(fpoint);
 }
 
-void loop_subdivision(SurfaceMesh& mesh, BoundaryHandling boundary_handling)
+void loop_subdivision(SurfaceMesh& mesh, BoundaryHandling boundary_handling,
+                      Progress* progress)
 {
+    PMP_TRACE_SCOPE("loop_subdivision");
+
+    if (canceled(progress, 0.0f))
+        throw CanceledException(std::string{__func__} + ": Canceled.");
+
     auto points_ = mesh.vertex_property<Point>("v:point");
     auto vfeature_ = mesh.get_vertex_property<bool>("v:feature");
     auto efeature_ = mesh.get_edge_property<bool>("e:feature");
@@ -310,6 +341,14 @@ void loop_subdivision(SurfaceMesh& mesh, BoundaryHandling boundary_handling)
         }
     }
 
+    // last chance to cancel before modifying the mesh
+    if (canceled(progress, 0.5f))
+    {
+        mesh.remove_vertex_property(vpoint);
+        mesh.remove_edge_property(epoint);
+        throw CanceledException(std::string{__func__} + ": Canceled.");
+    }
+
     // set new vertex positions
     for (auto v : mesh.vertices())
     {
@@ -356,8 +395,14 @@ void loop_subdivision(SurfaceMesh& mesh, BoundaryHandling boundary_handling)
     mesh.remove_edge_property(epoint);
 }
 
-void quad_tri_subdivision(SurfaceMesh& mesh, BoundaryHandling boundary_handling)
+void quad_tri_subdivision(SurfaceMesh& mesh, BoundaryHandling boundary_handling,
+                          Progress* progress)
 {
+    PMP_TRACE_SCOPE("quad_tri_subdivision");
+
+    if (canceled(progress, 0.0f))
+        throw CanceledException(std::string{__func__} + ": Canceled.");
+
     auto points_ = mesh.vertex_property<Point>("v:point");
 
     // split each edge evenly into two parts
@@ -407,6 +452,10 @@ void quad_tri_subdivision(SurfaceMesh& mesh, BoundaryHandling boundary_handling)
         }
     }
 
+    // the mesh is already modified, so only report progress
+    if (progress)
+        progress->set_fraction(0.5f);
+
     auto new_pos =
         mesh.add_vertex_property<Point>("quad_tri:new_position", Point(0));
 
@@ -505,8 +554,13 @@ void quad_tri_subdivision(SurfaceMesh& mesh, BoundaryHandling boundary_handling)
     mesh.remove_vertex_property(new_pos);
 }
 
-void linear_subdivision(SurfaceMesh& mesh)
+void linear_subdivision(SurfaceMesh& mesh, Progress* progress)
 {
+    PMP_TRACE_SCOPE("linear_subdivision");
+
+    if (canceled(progress, 0.0f))
+        throw CanceledException(std::string{__func__} + ": Canceled.");
+
     auto points_ = mesh.vertex_property<Point>("v:point");
 
     // linear subdivision of edges
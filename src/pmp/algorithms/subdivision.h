@@ -3,6 +3,7 @@
 
 #pragma once
 
+#include "pmp/progress.h"
 #include "pmp/surface_mesh.h"
 
 namespace pmp {
@@ -17,34 +18,53 @@ enum class BoundaryHandling
 //! \details See \cite catmull_1978_recursively for details.
 //! \param mesh The input mesh, modified in place.
 //! \param boundary_handling Specify to interpolate or preserve boundary edges.
+//! \param progress Optional progress and cancellation state, polled before
+//! the mesh is modified.
+//! \throw CanceledException if \p progress is canceled. The mesh is left
+//! unchanged in this case.
 //! \ingroup algorithms
 void catmull_clark_subdivision(
     SurfaceMesh& mesh,
-    BoundaryHandling boundary_handling = BoundaryHandling::Interpolate);
+    BoundaryHandling boundary_handling = BoundaryHandling::Interpolate,
+    Progress* progress = nullptr);
 
 //! \brief Perform one step of Loop subdivision.
 //! \details See \cite loop_1987_smooth for details.
 //! \param mesh The input mesh, modified in place.
 //! \param boundary_handling Specify to interpolate or preserve boundary edges.
+//! \param progress Optional progress and cancellation state, polled before
+//! the mesh is modified.
 //! \pre Requires a triangle mesh as input.
 //! \throw InvalidInputException in case the input violates the precondition.
+//! \throw CanceledException if \p progress is canceled. The mesh is left
+//! unchanged in this case.
 //! \ingroup algorithms
-void loop_subdivision(SurfaceMesh& mesh, BoundaryHandling boundary_handling =
-                                             BoundaryHandling::Interpolate);
+void loop_subdivision(
+    SurfaceMesh& mesh,
+    BoundaryHandling boundary_handling = BoundaryHandling::Interpolate,
+    Progress* progress = nullptr);
 
 //! \brief Perform one step of quad-tri subdivision.
 //! \details Suitable for mixed quad/triangle meshes. See \cite stam_2003_subdiv for details.
 //! \param mesh The input mesh, modified in place.
 //! \param boundary_handling Specify to interpolate or preserve boundary edges.
+//! \param progress Optional progress and cancellation state, polled before
+//! the mesh is modified.
+//! \throw CanceledException if \p progress is canceled. The mesh is left
+//! unchanged in this case.
 //! \ingroup algorithms
 void quad_tri_subdivision(
     SurfaceMesh& mesh,
-    BoundaryHandling boundary_handling = BoundaryHandling::Interpolate);
+    BoundaryHandling boundary_handling = BoundaryHandling::Interpolate,
+    Progress* progress = nullptr);
 
 //! \brief Perform one step of linear quad-tri subdivision.
 //! \details Suitable for mixed quad/triangle meshes.
 //! \param mesh The input mesh, modified in place.
+//! \param progress Optional progress and cancellation state, polled before
+//! the mesh is modified.
+//! \throw CanceledException if \p progress is canceled.
 //! \ingroup algorithms
-void linear_subdivision(SurfaceMesh& mesh);
+void linear_subdivision(SurfaceMesh& mesh, Progress* progress = nullptr);
 
 } // namespace pmp
@@ -0,0 +1,453 @@
+// Copyright 2023 the Polygon Mesh Processing Library developers.
+// Distributed under a MIT-style license, see LICENSE.txt for details.
+
+#include "pmp/algorithms/vertex_cache.h"
+#include "pmp/exceptions.h"
+#include "pmp/algorithms/utilities.h"
+
+#include <algorithm>
+#include <cmath>
+#include <numeric>
+#include <string>
+
+namespace pmp {
+namespace {
+
+// size of the LRU cache simulated by Forsyth's algorithm
+constexpr int lru_cache_size = 32;
+
+// score of a vertex at position cache_position of the cache (-1 if not
+// cached) that is used by the given number of remaining triangles
+float vertex_score(int cache_position, size_t remaining)
+{
+    if (remaining == 0)
+        return -1.0f;
+
+    float score = 0.0f;
+    if (cache_position >= 0)
+    {
+        // the vertices of the last triangle get a fixed score, such that it
+        // does not matter in which order they have been added
+        if (cache_position < 3)
+            score = 0.75f;
+        else
+            score = std::pow(1.0f - float(cache_position - 3) /
+                                        float(lru_cache_size - 3),
+                             1.5f);
+    }
+
+    // prefer vertices with few remaining triangles, to avoid leaving
+    // single triangles behind
+    return score + 2.0f / std::sqrt(float(remaining));
+}
+
+// throws if triangles is not a valid triangle list
+void check_triangles(const std::vector<unsigned int>& triangles,
+                     size_t n_vertices, const std::string& function)
+{
+    if (triangles.size() % 3 != 0)
+        throw InvalidInputException(
+            function + ": Number of indices is not a multiple of three.");
+    for (auto i : triangles)
+        if (i >= n_vertices)
+            throw InvalidInputException(function + ": Index out of range.");
+}
+
+// Forsyth's triangle order, i.e., new-to-old triangle indices
+std::vector<size_t> vertex_cache_order(
+    const std::vector<unsigned int>& triangles, size_t n_vertices)
+{
+    const size_t n_triangles = triangles.size() / 3;
+    if (n_triangles == 0)
+        return {};
+    // triangles of each vertex in compressed row storage, the first
+    // remaining[v] entries of a row are the triangles not yet emitted
+    std::vector<size_t> offsets(n_vertices + 1, 0);
+    for (auto i : triangles)
+        ++offsets[i + 1];
+    std::partial_sum(offsets.begin(), offsets.end(), offsets.begin());
+
+    std::vector<size_t> adjacency(triangles.size());
+    std::vector<size_t> remaining(n_vertices, 0);
+    for (size_t t = 0; t < n_triangles; ++t)
+        for (size_t k = 0; k < 3; ++k)
+        {
+            const auto v = triangles[3 * t + k];
+            adjacency[offsets[v] + remaining[v]++] = t;
+        }
+
+    std::vector<int> cache_position(n_vertices, -1);
+    std::vector<float> vscore(n_vertices);
+    for (size_t v = 0; v < n_vertices; ++v)
+        vscore[v] = vertex_score(-1, remaining[v]);
+
+    std::vector<float> tscore(n_triangles);
+    for (size_t t = 0; t < n_triangles; ++t)
+        tscore[t] = vscore[triangles[3 * t]] + vscore[triangles[3 * t + 1]] +
+                    vscore[triangles[3 * t + 2]];
+
+    std::vector<bool> emitted(n_triangles, false);
+    std::vector<size_t> order;
+    order.reserve(n_triangles);
+    std::vector<unsigned int> cache, new_cache;
+    cache.reserve(lru_cache_size + 3);
+    new_cache.reserve(lru_cache_size + 3);
+
+    // start with the best triangle overall
+    size_t best = static_cast<size_t>(
+        std::max_element(tscore.begin(), tscore.end()) - tscore.begin());
+    size_t next_unemitted = 0;
+
+    for (size_t n_emitted = 0; n_emitted < n_triangles; ++n_emitted)
+    {
+        // no candidate in the cache: continue with the next triangle in the
+        // input order
+        if (best == n_triangles)
+        {
+            while (emitted[next_unemitted])
+                ++next_unemitted;
+            best = next_unemitted;
+        }
+
+        // emit the triangle and remove it from the rows of its vertices
+        const unsigned int* tri = &triangles[3 * best];
+        order.push_back(best);
+        emitted[best] = true;
+        for (size_t k = 0; k < 3; ++k)
+        {
+            const auto v = tri[k];
+            auto* begin = &adjacency[offsets[v]];
+            auto* end = begin + remaining[v];
+            std::iter_swap(std::find(begin, end, best), end - 1);
+            --remaining[v];
+        }
+
+        // move the vertices of the triangle to the front of the cache
+        new_cache.assign(tri, tri + 3);
+        for (auto v : cache)
+            if (v != tri[0] && v != tri[1] && v != tri[2])
+                new_cache.push_back(v);
+
+        // update the scores of cached and evicted vertices and their
+        // remaining triangles
+        for (size_t i = 0; i < new_cache.size(); ++i)
+        {
+            const auto v = new_cache[i];
+            const int position = i < lru_cache_size ? int(i) : -1;
+            cache_position[v] = position;
+
+            const float score = vertex_score(position, remaining[v]);
+            const float delta = score - vscore[v];
+            vscore[v] = score;
+            for (size_t j = 0; j < remaining[v]; ++j)
+                tscore[adjacency[offsets[v] + j]] += delta;
+        }
+        if (new_cache.size() > size_t(lru_cache_size))
+            new_cache.resize(lru_cache_size);
+        std::swap(cache, new_cache);
+
+        // the next triangle is the best one using a cached vertex
+        best = n_triangles;
+        float best_score = -1.0f;
+        for (auto v : cache)
+            for (size_t j = 0; j < remaining[v]; ++j)
+            {
+                const size_t t = adjacency[offsets[v] + j];
+                if (tscore[t] > best_score)
+                {
+                    best = t;
+                    best_score = tscore[t];
+                }
+            }
+    }
+
+    return order;
+}
+
+
+// the triangles in the given new-to-old order
+std::vector<unsigned int> reorder_triangles(
+    const std::vector<unsigned int>& triangles,
+    const std::vector<size_t>& order)
+{
+    std::vector<unsigned int> result;
+    result.reserve(triangles.size());
+    for (auto t : order)
+        result.insert(result.end(), &triangles[3 * t], &triangles[3 * t] + 3);
+    return result;
+}
+
+// simulates a FIFO cache and returns whether vertex i was a miss
+class FifoCache
+{
+public:
+    FifoCache(size_t n_vertices, size_t size)
+        : timestamps_(n_vertices, 0), size_(size)
+    {
+    }
+
+    bool access(unsigned int i)
+    {
+        // a vertex is cached if it was inserted less than size_ misses ago
+        if (timestamps_[i] && time_ - timestamps_[i] < size_)
+            return false;
+        timestamps_[i] = ++time_;
+        return true;
+    }
+
+    // empty the cache
+    void flush() { time_ += size_; }
+
+private:
+    std::vector<size_t> timestamps_;
+    size_t size_;
+    size_t time_{0};
+};
+
+// Sander's overdraw order: split the triangles into clusters whose
+// cache miss ratio stays within threshold of the whole list, and draw the
+// clusters facing outwards first
+std::vector<size_t> overdraw_order(const std::vector<unsigned int>& triangles,
+                                   const std::vector<vec3>& positions,
+                                   float threshold)
+{
+    const size_t n_triangles = triangles.size() / 3;
+    if (n_triangles == 0)
+        return {};
+
+    FifoCache cache(positions.size(), 16);
+    size_t total_misses = 0;
+    for (auto i : triangles)
+        total_misses += cache.access(i);
+    const double target =
+        threshold * double(total_misses) / double(n_triangles);
+
+    // cluster boundaries, restarting the cache at each cluster
+    std::vector<size_t> starts{0};
+    cache.flush();
+    size_t misses = 0;
+    for (size_t t = 0; t < n_triangles; ++t)
+    {
+        for (size_t k = 0; k < 3; ++k)
+            misses += cache.access(triangles[3 * t + k]);
+        const size_t n = t + 1 - starts.back();
+        if (t + 1 < n_triangles && double(misses) <= target * double(n))
+        {
+            starts.push_back(t + 1);
+            cache.flush();
+            misses = 0;
+        }
+    }
+    starts.push_back(n_triangles);
+
+    // area-weighted centroid of the mesh and of each cluster
+    const size_t n_clusters = starts.size() - 1;
+    std::vector<vec3> centroids(n_clusters, vec3(0, 0, 0));
+    std::vector<vec3> normals(n_clusters, vec3(0, 0, 0));
+    std::vector<float> areas(n_clusters, 0.0f);
+    vec3 center(0, 0, 0);
+    float area = 0.0f;
+    for (size_t c = 0; c < n_clusters; ++c)
+    {
+        for (size_t t = starts[c]; t < starts[c + 1]; ++t)
+        {
+            const auto& p0 = positions[triangles[3 * t]];
+            const auto& p1 = positions[triangles[3 * t + 1]];
+            const auto& p2 = positions[triangles[3 * t + 2]];
+            const vec3 n = cross(p1 - p0, p2 - p0);
+            const float a = norm(n);
+            centroids[c] += a * (p0 + p1 + p2) / 3.0f;
+            normals[c] += n;
+            areas[c] += a;
+        }
+        center += centroids[c];
+        area += areas[c];
+    }
+    if (area > 0.0f)
+        center /= area;
+
+    // sort clusters by how far they face outwards
+    std::vector<float> keys(n_clusters, 0.0f);
+    for (size_t c = 0; c < n_clusters; ++c)
+    {
+        if (areas[c] > 0.0f && norm(normals[c]) > 0.0f)
+            keys[c] = dot(centroids[c] / areas[c] - center,
+                          normalize(normals[c]));
+    }
+    std::vector<size_t> clusters(n_clusters);
+    std::iota(clusters.begin(), clusters.end(), 0);
+    std::stable_sort(clusters.begin(), clusters.end(),
+                     [&](size_t a, size_t b) { return keys[a] > keys[b]; });
+
+    std::vector<size_t> order;
+    order.reserve(n_triangles);
+    for (auto c : clusters)
+        for (size_t t = starts[c]; t < starts[c + 1]; ++t)
+            order.push_back(t);
+    return order;
+}
+
+// vertices in the order of their first use, unused vertices last
+std::vector<unsigned int> vertex_fetch_order(
+    const std::vector<unsigned int>& triangles, size_t n_vertices)
+{
+    std::vector<bool> used(n_vertices, false);
+    std::vector<unsigned int> order;
+    order.reserve(n_vertices);
+    for (auto i : triangles)
+        if (!used[i])
+        {
+            used[i] = true;
+            order.push_back(i);
+        }
+    for (size_t i = 0; i < n_vertices; ++i)
+        if (!used[i])
+            order.push_back(static_cast<unsigned int>(i));
+    return order;
+}
+
+// the triangles of a triangle mesh in storage order
+std::vector<unsigned int> mesh_triangles(const SurfaceMesh& mesh,
+                                         const std::string& function)
+{
+    if (!mesh.is_triangle_mesh())
+        throw InvalidInputException(function + ": Not a triangle mesh.");
+
+    std::vector<unsigned int> triangles;
+    triangles.reserve(3 * mesh.n_faces());
+    for (auto f : mesh.faces())
+        for (auto v : mesh.vertices(f))
+            triangles.push_back(v.idx());
+    return triangles;
+}
+
+} // namespace
+
+void optimize_vertex_cache(std::vector<unsigned int>& triangles,
+                           size_t n_vertices)
+{
+    check_triangles(triangles, n_vertices, "optimize_vertex_cache");
+    const auto order = vertex_cache_order(triangles, n_vertices);
+    triangles = reorder_triangles(triangles, order);
+}
+
+void optimize_overdraw(std::vector<unsigned int>& triangles,
+                       const std::vector<vec3>& positions, float threshold)
+{
+    check_triangles(triangles, positions.size(), "optimize_overdraw");
+    const auto order = overdraw_order(triangles, positions, threshold);
+    triangles = reorder_triangles(triangles, order);
+}
+
+std::vector<unsigned int> optimize_vertex_fetch(
+    std::vector<unsigned int>& triangles, size_t n_vertices)
+{
+    check_triangles(triangles, n_vertices, "optimize_vertex_fetch");
+    const auto order = vertex_fetch_order(triangles, n_vertices);
+
+    std::vector<unsigned int> map(n_vertices);
+    for (size_t i = 0; i < n_vertices; ++i)
+        map[order[i]] = static_cast<unsigned int>(i);
+    for (auto& i : triangles)
+        i = map[i];
+    return order;
+}
+
+VertexCacheStatistics vertex_cache_statistics(
+    const std::vector<unsigned int>& triangles, size_t n_vertices,
+    size_t cache_size)
+{
+    check_triangles(triangles, n_vertices, "vertex_cache_statistics");
+    if (cache_size == 0)
+        throw InvalidInputException(
+            "vertex_cache_statistics: Cache size must be positive.");
+
+    FifoCache cache(n_vertices, cache_size);
+    std::vector<bool> used(n_vertices, false);
+    size_t misses = 0;
+    size_t n_used = 0;
+    for (auto i : triangles)
+    {
+        misses += cache.access(i);
+        if (!used[i])
+        {
+            used[i] = true;
+            ++n_used;
+        }
+    }
+
+    VertexCacheStatistics stats;
+    if (!triangles.empty())
+    {
+        stats.acmr = double(misses) / double(triangles.size() / 3);
+        stats.atvr = double(misses) / double(n_used);
+    }
+    return stats;
+}
+
+VertexCacheStatistics vertex_cache_statistics(const SurfaceMesh& mesh,
+                                              size_t cache_size)
+{
+    return vertex_cache_statistics(
+        mesh_triangles(mesh, "vertex_cache_statistics"), mesh.vertices_size(),
+        cache_size);
+}
+
+void optimize_draw_order(SurfaceMesh& mesh, bool overdraw)
+{
+    if (!mesh.is_triangle_mesh())
+        throw InvalidInputException(
+            "optimize_draw_order: Not a triangle mesh.");
+
+    mesh.garbage_collection();
+    const auto triangles = mesh_triangles(mesh, "optimize_draw_order");
+    const auto n_vertices = mesh.vertices_size();
+
+    // order faces for the vertex cache and optionally for overdraw
+    auto order = vertex_cache_order(triangles, n_vertices);
+    if (overdraw)
+    {
+        std::vector<vec3> positions(n_vertices);
+        for (auto v : mesh.vertices())
+            positions[v.idx()] = vec3(mesh.position(v));
+        const auto clusters = overdraw_order(
+            reorder_triangles(triangles, order), positions, 1.05f);
+        std::vector<size_t> composed(clusters.size());
+        for (size_t i = 0; i < clusters.size(); ++i)
+            composed[i] = order[clusters[i]];
+        order.swap(composed);
+    }
+    std::vector<Face> face_order;
+    face_order.reserve(order.size());
+    for (auto t : order)
+        face_order.emplace_back(t);
+
+    // order vertices by their first use
+    std::vector<Vertex> vertex_order;
+    vertex_order.reserve(n_vertices);
+    for (auto i : vertex_fetch_order(reorder_triangles(triangles, order),
+                                     n_vertices))
+        vertex_order.emplace_back(i);
+
+    // order edges by their first use
+    std::vector<bool> used(mesh.edges_size(), false);
+    std::vector<Edge> edge_order;
+    edge_order.reserve(mesh.edges_size());
+    for (auto f : face_order)
+        for (auto h : mesh.halfedges(f))
+        {
+            const auto e = mesh.edge(h);
+            if (!used[e.idx()])
+            {
+                used[e.idx()] = true;
+                edge_order.push_back(e);
+            }
+        }
+    for (auto e : mesh.edges())
+        if (!used[e.idx()])
+            edge_order.push_back(e);
+
+    mesh.permute(vertex_order, edge_order, face_order);
+}
+
+} // namespace pmp
@@ -0,0 +1,98 @@
+// Copyright 2023 the Polygon Mesh Processing Library developers.
+// Distributed under a MIT-style license, see LICENSE.txt for details.
+
+#pragma once
+
+#include <cstddef>
+#include <vector>
+
+#include "pmp/surface_mesh.h"
+
+namespace pmp {
+
+//! \brief Vertex cache efficiency of a triangle order.
+//! \sa vertex_cache_statistics()
+//! \ingroup algorithms
+struct VertexCacheStatistics
+{
+    //! Average cache miss ratio, i.e., transformed vertices per triangle.
+    //! Ranges from about 0.5 for an optimal order to 3.
+    double acmr{0};
+
+    //! Average transform to vertex ratio, i.e., transformed vertices per
+    //! referenced vertex. Ranges from 1 for an optimal order to about 6.
+    double atvr{0};
+};
+
+//! \brief Reorder an indexed triangle list for vertex cache efficiency.
+//! \details Greedily emits the triangle whose vertices score highest in a
+//! simulated LRU cache of 32 entries, favoring vertices with few remaining
+//! triangles, such that the post-transform vertex cache of the GPU is
+//! reused. See \cite forsyth_2006_linear for details.
+//! \param triangles Three vertex indices per triangle, reordered in place.
+//! The orientation of the triangles is preserved.
+//! \param n_vertices The number of vertices, i.e., one plus the largest
+//! index.
+//! \throw InvalidInputException if the number of indices is not a multiple
+//! of three or if an index is out of range.
+//! \ingroup algorithms
+void optimize_vertex_cache(std::vector<unsigned int>& triangles,
+                           size_t n_vertices);
+
+//! \brief Reorder a triangle list to reduce overdraw.
+//! \details Splits the list into clusters whose average cache miss ratio
+//! stays within \p threshold times the one of the whole list and draws
+//! clusters facing away from the center first, such that they occlude
+//! others. Call this after optimize_vertex_cache(). See
+//! \cite sander_2007_fast for details.
+//! \param triangles Three vertex indices per triangle, reordered in place.
+//! \param positions The vertex positions.
+//! \param threshold The maximum increase of the average cache miss ratio.
+//! \throw InvalidInputException if the number of indices is not a multiple
+//! of three or if an index is out of range.
+//! \ingroup algorithms
+void optimize_overdraw(std::vector<unsigned int>& triangles,
+                       const std::vector<vec3>& positions,
+                       float threshold = 1.05f);
+
+//! \brief Renumber vertices in the order of their first use.
+//! \details Improves the locality of vertex fetches of a triangle list
+//! optimized by optimize_vertex_cache(). Unused vertices are moved to the
+//! end.
+//! \param triangles Three vertex indices per triangle, renumbered in place.
+//! \param n_vertices The number of vertices.
+//! \return The old index of each new vertex, to be used for reordering the
+//! vertex attributes.
+//! \throw InvalidInputException if the number of indices is not a multiple
+//! of three or if an index is out of range.
+//! \ingroup algorithms
+std::vector<unsigned int> optimize_vertex_fetch(
+    std::vector<unsigned int>& triangles, size_t n_vertices);
+
+//! \brief Simulate a FIFO vertex cache of \p cache_size entries for a
+//! triangle list.
+//! \details Allows to measure the effect of reordering without a GPU.
+//! \throw InvalidInputException if the number of indices is not a multiple
+//! of three, if an index is out of range, or if \p cache_size is zero.
+//! \ingroup algorithms
+VertexCacheStatistics vertex_cache_statistics(
+    const std::vector<unsigned int>& triangles, size_t n_vertices,
+    size_t cache_size = 16);
+
+//! \brief Simulate a FIFO vertex cache for the faces of \p mesh in storage
+//! order.
+//! \throw InvalidInputException if the input is not a pure triangle mesh.
+//! \ingroup algorithms
+VertexCacheStatistics vertex_cache_statistics(const SurfaceMesh& mesh,
+                                              size_t cache_size = 16);
+
+//! \brief Reorder the elements of \p mesh for rendering.
+//! \details Faces are sorted by optimize_vertex_cache() and, if
+//! \p overdraw is \c true, by optimize_overdraw(). Vertices and edges are
+//! then sorted by their first use. All properties are permuted consistently.
+//! \note Deleted elements are removed by calling garbage_collection() first.
+//! \throw InvalidInputException if the input is not a pure triangle mesh.
+//! \ingroup algorithms
+void optimize_draw_order(SurfaceMesh& mesh, bool overdraw = false);
+
+} // namespace pmp
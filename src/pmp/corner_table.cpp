@@ -0,0 +1,63 @@
+// Copyright 2023 the Polygon Mesh Processing Library developers.
+// Distributed under a MIT-style license, see LICENSE.txt for details.
+
+#include "pmp/corner_table.h"
+
+namespace pmp {
+
+CornerTable::CornerTable(const SurfaceMesh& mesh)
+{
+    if (mesh.n_vertices() != mesh.vertices_size() ||
+        mesh.n_edges() != mesh.edges_size() ||
+        mesh.n_faces() != mesh.faces_size())
+        throw InvalidInputException(
+            "CornerTable: Mesh contains deleted elements.");
+
+    if (!mesh.is_triangle_mesh())
+        throw InvalidInputException("CornerTable: Not a triangle mesh.");
+
+    const size_t nc = 3 * mesh.n_faces();
+    vertex_.resize(nc);
+    opposite_.resize(nc, PMP_MAX_INDEX);
+    vcorner_.resize(mesh.n_vertices(), PMP_MAX_INDEX);
+
+    // corner pointed to by each halfedge
+    std::vector<IndexType> hcorner(mesh.halfedges_size(), PMP_MAX_INDEX);
+
+    for (auto f : mesh.faces())
+    {
+        IndexType c = corner(f, 0);
+        for (auto h : mesh.halfedges(f))
+        {
+            vertex_[c] = mesh.to_vertex(h).idx();
+            hcorner[h.idx()] = c;
+            ++c;
+        }
+    }
+
+    // a halfedge pointing to corner c is opposite to corner next(c)
+    for (auto f : mesh.faces())
+    {
+        for (auto h : mesh.halfedges(f))
+        {
+            const Halfedge o = mesh.opposite_halfedge(h);
+            if (!mesh.is_boundary(o))
+                opposite_[next(hcorner[h.idx()])] = next(hcorner[o.idx()]);
+        }
+    }
+
+    for (auto v : mesh.vertices())
+    {
+        Halfedge h = mesh.halfedge(v);
+        if (!h.is_valid())
+            continue;
+
+        // first face counter-clockwise from the boundary
+        if (mesh.is_boundary(h))
+            h = mesh.ccw_rotated_halfedge(h);
+
+        vcorner_[v.idx()] = hcorner[mesh.prev_halfedge(h).idx()];
+    }
+}
+
+} // namespace pmp
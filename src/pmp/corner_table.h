@@ -0,0 +1,97 @@
+// Copyright 2023 the Polygon Mesh Processing Library developers.
+// Distributed under a MIT-style license, see LICENSE.txt for details.
+
+#pragma once
+
+#include <vector>
+
+#include "pmp/surface_mesh.h"
+
+namespace pmp {
+
+//! \brief A compact, read-only connectivity representation for triangle meshes.
+//! \details The corner table stores three corners per triangle. Each corner
+//! only keeps the index of its vertex and the index of its opposite corner,
+//! i.e., 8 bytes per corner compared to 16 bytes per halfedge (and twice as
+//! many halfedges as corners) in SurfaceMesh. Next and previous corners are
+//! implicit, since the corners of face \c f are stored at indices \c 3f,
+//! \c 3f+1, and \c 3f+2. Face and vertex indices are identical to the ones of
+//! the SurfaceMesh the table was built from.
+//!
+//! Use this class for read-mostly algorithms that only need to traverse the
+//! connectivity. The corner table is a snapshot and does not reflect later
+//! changes of the mesh.
+//! \ingroup core
+class CornerTable
+{
+public:
+    //! \brief Build the corner table for \p mesh.
+    //! \pre \p mesh has to be a triangle mesh without deleted elements.
+    //! \throw InvalidInputException if the precondition is violated.
+    explicit CornerTable(const SurfaceMesh& mesh);
+
+    //! \return number of corners, i.e., three times the number of faces
+    size_t n_corners() const { return vertex_.size(); }
+
+    //! \return number of faces
+    size_t n_faces() const { return vertex_.size() / 3; }
+
+    //! \return number of vertices
+    size_t n_vertices() const { return vcorner_.size(); }
+
+    //! \return the vertex of corner \p c
+    Vertex vertex(IndexType c) const { return Vertex(vertex_[c]); }
+
+    //! \return the face containing corner \p c
+    static Face face(IndexType c) { return Face(c / 3); }
+
+    //! \return the \p i'th corner of face \p f. \p i has to be 0, 1, or 2.
+    static IndexType corner(Face f, unsigned int i)
+    {
+        return 3 * f.idx() + i;
+    }
+
+    //! \return the next corner within the face of \p c
+    static IndexType next(IndexType c) { return (c % 3 == 2) ? c - 2 : c + 1; }
+
+    //! \return the previous corner within the face of \p c
+    static IndexType prev(IndexType c) { return (c % 3 == 0) ? c + 2 : c - 1; }
+
+    //! \return the corner facing \p c across the edge opposite to \p c,
+    //! or PMP_MAX_INDEX if that edge is a boundary edge.
+    IndexType opposite(IndexType c) const { return opposite_[c]; }
+
+    //! \return whether the edge opposite to corner \p c is a boundary edge
+    bool is_boundary(IndexType c) const
+    {
+        return opposite_[c] == PMP_MAX_INDEX;
+    }
+
+    //! \return the corner of vertex(\p c) in the next face counter-clockwise
+    //! around that vertex, or PMP_MAX_INDEX if there is no such face.
+    IndexType swing(IndexType c) const
+    {
+        const IndexType o = opposite_[next(c)];
+        return o == PMP_MAX_INDEX ? o : next(o);
+    }
+
+    //! \return a corner of vertex \p v or PMP_MAX_INDEX for isolated
+    //! vertices. For boundary vertices this is the first corner when swinging
+    //! counter-clockwise, such that swing() enumerates all incident corners.
+    IndexType corner(Vertex v) const { return vcorner_[v.idx()]; }
+
+    //! \return the approximate number of bytes used by the corner table
+    size_t memory_size() const
+    {
+        return sizeof(IndexType) *
+               (vertex_.capacity() + opposite_.capacity() +
+                vcorner_.capacity());
+    }
+
+private:
+    std::vector<IndexType> vertex_;   // vertex of each corner
+    std::vector<IndexType> opposite_; // opposite corner of each corner
+    std::vector<IndexType> vcorner_;  // one corner per vertex
+};
+
+} // namespace pmp
@@ -52,6 +52,15 @@ public:
     IOException(const std::string& what) : std::runtime_error(what) {}
 };
 
+//! \brief Exception indicating that an operation has been canceled.
+//! \details Thrown by algorithms that poll a Progress object once it has
+//! been canceled or its deadline has passed.
+class CanceledException : public std::runtime_error
+{
+public:
+    CanceledException(const std::string& what) : std::runtime_error(what) {}
+};
+
 //! \brief Exception indicating an OpenGL error.
 class GLException : public std::runtime_error
 {
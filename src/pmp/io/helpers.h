@@ -3,6 +3,7 @@
 
 #pragma once
 
+#include <cstddef>
 #include <cstdio>
 
 template <typename T>
@@ -16,3 +17,16 @@ void tfwrite(FILE* out, const T& t)
 {
     [[maybe_unused]] auto n_items = fwrite((char*)&t, 1, sizeof(t), out);
 }
+
+// number of bytes from the current position to the end of the file, zero if
+// it cannot be determined, to bound counts read from a file header
+inline size_t remaining_bytes(FILE* in)
+{
+    const auto pos = ftell(in);
+    if (pos < 0 || fseek(in, 0, SEEK_END) != 0)
+        return 0;
+    const auto end = ftell(in);
+    if (fseek(in, pos, SEEK_SET) != 0 || end < pos)
+        return 0;
+    return size_t(end - pos);
+}
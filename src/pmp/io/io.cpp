@@ -3,12 +3,16 @@
 
 #include "pmp/io/io.h"
 
+#include "pmp/io/read_glb.h"
 #include "pmp/io/read_obj.h"
 #include "pmp/io/read_off.h"
+#include "pmp/io/read_ply.h"
 #include "pmp/io/read_pmp.h"
 #include "pmp/io/read_stl.h"
+#include "pmp/io/write_glb.h"
 #include "pmp/io/write_obj.h"
 #include "pmp/io/write_off.h"
+#include "pmp/io/write_ply.h"
 #include "pmp/io/write_pmp.h"
 #include "pmp/io/write_stl.h"
 
@@ -23,10 +27,14 @@ void read(SurfaceMesh& mesh, const std::filesystem::path& file)
     auto ext = file.extension().string();
     std::transform(ext.begin(), ext.end(), ext.begin(), ::tolower);
 
-    if (ext == ".obj")
+    if (ext == ".glb")
+        read_glb(mesh, file);
+    else if (ext == ".obj")
         read_obj(mesh, file);
     else if (ext == ".off")
         read_off(mesh, file);
+    else if (ext == ".ply")
+        read_ply(mesh, file);
     else if (ext == ".pmp")
         read_pmp(mesh, file);
     else if (ext == ".stl")
@@ -42,10 +50,14 @@ void write(const SurfaceMesh& mesh, const std::filesystem::path& file,
     std::transform(ext.begin(), ext.end(), ext.begin(), tolower);
 
     // extension determines reader
-    if (ext == ".obj")
+    if (ext == ".glb")
+        write_glb(mesh, file, flags);
+    else if (ext == ".obj")
         write_obj(mesh, file, flags);
     else if (ext == ".off")
         write_off(mesh, file, flags);
+    else if (ext == ".ply")
+        write_ply(mesh, file, flags);
     else if (ext == ".pmp")
         write_pmp(mesh, file, flags);
     else if (ext == ".stl")
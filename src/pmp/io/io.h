@@ -16,13 +16,16 @@ namespace pmp {
 //!
 //! Format | ASCII | Binary | Normals | Colors | Texcoords
 //! -------|-------|--------|---------|--------|----------
+//! GLB    | no    | yes    | b       | b      | b
 //! OBJ    | yes   | no     | a       | no     | no
 //! OFF    | yes   | yes    | a / b   | a      | a / b
+//! PLY    | yes   | yes    | a / b   | a / b  | a / b
 //! PMP    | no    | yes    | no      | no     | no
 //! STL    | yes   | yes    | no      | no     | no
 //!
 //! In addition, the OBJ and PMP formats support reading per-halfedge
-//! texture coordinates.
+//! texture coordinates. Further scalar PLY vertex and face properties are
+//! read into properties of the matching type, e.g., \c v:quality.
 //! \ingroup io
 void read(SurfaceMesh& mesh, const std::filesystem::path& file);
 
@@ -32,13 +35,20 @@ void read(SurfaceMesh& mesh, const std::filesystem::path& file);
 //!
 //! Format | ASCII | Binary | Normals | Colors | Texcoords
 //! -------|-------|--------|---------|--------|----------
+//! GLB    | no    | yes    | b       | b      | b
 //! OBJ    | yes   | no     | a       | no     | no
 //! OFF    | yes   | yes    | a       | a      | a
+//! PLY    | yes   | yes    | a / b   | a / b  | a / b
 //! PMP    | no    | yes    | no      | no     | no
 //! STL    | yes   | yes    | no      | no     | no
 //!
 //! In addition, the OBJ and PMP formats support writing per-halfedge
-//! texture coordinates.
+//! texture coordinates. The PLY format writes all further vertex and face
+//! properties of arithmetic or vector type, in little or big endian byte
+//! order, see IOFlags::use_big_endian. The GLB format writes an indexed
+//! triangle list, polygons are triangulated, and optionally stores positions,
+//! normals, colors, and texture coordinates as 8 or 16 bit integers using
+//! the \c KHR_mesh_quantization extension, see IOFlags::use_quantization.
 //! \ingroup io
 void write(const SurfaceMesh& mesh, const std::filesystem::path& file,
            const IOFlags& flags = IOFlags());
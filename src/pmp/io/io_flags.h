@@ -10,6 +10,8 @@ namespace pmp {
 struct IOFlags
 {
     bool use_binary = false;             //!< Read / write binary format.
+    bool use_big_endian = false;         //!< Write big endian binary PLY.
+    bool use_quantization = false;       //!< Write quantized glTF attributes.
     bool use_vertex_normals = false;     //!< Read / write vertex normals.
     bool use_vertex_colors = false;      //!< Read / write vertex colors.
     bool use_vertex_texcoords = false;   //!< Read / write vertex texcoords.
@@ -0,0 +1,209 @@
+// Copyright 2023 the Polygon Mesh Processing Library developers.
+// Distributed under a MIT-style license, see LICENSE.txt for details.
+
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <string>
+
+namespace pmp {
+
+// scalar types of PLY properties
+enum class PlyType
+{
+    Int8,
+    UInt8,
+    Int16,
+    UInt16,
+    Int32,
+    UInt32,
+    Float32,
+    Float64
+};
+
+// size of a value of type t in bytes
+inline size_t ply_size(PlyType t)
+{
+    switch (t)
+    {
+        case PlyType::Int8:
+        case PlyType::UInt8:
+            return 1;
+        case PlyType::Int16:
+        case PlyType::UInt16:
+            return 2;
+        case PlyType::Int32:
+        case PlyType::UInt32:
+        case PlyType::Float32:
+            return 4;
+        case PlyType::Float64:
+            return 8;
+    }
+    return 0;
+}
+
+// name of type t in a PLY header
+inline const char* ply_name(PlyType t)
+{
+    switch (t)
+    {
+        case PlyType::Int8:
+            return "char";
+        case PlyType::UInt8:
+            return "uchar";
+        case PlyType::Int16:
+            return "short";
+        case PlyType::UInt16:
+            return "ushort";
+        case PlyType::Int32:
+            return "int";
+        case PlyType::UInt32:
+            return "uint";
+        case PlyType::Float32:
+            return "float";
+        case PlyType::Float64:
+            return "double";
+    }
+    return "";
+}
+
+// parse a type name of a PLY header, false if unknown
+inline bool parse_ply_type(const std::string& s, PlyType& t)
+{
+    if (s == "char" || s == "int8")
+        t = PlyType::Int8;
+    else if (s == "uchar" || s == "uint8")
+        t = PlyType::UInt8;
+    else if (s == "short" || s == "int16")
+        t = PlyType::Int16;
+    else if (s == "ushort" || s == "uint16")
+        t = PlyType::UInt16;
+    else if (s == "int" || s == "int32")
+        t = PlyType::Int32;
+    else if (s == "uint" || s == "uint32")
+        t = PlyType::UInt32;
+    else if (s == "float" || s == "float32")
+        t = PlyType::Float32;
+    else if (s == "double" || s == "float64")
+        t = PlyType::Float64;
+    else
+        return false;
+    return true;
+}
+
+// whether the host stores values in big endian byte order
+inline bool is_big_endian()
+{
+    const uint16_t one = 1;
+    unsigned char first;
+    std::memcpy(&first, &one, 1);
+    return first == 0;
+}
+
+// convert the value of type t at src to double, swapping its bytes if needed
+inline double ply_load(const char* src, PlyType t, bool swap)
+{
+    char bytes[8];
+    const auto n = ply_size(t);
+    std::memcpy(bytes, src, n);
+    if (swap)
+        std::reverse(bytes, bytes + n);
+
+    auto load = [&](auto value) {
+        std::memcpy(&value, bytes, sizeof(value));
+        return double(value);
+    };
+    switch (t)
+    {
+        case PlyType::Int8:
+            return load(int8_t());
+        case PlyType::UInt8:
+            return load(uint8_t());
+        case PlyType::Int16:
+            return load(int16_t());
+        case PlyType::UInt16:
+            return load(uint16_t());
+        case PlyType::Int32:
+            return load(int32_t());
+        case PlyType::UInt32:
+            return load(uint32_t());
+        case PlyType::Float32:
+            return load(float());
+        case PlyType::Float64:
+            return load(double());
+    }
+    return 0.0;
+}
+
+// whether value can be stored as type t, infinity and NaN only as floats
+inline bool ply_in_range(double value, PlyType t)
+{
+    auto in_range = [&](auto v) {
+        using T = decltype(v);
+        return value >= double(std::numeric_limits<T>::lowest()) &&
+               value <= double(std::numeric_limits<T>::max());
+    };
+    switch (t)
+    {
+        case PlyType::Int8:
+            return in_range(int8_t());
+        case PlyType::UInt8:
+            return in_range(uint8_t());
+        case PlyType::Int16:
+            return in_range(int16_t());
+        case PlyType::UInt16:
+            return in_range(uint16_t());
+        case PlyType::Int32:
+            return in_range(int32_t());
+        case PlyType::UInt32:
+            return in_range(uint32_t());
+        case PlyType::Float32:
+            return !std::isfinite(value) || in_range(float());
+        case PlyType::Float64:
+            return true;
+    }
+    return false;
+}
+
+// store value as type t at dst, swapping its bytes if needed
+inline void ply_store(char* dst, PlyType t, double value, bool swap)
+{
+    auto store = [&](auto v) {
+        std::memcpy(dst, &v, sizeof(v));
+        if (swap)
+            std::reverse(dst, dst + sizeof(v));
+    };
+    switch (t)
+    {
+        case PlyType::Int8:
+            store(int8_t(value));
+            break;
+        case PlyType::UInt8:
+            store(uint8_t(value));
+            break;
+        case PlyType::Int16:
+            store(int16_t(value));
+            break;
+        case PlyType::UInt16:
+            store(uint16_t(value));
+            break;
+        case PlyType::Int32:
+            store(int32_t(value));
+            break;
+        case PlyType::UInt32:
+            store(uint32_t(value));
+            break;
+        case PlyType::Float32:
+            store(float(value));
+            break;
+        case PlyType::Float64:
+            store(double(value));
+            break;
+    }
+}
+
+} // namespace pmp
@@ -0,0 +1,623 @@
+// Copyright 2023 the Polygon Mesh Processing Library developers.
+// Distributed under a MIT-style license, see LICENSE.txt for details.
+
+#include "pmp/io/read_glb.h"
+
+#include <algorithm>
+#include <cctype>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "pmp/exceptions.h"
+
+namespace pmp {
+namespace {
+
+// a parsed JSON value, object members are stored in keys and values
+struct JsonValue
+{
+    enum Type
+    {
+        Null,
+        Bool,
+        Number,
+        String,
+        Array,
+        Object
+    };
+
+    Type type = Null;
+    double number = 0;
+    std::string string;
+    std::vector<std::string> keys;
+    std::vector<JsonValue> values;
+
+    // member key of an object, nullptr if missing
+    const JsonValue* find(const std::string& key) const
+    {
+        for (size_t i = 0; i < keys.size(); ++i)
+            if (keys[i] == key)
+                return &values[i];
+        return nullptr;
+    }
+
+    // number member key of an object, or fallback if missing
+    double get(const std::string& key, double fallback) const
+    {
+        const auto* value = find(key);
+        return value && value->type == Number ? value->number : fallback;
+    }
+
+    // element i of an array
+    const JsonValue& at(size_t i) const
+    {
+        if (type != Array || i >= values.size())
+            throw IOException("Invalid glTF index");
+        return values[i];
+    }
+};
+
+// \brief a non-negative integer of at most max, e.g., an index or a count
+// \details Rejects numbers that cannot be converted to size_t exactly. The
+// default limit of 2^53 keeps sums of two offsets from overflowing.
+size_t to_size(double value, double max = 9007199254740992.0)
+{
+    if (!(value >= 0 && value <= max) || value != std::floor(value))
+        throw IOException("Invalid glTF number");
+    return size_t(value);
+}
+
+// recursive descent parser for the JSON chunk
+class JsonParser
+{
+public:
+    JsonParser(const char* begin, const char* end) : pos_(begin), end_(end) {}
+
+    JsonValue parse()
+    {
+        auto value = parse_value();
+        skip_space();
+        if (pos_ != end_)
+            fail();
+        return value;
+    }
+
+private:
+    [[noreturn]] static void fail()
+    {
+        throw IOException("Failed to parse glTF JSON");
+    }
+
+    void skip_space()
+    {
+        while (pos_ != end_ && std::isspace(static_cast<unsigned char>(*pos_)))
+            ++pos_;
+    }
+
+    bool consume(char c)
+    {
+        skip_space();
+        if (pos_ != end_ && *pos_ == c)
+        {
+            ++pos_;
+            return true;
+        }
+        return false;
+    }
+
+    void expect(char c)
+    {
+        if (!consume(c))
+            fail();
+    }
+
+    bool consume_literal(const char* literal)
+    {
+        const auto n = std::strlen(literal);
+        if (size_t(end_ - pos_) < n || std::strncmp(pos_, literal, n) != 0)
+            return false;
+        pos_ += n;
+        return true;
+    }
+
+    std::string parse_string()
+    {
+        expect('"');
+        std::string result;
+        while (pos_ != end_ && *pos_ != '"')
+        {
+            char c = *pos_++;
+            if (c == '\\')
+            {
+                if (pos_ == end_)
+                    fail();
+                c = *pos_++;
+                switch (c)
+                {
+                    case 'b':
+                        c = '\b';
+                        break;
+                    case 'f':
+                        c = '\f';
+                        break;
+                    case 'n':
+                        c = '\n';
+                        break;
+                    case 'r':
+                        c = '\r';
+                        break;
+                    case 't':
+                        c = '\t';
+                        break;
+                    case 'u':
+                        // names used by the reader are ASCII
+                        if (end_ - pos_ < 4)
+                            fail();
+                        pos_ += 4;
+                        c = '?';
+                        break;
+                    default:
+                        break;
+                }
+            }
+            result += c;
+        }
+        expect('"');
+        return result;
+    }
+
+    JsonValue parse_value()
+    {
+        skip_space();
+        if (pos_ == end_)
+            fail();
+
+        JsonValue value;
+        if (*pos_ == '{')
+        {
+            ++pos_;
+            value.type = JsonValue::Object;
+            if (consume('}'))
+                return value;
+            do
+            {
+                skip_space();
+                value.keys.push_back(parse_string());
+                expect(':');
+                value.values.push_back(parse_value());
+            } while (consume(','));
+            expect('}');
+        }
+        else if (*pos_ == '[')
+        {
+            ++pos_;
+            value.type = JsonValue::Array;
+            if (consume(']'))
+                return value;
+            do
+            {
+                value.values.push_back(parse_value());
+            } while (consume(','));
+            expect(']');
+        }
+        else if (*pos_ == '"')
+        {
+            value.type = JsonValue::String;
+            value.string = parse_string();
+        }
+        else if (consume_literal("true"))
+        {
+            value.type = JsonValue::Bool;
+            value.number = 1;
+        }
+        else if (consume_literal("false"))
+        {
+            value.type = JsonValue::Bool;
+        }
+        else if (consume_literal("null"))
+        {
+            value.type = JsonValue::Null;
+        }
+        else
+        {
+            // the chunk is not null-terminated, copy the number
+            const char* begin = pos_;
+            while (pos_ != end_ &&
+                   (std::isdigit(static_cast<unsigned char>(*pos_)) ||
+                    (*pos_ && std::strchr("+-.eE", *pos_))))
+                ++pos_;
+            const std::string number(begin, pos_);
+            char* number_end;
+            value.type = JsonValue::Number;
+            value.number = std::strtod(number.c_str(), &number_end);
+            if (number.empty() || *number_end != '\0')
+                fail();
+        }
+        return value;
+    }
+
+    const char* pos_;
+    const char* end_;
+};
+
+// size in bytes of a glTF component type
+size_t component_size(int component_type)
+{
+    switch (component_type)
+    {
+        case 5120: // BYTE
+        case 5121: // UNSIGNED_BYTE
+            return 1;
+        case 5122: // SHORT
+        case 5123: // UNSIGNED_SHORT
+            return 2;
+        case 5125: // UNSIGNED_INT
+        case 5126: // FLOAT
+            return 4;
+    }
+    throw IOException("Invalid glTF component type");
+}
+
+// load a component and map normalized integers to [0,1] or [-1,1]
+double load_component(const char* src, int component_type, bool normalized)
+{
+    auto load = [&](auto value, double max) {
+        std::memcpy(&value, src, sizeof(value));
+        return normalized ? std::max(double(value) / max, -1.0)
+                          : double(value);
+    };
+    switch (component_type)
+    {
+        case 5120:
+            return load(int8_t(), 127.0);
+        case 5121:
+            return load(uint8_t(), 255.0);
+        case 5122:
+            return load(int16_t(), 32767.0);
+        case 5123:
+            return load(uint16_t(), 65535.0);
+        case 5125:
+            return load(uint32_t(), 4294967295.0);
+        default:
+            return load(float(), 1.0);
+    }
+}
+
+// the glTF document and its binary chunk
+struct Gltf
+{
+    JsonValue json;
+    std::vector<char> bin;
+
+    // components of the elements of an accessor, n per element
+    std::vector<double> read(size_t accessor, size_t& n) const
+    {
+        static const std::pair<const char*, size_t> types[] = {
+            {"SCALAR", 1}, {"VEC2", 2}, {"VEC3", 3}, {"VEC4", 4}};
+
+        const auto& a = json.find("accessors")->at(accessor);
+        if (a.find("sparse"))
+            throw IOException("Sparse glTF accessors not supported");
+        const auto* type = a.find("type");
+        n = 0;
+        for (const auto& [name, size] : types)
+            if (type && type->string == name)
+                n = size;
+        if (n == 0)
+            throw IOException("Unsupported glTF accessor type");
+
+        const auto component_type =
+            int(to_size(a.get("componentType", 0), 5126));
+        const auto size = component_size(component_type);
+        const auto element_size = n * size;
+        const auto count = to_size(a.get("count", 0));
+        const auto* normalized = a.find("normalized");
+        const bool is_normalized = normalized && normalized->number != 0;
+
+        // an accessor without buffer view holds zeros, bound it the same way
+        if (!a.find("bufferView"))
+        {
+            if (count > bin.size() / element_size)
+                throw IOException("glTF accessor exceeds buffer");
+            return std::vector<double>(count * n, 0.0);
+        }
+
+        const auto* views = json.find("bufferViews");
+        if (!views)
+            throw IOException("Missing glTF buffer views");
+        const auto& view = views->at(to_size(a.get("bufferView", 0)));
+        if (view.get("buffer", 0) != 0)
+            throw IOException("External glTF buffers not supported");
+        const auto view_offset = to_size(view.get("byteOffset", 0));
+        const auto view_length =
+            to_size(view.get("byteLength", double(bin.size())));
+        const auto end = std::min(bin.size(), view_offset + view_length);
+        const auto offset = view_offset + to_size(a.get("byteOffset", 0));
+        const auto stride =
+            to_size(view.get("byteStride", double(element_size)));
+        if (stride < element_size)
+            throw IOException("Invalid glTF byte stride");
+
+        // the last element has to end before the end of the buffer view
+        if (count && (offset > end || end - offset < element_size ||
+                      count - 1 > (end - offset - element_size) / stride))
+            throw IOException("glTF accessor exceeds buffer");
+
+        std::vector<double> result(count * n);
+        for (size_t i = 0; i < count; ++i)
+            for (size_t k = 0; k < n; ++k)
+                result[i * n + k] =
+                    load_component(bin.data() + offset + i * stride + k * size,
+                                   component_type, is_normalized);
+        return result;
+    }
+};
+
+// transformation of a node, from its matrix or translation, rotation, scale
+dmat4 node_transform(const JsonValue& node)
+{
+    dmat4 m = dmat4::identity();
+    if (const auto* matrix = node.find("matrix"))
+    {
+        for (unsigned int i = 0; i < 16; ++i)
+            m[i] = matrix->at(i).number;
+        return m;
+    }
+    if (const auto* t = node.find("translation"))
+        m = translation_matrix(
+            dvec3(t->at(0).number, t->at(1).number, t->at(2).number));
+    if (const auto* r = node.find("rotation"))
+        m = m * rotation_matrix(dvec4(r->at(0).number, r->at(1).number,
+                                      r->at(2).number, r->at(3).number));
+    if (const auto* s = node.find("scale"))
+        m = m * scaling_matrix(
+                    dvec3(s->at(0).number, s->at(1).number, s->at(2).number));
+    return m;
+}
+
+// \brief cofactor matrix of the linear part of m
+// \details Transforms normals like the inverse transpose up to scaling, but
+// does not fail for the tiny scaling of dequantization matrices.
+dmat3 normal_matrix(const dmat4& m)
+{
+    const auto l = linear_part(m);
+    const dvec3 c[3] = {dvec3(l(0, 0), l(1, 0), l(2, 0)),
+                        dvec3(l(0, 1), l(1, 1), l(2, 1)),
+                        dvec3(l(0, 2), l(1, 2), l(2, 2))};
+    const double sign = determinant(l) < 0 ? -1.0 : 1.0;
+    dmat3 result;
+    for (unsigned int j = 0; j < 3; ++j)
+    {
+        const auto column = sign * cross(c[(j + 1) % 3], c[(j + 2) % 3]);
+        for (unsigned int i = 0; i < 3; ++i)
+            result(i, j) = column[i];
+    }
+    return result;
+}
+
+// check the number of components of the elements of an attribute
+void check_components(size_t n, size_t min, size_t max, const char* attribute)
+{
+    if (n < min || n > max)
+        throw IOException(std::string("Invalid glTF accessor type for ") +
+                          attribute);
+}
+
+// add the triangle and point primitives of a mesh, transformed by m
+void read_primitives(SurfaceMesh& mesh, const Gltf& gltf,
+                     const JsonValue& gltf_mesh, const dmat4& m)
+{
+    const auto* primitives = gltf_mesh.find("primitives");
+    if (!primitives)
+        return;
+    const auto nm = normal_matrix(m);
+
+    for (const auto& primitive : primitives->values)
+    {
+        // triangles, or points that only add vertices
+        const auto mode = primitive.get("mode", 4);
+        if (mode != 4 && mode != 0)
+            continue;
+        const auto* attributes = primitive.find("attributes");
+        const auto* position =
+            attributes ? attributes->find("POSITION") : nullptr;
+        if (!position)
+            continue;
+
+        size_t n;
+        const auto positions = gltf.read(to_size(position->number), n);
+        check_components(n, 3, 3, "POSITION");
+        const auto n_vertices = positions.size() / n;
+        const auto offset = mesh.vertices_size();
+        for (size_t i = 0; i < n_vertices; ++i)
+        {
+            const dvec3 p(positions[i * n], positions[i * n + 1],
+                          positions[i * n + 2]);
+            mesh.add_vertex(Point(affine_transform(m, p)));
+        }
+
+        if (const auto* normal = attributes->find("NORMAL"))
+        {
+            const auto values = gltf.read(to_size(normal->number), n);
+            check_components(n, 3, 3, "NORMAL");
+            auto normals = mesh.vertex_property<Normal>("v:normal");
+            for (size_t i = 0; i < n_vertices && i * n + 2 < values.size();
+                 ++i)
+            {
+                const dvec3 v(values[i * n], values[i * n + 1],
+                              values[i * n + 2]);
+                normals[Vertex(offset + i)] = Normal(normalize(nm * v));
+            }
+        }
+
+        if (const auto* texcoord = attributes->find("TEXCOORD_0"))
+        {
+            const auto values = gltf.read(to_size(texcoord->number), n);
+            check_components(n, 2, 2, "TEXCOORD_0");
+            auto texcoords = mesh.vertex_property<TexCoord>("v:tex");
+            for (size_t i = 0; i < n_vertices && i * n + 1 < values.size();
+                 ++i)
+                texcoords[Vertex(offset + i)] =
+                    TexCoord(values[i * n], 1 - values[i * n + 1]);
+        }
+
+        if (const auto* color = attributes->find("COLOR_0"))
+        {
+            const auto values = gltf.read(to_size(color->number), n);
+            check_components(n, 3, 4, "COLOR_0");
+            auto colors = mesh.vertex_property<Color>("v:color");
+            for (size_t i = 0; i < n_vertices && i * n + 2 < values.size();
+                 ++i)
+                colors[Vertex(offset + i)] = Color(
+                    values[i * n], values[i * n + 1], values[i * n + 2]);
+        }
+
+        if (mode == 0)
+            continue;
+
+        std::vector<double> indices;
+        if (const auto* accessor = primitive.find("indices"))
+        {
+            indices = gltf.read(to_size(accessor->number), n);
+            check_components(n, 1, 1, "indices");
+        }
+        else
+            for (size_t i = 0; i < n_vertices; ++i)
+                indices.push_back(double(i));
+
+        for (size_t i = 0; i + 2 < indices.size(); i += 3)
+        {
+            std::vector<Vertex> vertices;
+            for (size_t k = 0; k < 3; ++k)
+            {
+                if (indices[i + k] < 0 || indices[i + k] >= n_vertices)
+                    throw IOException("Invalid index");
+                vertices.emplace_back(offset + size_t(indices[i + k]));
+            }
+
+            try
+            {
+                mesh.add_face(vertices);
+            }
+            catch (const TopologyException& e)
+            {
+                std::cerr << e.what() << std::endl;
+            }
+        }
+    }
+}
+
+// add the meshes of node i and its descendants, transformed by m and the
+// node transforms along the path
+void read_node(SurfaceMesh& mesh, const Gltf& gltf, size_t i, const dmat4& m,
+               size_t depth = 0)
+{
+    const auto& nodes = *gltf.json.find("nodes");
+    if (depth > nodes.values.size())
+        throw IOException("Cyclic glTF node hierarchy");
+
+    const auto& node = nodes.at(i);
+    const auto transform = m * node_transform(node);
+    if (const auto* index = node.find("mesh"))
+    {
+        const auto* meshes = gltf.json.find("meshes");
+        if (!meshes)
+            throw IOException("Missing glTF meshes");
+        read_primitives(mesh, gltf, meshes->at(to_size(index->number)),
+                        transform);
+    }
+    if (const auto* children = node.find("children"))
+        for (const auto& child : children->values)
+            read_node(mesh, gltf, to_size(child.number), transform, depth + 1);
+}
+
+} // namespace
+
+void read_glb(SurfaceMesh& mesh, const std::filesystem::path& file)
+{
+    std::ifstream ifs(file.string(), std::ios::binary);
+    if (!ifs)
+        throw IOException("Failed to open file: " + file.string());
+
+    // header with magic "glTF", version, and total length
+    uint32_t header[3];
+    ifs.read((char*)header, sizeof(header));
+    if (!ifs || header[0] != 0x46546C67)
+        throw IOException("Failed to parse GLB header");
+    if (header[1] != 2)
+        throw IOException("Unsupported glTF version");
+
+    // chunks
+    Gltf gltf;
+    std::vector<char> json;
+    uint32_t chunk[2];
+    while (ifs.read((char*)chunk, sizeof(chunk)))
+    {
+        std::vector<char> data(chunk[0]);
+        if (!ifs.read(data.data(), data.size()))
+            throw IOException("Unexpected end of GLB file");
+        if (chunk[1] == 0x4E4F534A && json.empty()) // "JSON"
+            json = std::move(data);
+        else if (chunk[1] == 0x004E4942 && gltf.bin.empty()) // "BIN\0"
+            gltf.bin = std::move(data);
+    }
+    if (json.empty())
+        throw IOException("Missing GLB JSON chunk");
+    gltf.json = JsonParser(json.data(), json.data() + json.size()).parse();
+
+    if (const auto* required = gltf.json.find("extensionsRequired"))
+        for (const auto& extension : required->values)
+            if (extension.string != "KHR_mesh_quantization")
+                throw IOException("Unsupported glTF extension: " +
+                                  extension.string);
+
+    const auto* meshes = gltf.json.find("meshes");
+    if (!meshes || !gltf.json.find("accessors"))
+        return;
+
+    // all meshes if no node instantiates one
+    const auto* nodes = gltf.json.find("nodes");
+    auto has_mesh = [](const auto& node) {
+        return node.find("mesh") != nullptr;
+    };
+    if (!nodes || std::none_of(nodes->values.begin(), nodes->values.end(),
+                               has_mesh))
+    {
+        for (const auto& gltf_mesh : meshes->values)
+            read_primitives(mesh, gltf, gltf_mesh, dmat4::identity());
+        return;
+    }
+
+    // root nodes of the default scene, or of all nodes without a parent
+    std::vector<size_t> roots;
+    if (const auto* scenes = gltf.json.find("scenes"))
+    {
+        const auto& scene = scenes->at(to_size(gltf.json.get("scene", 0)));
+        if (const auto* scene_nodes = scene.find("nodes"))
+            for (const auto& node : scene_nodes->values)
+                roots.push_back(to_size(node.number));
+    }
+    else
+    {
+        std::vector<bool> is_child(nodes->values.size(), false);
+        for (const auto& node : nodes->values)
+            if (const auto* children = node.find("children"))
+                for (const auto& child : children->values)
+                    if (const auto i = to_size(child.number);
+                        i < is_child.size())
+                        is_child[i] = true;
+        for (size_t i = 0; i < is_child.size(); ++i)
+            if (!is_child[i])
+                roots.push_back(i);
+    }
+
+    for (auto root : roots)
+        read_node(mesh, gltf, root, dmat4::identity());
+}
+
+} // namespace pmp
@@ -0,0 +1,605 @@
+// Copyright 2023 the Polygon Mesh Processing Library developers.
+// Distributed under a MIT-style license, see LICENSE.txt for details.
+
+#include "pmp/io/read_ply.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <iostream>
+#include <limits>
+#include <optional>
+#include <sstream>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+#include "pmp/io/ply.h"
+#include "pmp/exceptions.h"
+
+namespace pmp {
+namespace {
+
+enum class PlyFormat
+{
+    Ascii,
+    BinaryLittleEndian,
+    BinaryBigEndian
+};
+
+struct PlyProperty
+{
+    std::string name;
+    PlyType type;
+    bool is_list = false;
+    PlyType count_type = PlyType::UInt8;
+    size_t offset = 0; // of scalar properties in a record
+};
+
+struct PlyElement
+{
+    std::string name;
+    size_t count = 0;
+    std::vector<PlyProperty> properties;
+    size_t record_size = 0; // bytes of the scalar properties
+    bool has_lists = false;
+
+    const PlyProperty* find(const std::string& property) const
+    {
+        for (const auto& p : properties)
+            if (p.name == property)
+                return &p;
+        return nullptr;
+    }
+};
+
+// destination of the values of a scalar property
+struct PlyColumn
+{
+    size_t offset;      // in the record
+    PlyType type;       // in the record
+    char* data;         // of the mesh property
+    size_t stride;      // of the mesh property
+    PlyType data_type;  // of the mesh property
+    double scale = 1.0; // applied if types differ
+};
+
+constexpr PlyType scalar_type =
+    sizeof(Scalar) == 8 ? PlyType::Float64 : PlyType::Float32;
+
+// reads the body of a PLY file record by record or in blocks of records
+class PlyReader
+{
+public:
+    PlyReader(FILE* in, PlyFormat format)
+        : in_(in),
+          ascii_(format == PlyFormat::Ascii),
+          swap_(!ascii_ &&
+                (format == PlyFormat::BinaryBigEndian) != is_big_endian())
+    {
+    }
+
+    bool is_ascii() const { return ascii_; }
+
+    bool swaps() const { return swap_; }
+
+    // n contiguous bytes of binary data
+    const char* take(size_t n)
+    {
+        if (end_ - pos_ < n)
+        {
+            // move remaining bytes to the front and refill
+            std::copy(buffer_.begin() + pos_, buffer_.begin() + end_,
+                      buffer_.begin());
+            end_ -= pos_;
+            pos_ = 0;
+            if (buffer_.size() < n)
+                buffer_.resize(n);
+            end_ += fread(buffer_.data() + end_, 1, buffer_.size() - end_, in_);
+            if (end_ < n)
+                throw IOException("Unexpected end of PLY file");
+        }
+        const char* result = buffer_.data() + pos_;
+        pos_ += n;
+        return result;
+    }
+
+    // read a single value of type t
+    double read(PlyType t)
+    {
+        if (!ascii_)
+            return ply_load(take(ply_size(t)), t, swap_);
+
+        double value;
+        if (fscanf(in_, "%lf", &value) != 1)
+            throw IOException("Failed to parse PLY data");
+        return value;
+    }
+
+    // \brief read a record of element e
+    // \details Stores the scalar properties in native byte order in record.
+    // The values of list property \p indices are appended to \p values.
+    void read_record(const PlyElement& e, char* record,
+                     const PlyProperty* indices, std::vector<int>& values)
+    {
+        for (const auto& p : e.properties)
+        {
+            if (p.is_list)
+            {
+                const auto count = read(p.count_type);
+                if (!(count >= 0 && count <= max_list_size))
+                    throw IOException("Invalid PLY list size");
+                const auto n = size_t(count);
+                for (size_t i = 0; i < n; ++i)
+                {
+                    const auto value = read(p.type);
+                    if (&p != indices)
+                        continue;
+                    if (!(value >= 0 && value <= max_index))
+                        throw IOException("Invalid index");
+                    values.push_back(int(value));
+                }
+            }
+            else
+            {
+                // ASCII values may not fit their type
+                const auto value = read(p.type);
+                if (!ply_in_range(value, p.type))
+                    throw IOException("PLY value out of range: " + p.name);
+                ply_store(record + p.offset, p.type, value, false);
+            }
+        }
+    }
+
+private:
+    static constexpr double max_list_size =
+        std::numeric_limits<uint32_t>::max();
+    static constexpr double max_index = std::numeric_limits<int>::max();
+
+    FILE* in_;
+    bool ascii_;
+    bool swap_;
+    std::vector<char> buffer_ = std::vector<char>(1 << 20);
+    size_t pos_{0};
+    size_t end_{0};
+};
+
+// copy the columns of n records to the mesh properties, starting at index
+void copy_columns(const char* records, size_t n, size_t record_size,
+                  const std::vector<PlyColumn>& columns, size_t index,
+                  bool swap)
+{
+    for (const auto& c : columns)
+    {
+        const char* src = records + c.offset;
+        char* dst = c.data + index * c.stride;
+        const auto size = ply_size(c.type);
+        if (c.type == c.data_type && !swap)
+        {
+            for (size_t i = 0; i < n; ++i)
+                std::memcpy(dst + i * c.stride, src + i * record_size, size);
+        }
+        else
+        {
+            for (size_t i = 0; i < n; ++i)
+            {
+                auto value = ply_load(src + i * record_size, c.type, swap);
+                if (c.type != c.data_type)
+                    value *= c.scale;
+                ply_store(dst + i * c.stride, c.data_type, value, false);
+            }
+        }
+    }
+}
+
+// scale of color channels of type t to [0,1]
+double color_scale(PlyType t)
+{
+    if (t == PlyType::UInt8)
+        return 1.0 / 255.0;
+    if (t == PlyType::UInt16)
+        return 1.0 / 65535.0;
+    return 1.0;
+}
+
+// add a property of the C++ type matching p named prefix + p.name
+template <class Handle>
+bool add_custom_column(SurfaceMesh& mesh, const PlyProperty& p,
+                       const std::string& prefix,
+                       std::vector<PlyColumn>& columns)
+{
+    const auto name = prefix + p.name;
+    const auto& names = std::is_same_v<Handle, Vertex>
+                            ? mesh.vertex_properties()
+                            : mesh.face_properties();
+    if (std::find(names.begin(), names.end(), name) != names.end())
+        return false;
+
+    auto add = [&](auto value) {
+        using T = decltype(value);
+        char* data;
+        if constexpr (std::is_same_v<Handle, Vertex>)
+            data = (char*)mesh.add_vertex_property<T>(name).data();
+        else
+            data = (char*)mesh.add_face_property<T>(name).data();
+        columns.push_back({p.offset, p.type, data, sizeof(T), p.type});
+    };
+    switch (p.type)
+    {
+        case PlyType::Int8:
+            add(int8_t());
+            break;
+        case PlyType::UInt8:
+            add(uint8_t());
+            break;
+        case PlyType::Int16:
+            add(int16_t());
+            break;
+        case PlyType::UInt16:
+            add(uint16_t());
+            break;
+        case PlyType::Int32:
+            add(int32_t());
+            break;
+        case PlyType::UInt32:
+            add(uint32_t());
+            break;
+        case PlyType::Float32:
+            add(float());
+            break;
+        case PlyType::Float64:
+            add(double());
+            break;
+    }
+    return true;
+}
+
+// map the scalar properties of element e to mesh properties
+template <class Handle>
+std::vector<PlyColumn> map_columns(SurfaceMesh& mesh, const PlyElement& e)
+{
+    constexpr bool is_vertex = std::is_same_v<Handle, Vertex>;
+    std::vector<PlyColumn> columns;
+
+    // known vector-valued attributes
+    auto add_vector = [&](const char* name,
+                          std::initializer_list<std::initializer_list<
+                              const char*>>
+                              components,
+                          bool is_color) {
+        std::vector<const PlyProperty*> found;
+        for (auto alternatives : components)
+        {
+            const PlyProperty* p = nullptr;
+            for (auto alternative : alternatives)
+                if (!p)
+                    p = e.find(alternative);
+            if (!p || p->is_list)
+                return;
+            found.push_back(p);
+        }
+
+        char* data;
+        size_t stride;
+        if (found.size() == 2)
+        {
+            auto prop = mesh.vertex_property<TexCoord>(name);
+            data = (char*)prop.data();
+            stride = sizeof(TexCoord);
+        }
+        else if (is_vertex)
+        {
+            auto prop = mesh.vertex_property<Vector<Scalar, 3>>(name);
+            data = (char*)prop.data();
+            stride = sizeof(Vector<Scalar, 3>);
+        }
+        else
+        {
+            auto prop = mesh.face_property<Vector<Scalar, 3>>(name);
+            data = (char*)prop.data();
+            stride = sizeof(Vector<Scalar, 3>);
+        }
+
+        for (size_t k = 0; k < found.size(); ++k)
+        {
+            const auto* p = found[k];
+            auto scale = is_color ? color_scale(p->type) : 1.0;
+            columns.push_back({p->offset, p->type, data + k * sizeof(Scalar),
+                               stride, scalar_type, scale});
+        }
+    };
+
+    const std::string prefix = is_vertex ? "v:" : "f:";
+    if (is_vertex)
+    {
+        add_vector("v:point", {{"x"}, {"y"}, {"z"}}, false);
+        add_vector("v:normal", {{"nx"}, {"ny"}, {"nz"}}, false);
+        add_vector("v:color", {{"red"}, {"green"}, {"blue"}}, true);
+        add_vector("v:tex", {{"s", "u", "texture_u"}, {"t", "v", "texture_v"}},
+                   false);
+    }
+    else
+    {
+        add_vector("f:normal", {{"nx"}, {"ny"}, {"nz"}}, false);
+        add_vector("f:color", {{"red"}, {"green"}, {"blue"}}, true);
+    }
+
+    // remaining scalar properties
+    for (const auto& p : e.properties)
+    {
+        if (p.is_list)
+            continue;
+        bool is_mapped = false;
+        for (const auto& c : columns)
+            if (c.offset == p.offset)
+                is_mapped = true;
+        if (!is_mapped)
+            add_custom_column<Handle>(mesh, p, prefix, columns);
+    }
+
+    return columns;
+}
+
+PlyFormat read_header(FILE* in, std::vector<PlyElement>& elements)
+{
+    auto next_line = [&](std::string& line) {
+        line.clear();
+        int c;
+        while ((c = fgetc(in)) != EOF && c != '\n')
+            line += char(c);
+        if (!line.empty() && line.back() == '\r')
+            line.pop_back();
+        return c != EOF || !line.empty();
+    };
+
+    std::string line;
+    if (!next_line(line) || line != "ply")
+        throw IOException("Failed to parse PLY header");
+
+    std::optional<PlyFormat> format;
+    while (true)
+    {
+        if (!next_line(line))
+            throw IOException("Failed to parse PLY header");
+
+        std::istringstream iss(line);
+        std::string keyword;
+        iss >> keyword;
+
+        if (keyword == "end_header")
+            break;
+        else if (keyword == "format")
+        {
+            std::string name;
+            iss >> name;
+            if (name == "ascii")
+                format = PlyFormat::Ascii;
+            else if (name == "binary_little_endian")
+                format = PlyFormat::BinaryLittleEndian;
+            else if (name == "binary_big_endian")
+                format = PlyFormat::BinaryBigEndian;
+            else
+                throw IOException("Unknown PLY format: " + name);
+        }
+        else if (keyword == "element")
+        {
+            PlyElement e;
+            long long count;
+            iss >> e.name >> count;
+            if (iss.fail() || count < 0)
+                throw IOException("Failed to parse PLY element: " + line);
+            e.count = size_t(count);
+            elements.push_back(e);
+        }
+        else if (keyword == "property")
+        {
+            if (elements.empty())
+                throw IOException("PLY property without element: " + line);
+            auto& e = elements.back();
+
+            PlyProperty p;
+            std::string type;
+            iss >> type;
+            if (type == "list")
+            {
+                std::string count_type;
+                iss >> count_type >> type;
+                if (!parse_ply_type(count_type, p.count_type))
+                    throw IOException("Unknown PLY type: " + count_type);
+                p.is_list = true;
+                e.has_lists = true;
+            }
+            if (!parse_ply_type(type, p.type))
+                throw IOException("Unknown PLY type: " + type);
+            iss >> p.name;
+            if (!p.is_list)
+            {
+                p.offset = e.record_size;
+                e.record_size += ply_size(p.type);
+            }
+            e.properties.push_back(p);
+        }
+        // ignore comment, obj_info, and unknown keywords
+    }
+
+    if (!format)
+        throw IOException("Missing PLY format");
+    return *format;
+}
+
+// \brief check the element counts against the size of the file body
+// \details Each record takes at least one byte per ASCII value, or the size
+// of its scalar properties and list counts in binary, such that a corrupt
+// or truncated header fails before any vertices or faces are added.
+void check_counts(FILE* in, PlyFormat format,
+                  const std::vector<PlyElement>& elements)
+{
+    const auto body = ftell(in);
+    if (body < 0 || fseek(in, 0, SEEK_END) != 0)
+        throw IOException("Failed to determine PLY file size");
+    const auto end = ftell(in);
+    if (end < body || fseek(in, body, SEEK_SET) != 0)
+        throw IOException("Failed to determine PLY file size");
+
+    auto remaining = size_t(end - body);
+    for (const auto& e : elements)
+    {
+        size_t record_size = 0;
+        for (const auto& p : e.properties)
+        {
+            if (format == PlyFormat::Ascii)
+                record_size += 1;
+            else if (p.is_list)
+                record_size += ply_size(p.count_type);
+            else
+                record_size += ply_size(p.type);
+        }
+        record_size = std::max<size_t>(record_size, 1);
+        if (e.count > remaining / record_size)
+            throw IOException("PLY element count exceeds file size: " +
+                              e.name);
+        remaining -= e.count * record_size;
+    }
+}
+
+void read_vertices(SurfaceMesh& mesh, PlyReader& reader, const PlyElement& e)
+{
+    for (size_t i = 0; i < e.count; ++i)
+        mesh.add_vertex(Point(0, 0, 0));
+    const auto columns = map_columns<Vertex>(mesh, e);
+
+    if (reader.is_ascii() || e.has_lists)
+    {
+        std::vector<char> record(e.record_size);
+        std::vector<int> unused;
+        for (size_t i = 0; i < e.count; ++i)
+        {
+            reader.read_record(e, record.data(), nullptr, unused);
+            copy_columns(record.data(), 1, e.record_size, columns, i, false);
+        }
+        return;
+    }
+
+    if (e.record_size == 0)
+        return;
+
+    // tightly packed positions are copied in bulk
+    const auto* x = e.find("x");
+    const auto* y = e.find("y");
+    const auto* z = e.find("z");
+    const bool is_packed =
+        !reader.swaps() && x && y && z && x->type == scalar_type &&
+        y->type == scalar_type && z->type == scalar_type && x->offset == 0 &&
+        y->offset == sizeof(Scalar) && z->offset == 2 * sizeof(Scalar) &&
+        e.record_size == sizeof(Point);
+    char* points = (char*)mesh.positions().data();
+
+    // read blocks of records
+    const size_t block = std::max<size_t>(1, (1 << 16) / e.record_size);
+    for (size_t i = 0; i < e.count; i += block)
+    {
+        const auto n = std::min(block, e.count - i);
+        const char* records = reader.take(n * e.record_size);
+        if (is_packed)
+            std::memcpy(points + i * sizeof(Point), records,
+                        n * sizeof(Point));
+        else
+            copy_columns(records, n, e.record_size, columns, i,
+                         reader.swaps());
+    }
+}
+
+void read_faces(SurfaceMesh& mesh, PlyReader& reader, const PlyElement& e)
+{
+    const PlyProperty* indices = e.find("vertex_indices");
+    if (!indices)
+        indices = e.find("vertex_index");
+    if (!indices || !indices->is_list)
+        throw IOException("PLY faces without vertex indices");
+
+    // scalar properties of the faces that could be added
+    std::vector<char> records;
+    std::vector<char> record(e.record_size);
+    std::vector<int> values;
+    std::vector<Vertex> vertices;
+
+    const auto n_vertices = mesh.n_vertices();
+    for (size_t i = 0; i < e.count; ++i)
+    {
+        values.clear();
+        reader.read_record(e, record.data(), indices, values);
+
+        vertices.clear();
+        for (auto idx : values)
+        {
+            if (idx < 0 || size_t(idx) >= n_vertices)
+                throw IOException("Invalid index");
+            vertices.emplace_back(idx);
+        }
+
+        try
+        {
+            mesh.add_face(vertices);
+            records.insert(records.end(), record.begin(), record.end());
+        }
+        catch (const TopologyException& ex)
+        {
+            std::cerr << ex.what() << std::endl;
+        }
+    }
+
+    const auto columns = map_columns<Face>(mesh, e);
+    copy_columns(records.data(), mesh.n_faces(), e.record_size, columns, 0,
+                 false);
+}
+
+void skip_element(PlyReader& reader, const PlyElement& e)
+{
+    if (!reader.is_ascii() && !e.has_lists)
+    {
+        for (size_t i = 0; i < e.count; ++i)
+            reader.take(e.record_size);
+        return;
+    }
+
+    std::vector<char> record(e.record_size);
+    std::vector<int> unused;
+    for (size_t i = 0; i < e.count; ++i)
+        reader.read_record(e, record.data(), nullptr, unused);
+}
+
+} // namespace
+
+void read_ply(SurfaceMesh& mesh, const std::filesystem::path& file)
+{
+    FILE* in = fopen(file.string().c_str(), "rb");
+    if (!in)
+        throw IOException("Failed to open file: " + file.string());
+
+    try
+    {
+        std::vector<PlyElement> elements;
+        const auto format = read_header(in, elements);
+        check_counts(in, format, elements);
+        PlyReader reader(in, format);
+
+        for (const auto& e : elements)
+        {
+            if (e.name == "vertex" && mesh.n_vertices() == 0)
+                read_vertices(mesh, reader, e);
+            else if (e.name == "face" && mesh.n_faces() == 0)
+                read_faces(mesh, reader, e);
+            else
+                skip_element(reader, e);
+        }
+    }
+    catch (...)
+    {
+        fclose(in);
+        throw;
+    }
+
+    fclose(in);
+}
+
+} // namespace pmp
@@ -0,0 +1,14 @@
+// Copyright 2023 the Polygon Mesh Processing Library developers.
+// Distributed under a MIT-style license, see LICENSE.txt for details.
+
+#pragma once
+
+#include <filesystem>
+
+#include "pmp/surface_mesh.h"
+
+namespace pmp {
+
+void read_ply(SurfaceMesh& mesh, const std::filesystem::path& file);
+
+} // namespace pmp
@@ -0,0 +1,354 @@
+// Copyright 2023 the Polygon Mesh Processing Library developers.
+// Distributed under a MIT-style license, see LICENSE.txt for details.
+
+#include "pmp/io/write_glb.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <limits>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "pmp/exceptions.h"
+
+namespace pmp {
+namespace {
+
+// glTF component types
+constexpr int gl_byte = 5120;
+constexpr int gl_unsigned_byte = 5121;
+constexpr int gl_unsigned_short = 5123;
+constexpr int gl_unsigned_int = 5125;
+constexpr int gl_float = 5126;
+
+// glTF buffer view targets
+constexpr int gl_array_buffer = 34962;
+constexpr int gl_element_array_buffer = 34963;
+
+// assembles the binary chunk and the buffer views and accessors describing it
+class GlbBuilder
+{
+public:
+    // \brief add an accessor to count elements of type (VEC3, ...)
+    // \details Each element takes size bytes of data and is padded to a
+    // multiple of four bytes as required for vertex attributes.
+    // \return the index of the accessor
+    int add(const std::vector<char>& data, size_t count, size_t size,
+            int component_type, const char* type, bool normalized, int target,
+            const std::string& bounds = "")
+    {
+        const size_t stride = (size + 3) & ~size_t(3);
+        const bool is_strided = target == gl_array_buffer && stride != size;
+        const auto offset = buffer_.size();
+        for (size_t i = 0; i < count; ++i)
+        {
+            buffer_.insert(buffer_.end(), data.begin() + i * size,
+                           data.begin() + (i + 1) * size);
+            if (is_strided)
+                buffer_.resize(buffer_.size() + stride - size, 0);
+        }
+        const auto length = buffer_.size() - offset;
+        buffer_.resize((buffer_.size() + 3) & ~size_t(3), 0);
+
+        std::ostringstream view;
+        view << "{\"buffer\":0,\"byteOffset\":" << offset
+             << ",\"byteLength\":" << length;
+        if (is_strided)
+            view << ",\"byteStride\":" << stride;
+        view << ",\"target\":" << target << "}";
+        views_.push_back(view.str());
+
+        std::ostringstream accessor;
+        accessor << "{\"bufferView\":" << views_.size() - 1
+                 << ",\"componentType\":" << component_type
+                 << ",\"count\":" << count << ",\"type\":\"" << type << "\"";
+        if (normalized)
+            accessor << ",\"normalized\":true";
+        accessor << bounds << "}";
+        accessors_.push_back(accessor.str());
+        return int(accessors_.size()) - 1;
+    }
+
+    const std::vector<char>& buffer() const { return buffer_; }
+
+    std::string views() const { return join(views_); }
+
+    std::string accessors() const { return join(accessors_); }
+
+private:
+    static std::string join(const std::vector<std::string>& items)
+    {
+        std::string result = "[";
+        for (size_t i = 0; i < items.size(); ++i)
+            result += (i ? "," : "") + items[i];
+        return result + "]";
+    }
+
+    std::vector<char> buffer_;
+    std::vector<std::string> views_;
+    std::vector<std::string> accessors_;
+};
+
+// append value to bytes
+template <class T>
+void append(std::vector<char>& bytes, T value)
+{
+    const auto n = bytes.size();
+    bytes.resize(n + sizeof(T));
+    std::memcpy(bytes.data() + n, &value, sizeof(T));
+}
+
+// JSON array of n numbers
+template <class T>
+std::string json_array(const T* values, size_t n)
+{
+    std::ostringstream oss;
+    oss.precision(std::numeric_limits<T>::max_digits10);
+    oss << "[";
+    for (size_t i = 0; i < n; ++i)
+        oss << (i ? "," : "") << values[i];
+    oss << "]";
+    return oss.str();
+}
+
+// quantize x in [-1,1] or [0,1] to a normalized integer of type T
+template <class T>
+T quantize(Scalar x)
+{
+    constexpr auto max = double(std::numeric_limits<T>::max());
+    const auto lower = std::numeric_limits<T>::is_signed ? -1.0 : 0.0;
+    return T(std::round(std::clamp(double(x), lower, 1.0) * max));
+}
+
+void write_chunk(std::ofstream& ofs, uint32_t type, const std::string& data)
+{
+    const auto length = uint32_t(data.size());
+    ofs.write((const char*)&length, sizeof(length));
+    ofs.write((const char*)&type, sizeof(type));
+    ofs.write(data.data(), data.size());
+}
+
+} // namespace
+
+void write_glb(const SurfaceMesh& mesh, const std::filesystem::path& file,
+               const IOFlags& flags)
+{
+    const bool quantize_attributes = flags.use_quantization;
+    const auto n_vertices = mesh.n_vertices();
+    if (n_vertices == 0)
+        throw InvalidInputException("write_glb: Empty mesh.");
+
+    GlbBuilder builder;
+    std::ostringstream attributes;
+    std::vector<char> data;
+
+    // bounding box of the positions
+    auto points = mesh.get_vertex_property<Point>("v:point");
+    Point bb_min(std::numeric_limits<Scalar>::max());
+    Point bb_max(-std::numeric_limits<Scalar>::max());
+    for (auto v : mesh.vertices())
+    {
+        bb_min = min(bb_min, points[v]);
+        bb_max = max(bb_max, points[v]);
+    }
+
+    // positions, quantized to 16 bit with uniform scaling to keep normals
+    // valid under the dequantization matrix of the node
+    std::string node_matrix;
+    if (quantize_attributes)
+    {
+        const auto extent = std::max({bb_max[0] - bb_min[0],
+                                      bb_max[1] - bb_min[1],
+                                      bb_max[2] - bb_min[2],
+                                      std::numeric_limits<Scalar>::min()});
+        const double scale = double(extent) / 65535.0;
+        uint16_t qmax[3] = {0, 0, 0};
+        for (auto v : mesh.vertices())
+            for (int k = 0; k < 3; ++k)
+            {
+                const auto q = uint16_t(std::round(
+                    std::min((points[v][k] - bb_min[k]) / scale, 65535.0)));
+                qmax[k] = std::max(qmax[k], q);
+                append(data, q);
+            }
+        const uint16_t qmin[3] = {0, 0, 0};
+        const double matrix[16] = {scale,     0,         0,         0,
+                                   0,         scale,     0,         0,
+                                   0,         0,         scale,     0,
+                                   bb_min[0], bb_min[1], bb_min[2], 1};
+        node_matrix = ",\"matrix\":" + json_array(matrix, 16);
+        attributes << "\"POSITION\":"
+                   << builder.add(data, n_vertices, 6, gl_unsigned_short,
+                                  "VEC3", false, gl_array_buffer,
+                                  ",\"min\":" + json_array(qmin, 3) +
+                                      ",\"max\":" + json_array(qmax, 3));
+    }
+    else
+    {
+        for (auto v : mesh.vertices())
+            for (int k = 0; k < 3; ++k)
+                append(data, float(points[v][k]));
+        const float fmin[3] = {float(bb_min[0]), float(bb_min[1]),
+                               float(bb_min[2])};
+        const float fmax[3] = {float(bb_max[0]), float(bb_max[1]),
+                               float(bb_max[2])};
+        attributes << "\"POSITION\":"
+                   << builder.add(data, n_vertices, 12, gl_float, "VEC3",
+                                  false, gl_array_buffer,
+                                  ",\"min\":" + json_array(fmin, 3) +
+                                      ",\"max\":" + json_array(fmax, 3));
+    }
+
+    // normals, quantized to 8 bit
+    auto normals = mesh.get_vertex_property<Normal>("v:normal");
+    if (normals && flags.use_vertex_normals)
+    {
+        data.clear();
+        for (auto v : mesh.vertices())
+            for (int k = 0; k < 3; ++k)
+                if (quantize_attributes)
+                    append(data, quantize<int8_t>(normals[v][k]));
+                else
+                    append(data, float(normals[v][k]));
+        attributes << ",\"NORMAL\":"
+                   << (quantize_attributes
+                           ? builder.add(data, n_vertices, 3, gl_byte, "VEC3",
+                                         true, gl_array_buffer)
+                           : builder.add(data, n_vertices, 12, gl_float,
+                                         "VEC3", false, gl_array_buffer));
+    }
+
+    // texture coordinates, quantized to 16 bit if in [0,1]
+    auto texcoords = mesh.get_vertex_property<TexCoord>("v:tex");
+    if (texcoords && flags.use_vertex_texcoords)
+    {
+        bool is_unit = true;
+        for (auto v : mesh.vertices())
+            for (int k = 0; k < 2; ++k)
+                if (texcoords[v][k] < 0 || texcoords[v][k] > 1)
+                    is_unit = false;
+        const bool quantize_texcoords = quantize_attributes && is_unit;
+
+        // glTF has the origin of texture space in the upper left corner
+        data.clear();
+        for (auto v : mesh.vertices())
+        {
+            const TexCoord t(texcoords[v][0], 1 - texcoords[v][1]);
+            for (int k = 0; k < 2; ++k)
+                if (quantize_texcoords)
+                    append(data, quantize<uint16_t>(t[k]));
+                else
+                    append(data, float(t[k]));
+        }
+        attributes << ",\"TEXCOORD_0\":"
+                   << (quantize_texcoords
+                           ? builder.add(data, n_vertices, 4,
+                                         gl_unsigned_short, "VEC2", true,
+                                         gl_array_buffer)
+                           : builder.add(data, n_vertices, 8, gl_float,
+                                         "VEC2", false, gl_array_buffer));
+    }
+
+    // colors, quantized to 8 bit
+    auto colors = mesh.get_vertex_property<Color>("v:color");
+    if (colors && flags.use_vertex_colors)
+    {
+        data.clear();
+        for (auto v : mesh.vertices())
+            for (int k = 0; k < 3; ++k)
+                if (quantize_attributes)
+                    append(data, quantize<uint8_t>(colors[v][k]));
+                else
+                    append(data, float(colors[v][k]));
+        attributes << ",\"COLOR_0\":"
+                   << (quantize_attributes
+                           ? builder.add(data, n_vertices, 3,
+                                         gl_unsigned_byte, "VEC3", true,
+                                         gl_array_buffer)
+                           : builder.add(data, n_vertices, 12, gl_float,
+                                         "VEC3", false, gl_array_buffer));
+    }
+
+    // triangle indices, polygons are triangulated as fans
+    std::vector<uint32_t> indices(mesh.vertices_size());
+    uint32_t index = 0;
+    for (auto v : mesh.vertices())
+        indices[v.idx()] = index++;
+
+    std::vector<uint32_t> triangles;
+    for (auto f : mesh.faces())
+    {
+        auto h = mesh.halfedge(f);
+        const auto first = indices[mesh.to_vertex(h).idx()];
+        h = mesh.next_halfedge(h);
+        for (auto end = mesh.prev_halfedge(mesh.halfedge(f)); h != end;
+             h = mesh.next_halfedge(h))
+        {
+            triangles.push_back(first);
+            triangles.push_back(indices[mesh.to_vertex(h).idx()]);
+            triangles.push_back(
+                indices[mesh.to_vertex(mesh.next_halfedge(h)).idx()]);
+        }
+    }
+
+    std::string primitive_indices;
+    if (!triangles.empty())
+    {
+        const bool is_short = n_vertices <= 65535;
+        data.clear();
+        for (auto i : triangles)
+            if (is_short)
+                append(data, uint16_t(i));
+            else
+                append(data, i);
+        const auto accessor =
+            is_short ? builder.add(data, triangles.size(), 2,
+                                   gl_unsigned_short, "SCALAR", false,
+                                   gl_element_array_buffer)
+                     : builder.add(data, triangles.size(), 4, gl_unsigned_int,
+                                   "SCALAR", false, gl_element_array_buffer);
+        primitive_indices = ",\"indices\":" + std::to_string(accessor);
+    }
+
+    // JSON chunk, padded with spaces, meshes without faces as points
+    const int mode = triangles.empty() ? 0 : 4;
+    std::ostringstream json;
+    json << "{\"asset\":{\"version\":\"2.0\",\"generator\":\"pmp-library\"},";
+    if (quantize_attributes)
+        json << "\"extensionsUsed\":[\"KHR_mesh_quantization\"],"
+             << "\"extensionsRequired\":[\"KHR_mesh_quantization\"],";
+    json << "\"scene\":0,\"scenes\":[{\"nodes\":[0]}],"
+         << "\"nodes\":[{\"mesh\":0" << node_matrix << "}],"
+         << "\"meshes\":[{\"primitives\":[{\"attributes\":{"
+         << attributes.str() << "}" << primitive_indices
+         << ",\"mode\":" << mode << "}]}],"
+         << "\"buffers\":[{\"byteLength\":" << builder.buffer().size() << "}],"
+         << "\"bufferViews\":" << builder.views() << ","
+         << "\"accessors\":" << builder.accessors() << "}";
+    auto json_chunk = json.str();
+    json_chunk.resize((json_chunk.size() + 3) & ~size_t(3), ' ');
+
+    const std::string bin_chunk(builder.buffer().begin(),
+                                builder.buffer().end());
+
+    std::ofstream ofs(file.string(), std::ios::binary);
+    if (!ofs)
+        throw IOException("Failed to open file: " + file.string());
+
+    // header with magic "glTF", version, and total length
+    const uint32_t header[3] = {0x46546C67, 2,
+                                uint32_t(12 + 8 + json_chunk.size() + 8 +
+                                         bin_chunk.size())};
+    ofs.write((const char*)header, sizeof(header));
+    write_chunk(ofs, 0x4E4F534A, json_chunk); // "JSON"
+    write_chunk(ofs, 0x004E4942, bin_chunk);  // "BIN\0"
+
+    if (!ofs)
+        throw IOException("Failed to write file: " + file.string());
+}
+
+} // namespace pmp
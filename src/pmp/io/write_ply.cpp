@@ -0,0 +1,319 @@
+// Copyright 2023 the Polygon Mesh Processing Library developers.
+// Distributed under a MIT-style license, see LICENSE.txt for details.
+
+#include "pmp/io/write_ply.h"
+
+#include <algorithm>
+#include <cctype>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include "pmp/io/ply.h"
+#include "pmp/exceptions.h"
+
+namespace pmp {
+namespace {
+
+// a scalar property of a PLY element and where its values come from
+struct PlyColumn
+{
+    std::string name;
+    PlyType type;       // in the file
+    const char* data;   // of the mesh property
+    size_t stride;      // of the mesh property
+    PlyType data_type;  // of the mesh property
+    double scale = 1.0; // applied if types differ
+};
+
+constexpr PlyType scalar_type =
+    sizeof(Scalar) == 8 ? PlyType::Float64 : PlyType::Float32;
+
+// add columns for the n components of type t of a property
+template <class T>
+void add_components(std::vector<PlyColumn>& columns, const std::string& name,
+                    const char* data, size_t n, PlyType t)
+{
+    if (n == 1)
+    {
+        columns.push_back({name, t, data, sizeof(T), t});
+        return;
+    }
+    for (size_t k = 0; k < n; ++k)
+        columns.push_back({name + "_" + std::to_string(k), t,
+                           data + k * ply_size(t), sizeof(T), t});
+}
+
+// add columns for property name if it has a supported type
+template <class Handle>
+void add_custom_columns(const SurfaceMesh& mesh, const std::string& name,
+                        std::vector<PlyColumn>& columns)
+{
+    // strip prefix and replace characters not allowed in the header
+    std::string column = name;
+    if (column.size() > 2 && column[1] == ':')
+        column = column.substr(2);
+    for (auto& c : column)
+        if (std::isspace(static_cast<unsigned char>(c)))
+            c = '_';
+
+    bool found = false;
+    auto probe = [&](auto value, size_t n, PlyType t) {
+        using T = decltype(value);
+        if (found)
+            return;
+        const char* data = nullptr;
+        if constexpr (std::is_same_v<Handle, Vertex>)
+        {
+            if (const auto prop = mesh.get_vertex_property<T>(name))
+                data = (const char*)prop.data();
+        }
+        else
+        {
+            if (const auto prop = mesh.get_face_property<T>(name))
+                data = (const char*)prop.data();
+        }
+        if (!data)
+            return;
+        add_components<T>(columns, column, data, n, t);
+        found = true;
+    };
+
+    probe(int8_t(), 1, PlyType::Int8);
+    probe(uint8_t(), 1, PlyType::UInt8);
+    probe(int16_t(), 1, PlyType::Int16);
+    probe(uint16_t(), 1, PlyType::UInt16);
+    probe(int32_t(), 1, PlyType::Int32);
+    probe(uint32_t(), 1, PlyType::UInt32);
+    probe(float(), 1, PlyType::Float32);
+    probe(double(), 1, PlyType::Float64);
+    probe(bool(), 1, PlyType::UInt8);
+    probe(vec2(), 2, PlyType::Float32);
+    probe(vec3(), 3, PlyType::Float32);
+    probe(vec4(), 4, PlyType::Float32);
+    probe(dvec2(), 2, PlyType::Float64);
+    probe(dvec3(), 3, PlyType::Float64);
+    probe(dvec4(), 4, PlyType::Float64);
+}
+
+// add columns for the n components of a Scalar vector property
+template <class T>
+void add_vector(std::vector<PlyColumn>& columns, const T& prop,
+                std::initializer_list<const char*> names, PlyType type,
+                double scale)
+{
+    size_t k = 0;
+    for (auto name : names)
+        columns.push_back({name, type,
+                           (const char*)prop.data() + k++ * sizeof(Scalar),
+                           sizeof(*prop.data()), scalar_type, scale});
+}
+
+// buffered output of ASCII or binary records
+class PlyWriter
+{
+public:
+    PlyWriter(FILE* out, const IOFlags& flags)
+        : out_(out),
+          ascii_(!flags.use_binary),
+          swap_(flags.use_binary && flags.use_big_endian != is_big_endian())
+    {
+    }
+
+    ~PlyWriter() { flush(); }
+
+    bool is_ascii() const { return ascii_; }
+
+    bool swaps() const { return swap_; }
+
+    // append value of type t to the current record
+    void write(PlyType t, double value)
+    {
+        if (ascii_)
+        {
+            if (t == PlyType::Float32)
+                fprintf(out_, "%.9g ", value);
+            else if (t == PlyType::Float64)
+                fprintf(out_, "%.17g ", value);
+            else
+                fprintf(out_, "%.0f ", value);
+            return;
+        }
+        ply_store(reserve(ply_size(t)), t, value, swap_);
+    }
+
+    // append column c of record i
+    void write(const PlyColumn& c, size_t i)
+    {
+        const char* src = c.data + i * c.stride;
+        if (!ascii_ && c.type == c.data_type)
+        {
+            char* dst = reserve(ply_size(c.type));
+            std::memcpy(dst, src, ply_size(c.type));
+            if (swap_)
+                std::reverse(dst, dst + ply_size(c.type));
+            return;
+        }
+
+        auto value = ply_load(src, c.data_type, false);
+        if (c.type != c.data_type && c.scale != 1.0)
+            value = std::round(std::clamp(value * c.scale, 0.0, c.scale));
+        write(c.type, value);
+    }
+
+    // append n raw bytes in native byte order
+    void write_bytes(const char* data, size_t n)
+    {
+        flush();
+        fwrite(data, 1, n, out_);
+    }
+
+    void end_record()
+    {
+        if (ascii_)
+            fprintf(out_, "\n");
+        else if (buffer_.size() > (1 << 20))
+            flush();
+    }
+
+    void flush()
+    {
+        if (!buffer_.empty())
+            fwrite(buffer_.data(), 1, buffer_.size(), out_);
+        buffer_.clear();
+    }
+
+private:
+    char* reserve(size_t n)
+    {
+        buffer_.resize(buffer_.size() + n);
+        return buffer_.data() + buffer_.size() - n;
+    }
+
+    FILE* out_;
+    bool ascii_;
+    bool swap_;
+    std::vector<char> buffer_;
+};
+
+void write_element(FILE* out, const char* element, size_t count,
+                   const std::vector<PlyColumn>& columns)
+{
+    fprintf(out, "element %s %zu\n", element, count);
+    for (const auto& c : columns)
+        fprintf(out, "property %s %s\n", ply_name(c.type), c.name.c_str());
+}
+
+} // namespace
+
+void write_ply(const SurfaceMesh& mesh, const std::filesystem::path& file,
+               const IOFlags& flags)
+{
+    // vertex columns
+    std::vector<PlyColumn> vcolumns;
+    const auto points = mesh.get_vertex_property<Point>("v:point");
+    add_vector(vcolumns, points, {"x", "y", "z"}, scalar_type, 1.0);
+
+    auto vnormals = mesh.get_vertex_property<Normal>("v:normal");
+    if (vnormals && flags.use_vertex_normals)
+        add_vector(vcolumns, vnormals, {"nx", "ny", "nz"}, scalar_type, 1.0);
+
+    auto vcolors = mesh.get_vertex_property<Color>("v:color");
+    if (vcolors && flags.use_vertex_colors)
+        add_vector(vcolumns, vcolors, {"red", "green", "blue"}, PlyType::UInt8,
+                   255.0);
+
+    auto vtex = mesh.get_vertex_property<TexCoord>("v:tex");
+    if (vtex && flags.use_vertex_texcoords)
+        add_vector(vcolumns, vtex, {"texture_u", "texture_v"}, scalar_type,
+                   1.0);
+
+    for (const auto& name : mesh.vertex_properties())
+        if (name != "v:point" && name != "v:normal" && name != "v:color" &&
+            name != "v:tex" && name != "v:connectivity" && name != "v:deleted")
+            add_custom_columns<Vertex>(mesh, name, vcolumns);
+
+    // face columns
+    std::vector<PlyColumn> fcolumns;
+    auto fnormals = mesh.get_face_property<Normal>("f:normal");
+    if (fnormals && flags.use_face_normals)
+        add_vector(fcolumns, fnormals, {"nx", "ny", "nz"}, scalar_type, 1.0);
+
+    auto fcolors = mesh.get_face_property<Color>("f:color");
+    if (fcolors && flags.use_face_colors)
+        add_vector(fcolumns, fcolors, {"red", "green", "blue"}, PlyType::UInt8,
+                   255.0);
+
+    for (const auto& name : mesh.face_properties())
+        if (name != "f:normal" && name != "f:color" &&
+            name != "f:connectivity" && name != "f:deleted")
+            add_custom_columns<Face>(mesh, name, fcolumns);
+
+    size_t max_valence = 0;
+    for (auto f : mesh.faces())
+        max_valence = std::max<size_t>(max_valence, mesh.valence(f));
+    const auto count_type = max_valence > 255 ? PlyType::Int32 : PlyType::UInt8;
+
+    FILE* out = fopen(file.string().c_str(), "wb");
+    if (!out)
+        throw IOException("Failed to open file: " + file.string());
+
+    fprintf(out, "ply\nformat %s 1.0\n",
+            !flags.use_binary       ? "ascii"
+            : flags.use_big_endian ? "binary_big_endian"
+                                   : "binary_little_endian");
+    fprintf(out, "comment written by pmp-library\n");
+    write_element(out, "vertex", mesh.n_vertices(), vcolumns);
+    fprintf(out, "element face %zu\n", mesh.n_faces());
+    fprintf(out, "property list %s int vertex_indices\n",
+            ply_name(count_type));
+    for (const auto& c : fcolumns)
+        fprintf(out, "property %s %s\n", ply_name(c.type), c.name.c_str());
+    fprintf(out, "end_header\n");
+
+    {
+        PlyWriter writer(out, flags);
+
+        // positions only are written in bulk
+        if (!writer.is_ascii() && !writer.swaps() && vcolumns.size() == 3 &&
+            mesh.n_vertices() == mesh.vertices_size())
+        {
+            writer.write_bytes((const char*)points.data(),
+                               mesh.n_vertices() * sizeof(Point));
+        }
+        else
+        {
+            for (auto v : mesh.vertices())
+            {
+                for (const auto& c : vcolumns)
+                    writer.write(c, v.idx());
+                writer.end_record();
+            }
+        }
+
+        // vertex indices of the files skip deleted vertices
+        std::vector<int> indices(mesh.vertices_size(), -1);
+        int index = 0;
+        for (auto v : mesh.vertices())
+            indices[v.idx()] = index++;
+
+        for (auto f : mesh.faces())
+        {
+            writer.write(count_type, mesh.valence(f));
+            for (auto v : mesh.vertices(f))
+                writer.write(PlyType::Int32, indices[v.idx()]);
+            for (const auto& c : fcolumns)
+                writer.write(c, f.idx());
+            writer.end_record();
+        }
+    }
+
+    const bool failed = ferror(out);
+    fclose(out);
+    if (failed)
+        throw IOException("Failed to write file: " + file.string());
+}
+
+} // namespace pmp
@@ -0,0 +1,88 @@
+// Copyright 2023 the Polygon Mesh Processing Library developers.
+// Distributed under a MIT-style license, see LICENSE.txt for details.
+
+#include "pmp/job_runner.h"
+#include "pmp/exceptions.h"
+
+#include <exception>
+#include <utility>
+
+namespace pmp {
+
+JobRunner::~JobRunner()
+{
+    cancel();
+    wait();
+}
+
+bool JobRunner::start(const std::string& name, const SurfaceMesh& mesh,
+                      Job job)
+{
+    if (busy_)
+        return false;
+
+    // copies are cheap, the job copies property arrays when writing them
+    name_ = name;
+    result_ = mesh;
+    error_.clear();
+    progress_.reset();
+    finished_.store(false, std::memory_order_release);
+    busy_ = true;
+
+#ifdef __EMSCRIPTEN__
+    run(std::move(job));
+#else
+    thread_ = std::thread(&JobRunner::run, this, std::move(job));
+#endif
+    return true;
+}
+
+void JobRunner::run(Job job)
+{
+    try
+    {
+        job(result_, progress_);
+        if (progress_.is_canceled())
+            error_ = "Canceled";
+        else
+            progress_.set_fraction(1.0f);
+    }
+    catch (const CanceledException&)
+    {
+        error_ = "Canceled";
+    }
+    catch (const std::exception& e)
+    {
+        error_ = e.what();
+    }
+    catch (...)
+    {
+        error_ = "Unknown error";
+    }
+
+    // publishes result_ and error_ to the thread calling collect()
+    finished_.store(true, std::memory_order_release);
+}
+
+void JobRunner::wait()
+{
+    if (thread_.joinable())
+        thread_.join();
+}
+
+bool JobRunner::collect(SurfaceMesh& mesh)
+{
+    if (!busy_ || !is_finished())
+        return false;
+
+    wait();
+    busy_ = false;
+
+    const bool success = error_.empty();
+    if (success)
+        mesh = result_;
+    result_ = SurfaceMesh();
+    return success;
+}
+
+} // namespace pmp
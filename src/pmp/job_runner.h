@@ -0,0 +1,91 @@
+// Copyright 2023 the Polygon Mesh Processing Library developers.
+// Distributed under a MIT-style license, see LICENSE.txt for details.
+
+#pragma once
+
+#include <atomic>
+#include <functional>
+#include <string>
+#include <thread>
+
+#include "pmp/progress.h"
+#include "pmp/surface_mesh.h"
+
+namespace pmp {
+
+//! \brief Run a mesh processing operation in the background.
+//! \details A job runs on a worker thread on a copy of the mesh, such that
+//! the original mesh can still be rendered and queried. The job reports its
+//! progress and polls for cancellation through a Progress object. Once it
+//! has finished, collect() replaces the original mesh by the result in a
+//! single assignment. At most one job runs at a time. The runner does not
+//! depend on a window or OpenGL context. Without thread support, e.g., for
+//! Emscripten builds, jobs run synchronously in start().
+//! \sa MeshViewer::run_job()
+//! \ingroup core
+class JobRunner
+{
+public:
+    //! \brief The operation to run on a copy of the mesh.
+    //! \details Should pass the Progress object on to the algorithms it
+    //! calls, or report progress and return early if Progress::is_canceled().
+    //! Exceptions are caught and reported by error().
+    using Job = std::function<void(SurfaceMesh&, Progress&)>;
+
+    //! Construct an idle runner.
+    JobRunner() = default;
+
+    //! Cancel a running job and wait for it to finish.
+    ~JobRunner();
+
+    JobRunner(const JobRunner&) = delete;
+    JobRunner& operator=(const JobRunner&) = delete;
+
+    //! \brief Start \p job on a copy of \p mesh.
+    //! \return \c false if a job is still busy, i.e., has not been collected.
+    bool start(const std::string& name, const SurfaceMesh& mesh, Job job);
+
+    //! \return whether a job was started and its result not yet collected.
+    bool is_busy() const { return busy_; }
+
+    //! \return whether the current job has finished, successfully or not.
+    bool is_finished() const
+    {
+        return finished_.load(std::memory_order_acquire);
+    }
+
+    //! \return the name of the current or last job.
+    const std::string& name() const { return name_; }
+
+    //! \return the fraction of work done by the current job in [0,1].
+    float progress() const { return progress_.fraction(); }
+
+    //! Request cancellation of the current job.
+    void cancel() { progress_.cancel(); }
+
+    //! Block until the current job has finished.
+    void wait();
+
+    //! \brief Finish the current job if it is done.
+    //! \details Replaces \p mesh by the result of a successful job. The
+    //! result of a failed or canceled job is discarded. Either way, the
+    //! runner becomes idle.
+    //! \return \c true if \p mesh was replaced.
+    bool collect(SurfaceMesh& mesh);
+
+    //! \return the error message of the last job, empty on success.
+    const std::string& error() const { return error_; }
+
+private:
+    void run(Job job);
+
+    std::string name_;
+    SurfaceMesh result_;
+    Progress progress_;
+    std::string error_;
+    std::thread thread_;
+    std::atomic<bool> finished_{false};
+    bool busy_{false};
+};
+
+} // namespace pmp
@@ -31,7 +31,7 @@ public:
     static size_t current_size();
 };
 
-size_t MemoryUsage::max_size()
+inline size_t MemoryUsage::max_size()
 {
 #if defined(_WIN32)
 
@@ -54,7 +54,7 @@ size_t MemoryUsage::max_size()
     return 0;
 }
 
-size_t MemoryUsage::current_size()
+inline size_t MemoryUsage::current_size()
 {
 #if defined(_WIN32)
 
@@ -0,0 +1,90 @@
+// Copyright 2023 the Polygon Mesh Processing Library developers.
+// Distributed under a MIT-style license, see LICENSE.txt for details.
+
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <limits>
+
+namespace pmp {
+
+//! \brief Progress and cancellation state shared between a running
+//! operation and its observers.
+//! \details All functions are thread-safe, such that an operation running on
+//! a worker thread can report its progress while another thread reads it or
+//! requests cancellation. Long-running algorithms take an optional pointer
+//! to a Progress object, which they poll at natural checkpoints, e.g., per
+//! iteration or per heap pop. Once canceled, they stop at the next
+//! checkpoint, leave the mesh in a valid state, and throw a
+//! CanceledException.
+//! \sa JobRunner
+//! \ingroup core
+class Progress
+{
+public:
+    //! The clock used for deadlines.
+    using Clock = std::chrono::steady_clock;
+
+    //! Set the fraction of work done, clamped to [0,1].
+    void set_fraction(float fraction)
+    {
+        fraction = fraction < 0.0f ? 0.0f : fraction;
+        fraction = fraction > 1.0f ? 1.0f : fraction;
+        fraction_.store(fraction, std::memory_order_relaxed);
+    }
+
+    //! \return the fraction of work done in [0,1].
+    float fraction() const
+    {
+        return fraction_.load(std::memory_order_relaxed);
+    }
+
+    //! Request cancellation of the operation.
+    void cancel() { canceled_.store(true, std::memory_order_relaxed); }
+
+    //! Cancel the operation once \p timeout has passed from now.
+    void set_deadline(Clock::duration timeout)
+    {
+        const auto deadline = Clock::now() + timeout;
+        deadline_.store(deadline.time_since_epoch().count(),
+                        std::memory_order_relaxed);
+    }
+
+    //! \return whether cancellation has been requested or the deadline has
+    //! passed.
+    bool is_canceled() const
+    {
+        if (canceled_.load(std::memory_order_relaxed))
+            return true;
+        const auto deadline = deadline_.load(std::memory_order_relaxed);
+        return deadline != no_deadline &&
+               Clock::now().time_since_epoch().count() >= deadline;
+    }
+
+    //! \brief Report \p fraction of work done at a checkpoint.
+    //! \return \c false if the operation should stop, i.e., is canceled.
+    bool checkpoint(float fraction)
+    {
+        set_fraction(fraction);
+        return !is_canceled();
+    }
+
+    //! Reset to zero progress, no cancellation, and no deadline.
+    void reset()
+    {
+        fraction_.store(0.0f, std::memory_order_relaxed);
+        canceled_.store(false, std::memory_order_relaxed);
+        deadline_.store(no_deadline, std::memory_order_relaxed);
+    }
+
+private:
+    static constexpr Clock::rep no_deadline =
+        std::numeric_limits<Clock::rep>::max();
+
+    std::atomic<float> fraction_{0.0f};
+    std::atomic<bool> canceled_{false};
+    std::atomic<Clock::rep> deadline_{no_deadline};
+};
+
+} // namespace pmp
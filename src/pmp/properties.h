@@ -5,14 +5,114 @@
 #pragma once
 
 #include <algorithm>
+#include <atomic>
 #include <cassert>
+#include <cstddef>
+#include <cstring>
 #include <iostream>
+#include <memory>
+#include <memory_resource>
+#include <new>
 #include <string>
+#include <string_view>
+#include <type_traits>
+#include <unordered_map>
 #include <utility>
 #include <vector>
 
+//! alignment in bytes of property array storage
+#ifndef PMP_PROPERTY_ALIGNMENT
+#define PMP_PROPERTY_ALIGNMENT 64
+#endif
+
 namespace pmp {
 
+//! \brief Allocator for property arrays.
+//! \details Memory is aligned to PMP_PROPERTY_ALIGNMENT bytes, such that
+//! property data can be processed by SIMD instructions or handed to external
+//! libraries without copying. Memory is obtained from a
+//! std::pmr::memory_resource if one is given, e.g., an arena that releases
+//! all memory of a mesh at once, and from the global heap otherwise.
+template <class T>
+class PropertyAllocator
+{
+public:
+    using value_type = T;
+
+    PropertyAllocator() = default;
+
+    explicit PropertyAllocator(std::pmr::memory_resource* resource)
+        : resource_(resource)
+    {
+    }
+
+    template <class U>
+    PropertyAllocator(const PropertyAllocator<U>& other)
+        : resource_(other.resource())
+    {
+    }
+
+    T* allocate(size_t n)
+    {
+        if (resource_)
+            return static_cast<T*>(
+                resource_->allocate(n * sizeof(T), alignment()));
+        return static_cast<T*>(
+            ::operator new(n * sizeof(T), std::align_val_t(alignment())));
+    }
+
+    void deallocate(T* p, size_t n)
+    {
+        if (resource_)
+            resource_->deallocate(p, n * sizeof(T), alignment());
+        else
+            ::operator delete(p, std::align_val_t(alignment()));
+    }
+
+    //! \return the memory resource, or nullptr for the global heap
+    std::pmr::memory_resource* resource() const { return resource_; }
+
+    template <class U>
+    bool operator==(const PropertyAllocator<U>& other) const
+    {
+        return resource_ == other.resource();
+    }
+
+    template <class U>
+    bool operator!=(const PropertyAllocator<U>& other) const
+    {
+        return resource_ != other.resource();
+    }
+
+private:
+    static constexpr size_t alignment()
+    {
+        return std::max<size_t>(PMP_PROPERTY_ALIGNMENT, alignof(T));
+    }
+
+    std::pmr::memory_resource* resource_{nullptr};
+};
+
+//! \brief Storage type of property values.
+//! \details Boolean values are stored in one byte each instead of the
+//! bit-packed std::vector<bool>, such that flags can be accessed by reference
+//! and raw pointer like any other property.
+template <class T>
+struct PropertyStorage
+{
+    using type = T;
+};
+
+template <>
+struct PropertyStorage<bool>
+{
+    struct type
+    {
+        type(bool b = false) : value(b) {}
+        bool value;
+    };
+};
+
 class BasePropertyArray
 {
 public:
@@ -37,8 +137,23 @@ public:
     //! Let two elements swap their storage place.
     virtual void swap(size_t i0, size_t i1) = 0;
 
-    //! Return a deep copy of self.
-    virtual BasePropertyArray* clone() const = 0;
+    //! \brief Reorder elements such that element \c i is the former element
+    //! \c order[i].
+    //! \details \p order may reference a subset of the elements, in which
+    //! case the array is shrunk to \c order.size() elements.
+    virtual void permute(const std::vector<size_t>& order) = 0;
+
+    //! \brief Return a copy of self allocating from \p resource.
+    //! \details If \p resource is the resource of this array, the copy
+    //! shares its data with this array until either of them is modified.
+    //! Otherwise the data is copied.
+    virtual BasePropertyArray* clone(
+        std::pmr::memory_resource* resource) const = 0;
+
+    //! \brief Overwrite element \p i by \p n raw bytes.
+    //! \return false if the value type is not trivially copyable or its size
+    //! is not \p n.
+    virtual bool set_bytes(size_t i, const void* bytes, size_t n) = 0;
 
     //! Return the name of the property
     const std::string& name() const { return name_; }
@@ -47,74 +162,273 @@ protected:
     std::string name_;
 };
 
+//! \brief Typed property array.
+//! \details Copies share their data, which is copied on the first
+//! modification of a shared array only (copy-on-write). This makes copying a
+//! SurfaceMesh cheap, and later modifications copy only the properties
+//! they touch. The data is copied by all non-const functions, including
+//! non-const element access, such that copies behave as independent values.
+//! Reading a copy through a const reference does not copy its data. Copies
+//! may be read and modified on different threads, but a single array must
+//! not be modified concurrently.
 template <class T>
 class PropertyArray : public BasePropertyArray
 {
 public:
     using ValueType = T;
-    using VectorType = std::vector<ValueType>;
-    using reference = typename VectorType::reference;
-    using const_reference = typename VectorType::const_reference;
+    using StorageType = typename PropertyStorage<T>::type;
+    using VectorType =
+        std::vector<StorageType, PropertyAllocator<StorageType>>;
+    using reference = T&;
+    using const_reference = const T&;
+
+    static_assert(sizeof(StorageType) == sizeof(T));
+
+    PropertyArray(std::string name, T t = T(),
+                  std::pmr::memory_resource* resource = nullptr)
+        : BasePropertyArray(std::move(name)),
+          buffer_(make_buffer(PropertyAllocator<StorageType>(resource))),
+          value_(std::move(t))
+    {
+    }
 
-    PropertyArray(std::string name, T t = T())
-        : BasePropertyArray(std::move(name)), value_(std::move(t))
+    //! Construct a copy sharing the data of \p rhs.
+    PropertyArray(const PropertyArray& rhs)
+        : BasePropertyArray(rhs.name_), buffer_(rhs.buffer_), value_(rhs.value_)
     {
+        buffer_->owners.fetch_add(1, std::memory_order_relaxed);
+        rhs.shared_.store(true, std::memory_order_relaxed);
+        shared_.store(true, std::memory_order_relaxed);
     }
 
-    void reserve(size_t n) override { data_.reserve(n); }
+    //! \brief Assign the data of \p rhs, keeping the name and the memory
+    //! resource of this array.
+    //! \details The data is shared if both arrays use the same resource and
+    //! copied otherwise.
+    PropertyArray& operator=(const PropertyArray& rhs)
+    {
+        if (this != &rhs)
+        {
+            value_ = rhs.value_;
+            if (resource() != rhs.resource())
+            {
+                Buffer* buffer = make_buffer(buffer_->data.get_allocator());
+                buffer->data.assign(rhs.buffer_->data.begin(),
+                                    rhs.buffer_->data.end());
+                release(buffer_);
+                buffer_ = buffer;
+                shared_.store(false, std::memory_order_relaxed);
+                return *this;
+            }
+            rhs.buffer_->owners.fetch_add(1, std::memory_order_relaxed);
+            release(buffer_);
+            buffer_ = rhs.buffer_;
+            rhs.shared_.store(true, std::memory_order_relaxed);
+            shared_.store(true, std::memory_order_relaxed);
+        }
+        return *this;
+    }
 
-    void resize(size_t n) override { data_.resize(n, value_); }
+    ~PropertyArray() override { release(buffer_); }
 
-    void push_back() override { data_.push_back(value_); }
+    void reserve(size_t n) override
+    {
+        detach(n);
+        buffer_->data.reserve(n);
+    }
+
+    void resize(size_t n) override
+    {
+        detach(n);
+        buffer_->data.resize(n, value_);
+    }
+
+    void push_back() override
+    {
+        detach(buffer_->data.size() + 1);
+        buffer_->data.push_back(value_);
+    }
 
-    void free_memory() override { data_.shrink_to_fit(); }
+    void free_memory() override
+    {
+        detach();
+        buffer_->data.shrink_to_fit();
+    }
 
     void swap(size_t i0, size_t i1) override
     {
-        T d(data_[i0]);
-        data_[i0] = data_[i1];
-        data_[i1] = d;
+        detach();
+        std::swap(buffer_->data[i0], buffer_->data[i1]);
     }
 
-    BasePropertyArray* clone() const override
+    void permute(const std::vector<size_t>& order) override
     {
-        auto* p = new PropertyArray<T>(name_, value_);
-        p->data_ = data_;
+        detach();
+        VectorType data(buffer_->data.get_allocator());
+        data.reserve(order.size());
+        for (auto i : order)
+        {
+            assert(i < buffer_->data.size());
+            data.push_back(std::move(buffer_->data[i]));
+        }
+        buffer_->data.swap(data);
+    }
+
+    BasePropertyArray* clone(
+        std::pmr::memory_resource* resource) const override
+    {
+        if (resource == this->resource())
+            return new PropertyArray<T>(*this);
+
+        auto* p = new PropertyArray<T>(name_, value_, resource);
+        p->buffer_->data.assign(buffer_->data.begin(), buffer_->data.end());
         return p;
     }
 
-    //! Get pointer to array (does not work for T==bool)
-    const T* data() const { return &data_[0]; }
+    bool set_bytes(size_t i, const void* bytes, size_t n) override
+    {
+        if (!std::is_trivially_copyable_v<T> || n != sizeof(T) || i >= size())
+            return false;
+        if constexpr (std::is_trivially_copyable_v<T>)
+            std::memcpy(data() + i, bytes, n);
+        return true;
+    }
+
+    //! \brief Copy the data if it is shared with a copy of this array.
+    //! \details Reserves capacity for at least \p n elements when copying.
+    //! Called by all non-const functions.
+    void detach(size_t n = 0)
+    {
+        // the flag is only set by copying, which must not race with
+        // modifications of this array, so a relaxed load suffices here
+        if (shared_.load(std::memory_order_relaxed))
+            copy_shared(n);
+    }
+
+    //! Get pointer to the aligned array of size() elements for writing
+    T* data()
+    {
+        detach();
+        return reinterpret_cast<T*>(buffer_->data.data());
+    }
+
+    //! Get pointer to the aligned array of size() elements
+    const T* data() const
+    {
+        return reinterpret_cast<const T*>(buffer_->data.data());
+    }
+
+    //! Get the number of elements
+    size_t size() const { return buffer_->data.size(); }
 
-    //! Get reference to the underlying vector
-    std::vector<T>& vector() { return data_; }
+    //! Get reference to the underlying vector for writing
+    VectorType& vector()
+    {
+        detach();
+        return buffer_->data;
+    }
 
-    //! Access the i'th element. No range check is performed!
+    //! \brief Access the i'th element. No range check is performed!
+    //! \details Copies data shared with a copy of this array, see detach().
     reference operator[](size_t idx)
     {
-        assert(idx < data_.size());
-        return data_[idx];
+        detach();
+        assert(idx < buffer_->data.size());
+        return reinterpret_cast<T*>(buffer_->data.data())[idx];
     }
 
     //! Const access to the i'th element. No range check is performed!
     const_reference operator[](size_t idx) const
     {
-        assert(idx < data_.size());
-        return data_[idx];
+        assert(idx < buffer_->data.size());
+        return data()[idx];
+    }
+
+    //! Return the memory resource of the data, or nullptr for the heap
+    std::pmr::memory_resource* resource() const
+    {
+        return buffer_->data.get_allocator().resource();
+    }
+
+    //! Return whether the data is shared with a copy of this array
+    bool is_shared() const
+    {
+        return buffer_->owners.load(std::memory_order_acquire) > 1;
     }
 
 private:
-    VectorType data_;
+    // copy the data unless the other owners have released it meanwhile
+    void copy_shared(size_t n)
+    {
+        // the acquire load synchronizes with the release of the other owners,
+        // such that their reads of the buffer happen before our writes
+        if (buffer_->owners.load(std::memory_order_acquire) != 1)
+        {
+            Buffer* buffer = make_buffer(buffer_->data.get_allocator());
+            buffer->data.reserve(std::max(n, buffer_->data.size()));
+            buffer->data.assign(buffer_->data.begin(), buffer_->data.end());
+            release(buffer_);
+            buffer_ = buffer;
+        }
+        shared_.store(false, std::memory_order_relaxed);
+    }
+
+    // the data and the number of arrays sharing it
+    struct Buffer
+    {
+        explicit Buffer(const PropertyAllocator<StorageType>& alloc)
+            : data(alloc)
+        {
+        }
+
+        VectorType data;
+        std::atomic<size_t> owners{1};
+    };
+
+    // allocate an empty buffer owned by one array using alloc
+    static Buffer* make_buffer(const PropertyAllocator<StorageType>& alloc)
+    {
+        PropertyAllocator<Buffer> buffer_alloc(alloc);
+        Buffer* buffer = buffer_alloc.allocate(1);
+        return new (buffer) Buffer(alloc);
+    }
+
+    // give up ownership of buffer, deleting it if this was the last owner
+    static void release(Buffer* buffer)
+    {
+        if (buffer->owners.fetch_sub(1, std::memory_order_acq_rel) != 1)
+            return;
+        PropertyAllocator<Buffer> buffer_alloc(buffer->data.get_allocator());
+        buffer->~Buffer();
+        buffer_alloc.deallocate(buffer, 1);
+    }
+
+    Buffer* buffer_;
     ValueType value_;
+
+    // whether the buffer might be shared, set by copying
+    mutable std::atomic<bool> shared_{false};
 };
 
-// specialization for bool properties
-template <>
-inline const bool* PropertyArray<bool>::data() const
+//! \brief A typed, compile-time property name.
+//! \details Allows looking up a property without repeating its type, e.g.,
+//! \code
+//! constexpr PropertyKey<Point> vertex_positions("v:point");
+//! auto points = mesh.get_vertex_property(vertex_positions);
+//! \endcode
+template <class T>
+class PropertyKey
 {
-    assert(false);
-    return nullptr;
-}
+public:
+    using ValueType = T;
+
+    constexpr explicit PropertyKey(std::string_view name) : name_(name) {}
+
+    constexpr std::string_view name() const { return name_; }
+
+private:
+    std::string_view name_;
+};
 
 template <class T>
 class Property
@@ -132,6 +446,16 @@ public:
 
     explicit operator bool() const { return parray_ != nullptr; }
 
+    //! Get the name of the property
+    const std::string& name() const
+    {
+        assert(parray_ != nullptr);
+        return parray_->name();
+    }
+
+    //! \brief Access the i'th element.
+    //! \details Copies data shared with a copy of the property, see
+    //! detach().
     reference operator[](size_t i)
     {
         assert(parray_ != nullptr);
@@ -141,16 +465,47 @@ public:
     const_reference operator[](size_t i) const
     {
         assert(parray_ != nullptr);
-        return (*parray_)[i];
+        return array()[i];
     }
 
-    const T* data() const
+    //! \brief Copy the data if it is shared with a copy of the property.
+    //! \details Called by the non-const element access.
+    //! \sa PropertyArray::detach()
+    void detach()
+    {
+        assert(parray_ != nullptr);
+        parray_->detach();
+    }
+
+    //! Get pointer to the aligned array of size() elements for writing
+    T* data()
     {
         assert(parray_ != nullptr);
         return parray_->data();
     }
 
-    std::vector<T>& vector()
+    //! Get pointer to the aligned array of size() elements
+    const T* data() const
+    {
+        assert(parray_ != nullptr);
+        return array().data();
+    }
+
+    //! Get the number of elements
+    size_t size() const
+    {
+        assert(parray_ != nullptr);
+        return parray_->size();
+    }
+
+    //! Return whether the data is shared with a copy of the property
+    bool is_shared() const
+    {
+        assert(parray_ != nullptr);
+        return parray_->is_shared();
+    }
+
+    typename PropertyArray<T>::VectorType& vector()
     {
         assert(parray_ != nullptr);
         return parray_->vector();
@@ -178,22 +533,37 @@ public:
     // default constructor
     PropertyContainer() = default;
 
+    // construct a container allocating from resource
+    explicit PropertyContainer(std::pmr::memory_resource* resource)
+        : resource_(resource)
+    {
+    }
+
     // destructor (deletes all property arrays)
     virtual ~PropertyContainer() { clear(); }
 
-    // copy constructor: performs deep copy of property arrays
-    PropertyContainer(const PropertyContainer& rhs) { operator=(rhs); }
+    // copy constructor: copies property arrays and the memory resource of
+    // rhs, sharing the data until either copy is modified
+    PropertyContainer(const PropertyContainer& rhs) : resource_(rhs.resource_)
+    {
+        operator=(rhs);
+    }
 
-    // assignment: performs deep copy of property arrays
+    // assignment: copies property arrays but keeps the memory resource of
+    // this container. the data is shared until either copy is modified if
+    // both containers use the same resource, and copied otherwise.
     PropertyContainer& operator=(const PropertyContainer& rhs)
     {
         if (this != &rhs)
         {
             clear();
             parrays_.resize(rhs.n_properties());
-            size_ = rhs.size();
+            size_ = capacity_ = rhs.size();
             for (size_t i = 0; i < parrays_.size(); ++i)
-                parrays_[i] = rhs.parrays_[i]->clone();
+            {
+                parrays_[i] = rhs.parrays_[i]->clone(resource_);
+                index_.emplace(parrays_[i]->name(), parrays_[i]);
+            }
         }
         return *this;
     }
@@ -201,6 +571,9 @@ public:
     // returns the current size of the property arrays
     size_t size() const { return size_; }
 
+    // returns the memory resource of the property arrays, or nullptr
+    std::pmr::memory_resource* resource() const { return resource_; }
+
     // returns the number of property arrays
     size_t n_properties() const { return parrays_.size(); }
 
@@ -216,49 +589,58 @@ public:
 
     // add a property with name \p name and default value \p t
     template <class T>
-    Property<T> add(const std::string& name, const T t = T())
+    Property<T> add(std::string_view name, const T t = T())
     {
         // if a property with this name already exists, return an invalid property
-        for (auto& parray : parrays_)
+        if (exists(name))
         {
-            if (parray->name() == name)
-            {
-                std::cerr << "[PropertyContainer] A property with name \""
-                          << name
-                          << "\" already exists. Returning invalid property.\n";
-                return Property<T>();
-            }
+            std::cerr << "[PropertyContainer] A property with name \"" << name
+                      << "\" already exists. Returning invalid property.\n";
+            return Property<T>();
         }
 
         // otherwise add the property
-        auto* p = new PropertyArray<T>(name, t);
+        auto* p = new PropertyArray<T>(std::string(name), t, resource_);
+        p->reserve(capacity_);
         p->resize(size_);
         parrays_.push_back(p);
+        index_.emplace(p->name(), p);
         return Property<T>(p);
     }
 
     // do we have a property with a given name?
-    bool exists(const std::string& name) const
+    bool exists(std::string_view name) const
     {
-        for (auto parray : parrays_)
-            if (parray->name() == name)
-                return true;
-        return false;
+        return index_.find(name) != index_.end();
     }
 
     // get a property by its name. returns invalid property if it does not exist.
     template <class T>
-    Property<T> get(const std::string& name) const
+    Property<T> get(std::string_view name) const
     {
-        for (auto parray : parrays_)
-            if (parray->name() == name)
-                return Property<T>(dynamic_cast<PropertyArray<T>*>(parray));
-        return Property<T>();
+        auto it = index_.find(name);
+        if (it == index_.end())
+            return Property<T>();
+        return Property<T>(dynamic_cast<PropertyArray<T>*>(it->second));
+    }
+
+    // get the untyped property array by its name, or nullptr
+    const BasePropertyArray* find(std::string_view name) const
+    {
+        auto it = index_.find(name);
+        return it == index_.end() ? nullptr : it->second;
+    }
+
+    // get the untyped property array by its name for writing, or nullptr
+    BasePropertyArray* find(std::string_view name)
+    {
+        auto it = index_.find(name);
+        return it == index_.end() ? nullptr : it->second;
     }
 
     // returns a property if it exists, otherwise it creates it first.
     template <class T>
-    Property<T> get_or_add(const std::string& name, const T t = T())
+    Property<T> get_or_add(std::string_view name, const T t = T())
     {
         Property<T> p = get<T>(name);
         if (!p)
@@ -275,6 +657,7 @@ public:
         {
             if (*it == h.parray_)
             {
+                index_.erase((*it)->name());
                 delete *it;
                 parrays_.erase(it);
                 h.reset();
@@ -289,14 +672,18 @@ public:
         for (auto& parray : parrays_)
             delete parray;
         parrays_.clear();
-        size_ = 0;
+        index_.clear();
+        size_ = capacity_ = 0;
     }
 
     // reserve memory for n entries in all arrays
-    void reserve(size_t n) const
+    void reserve(size_t n)
     {
+        if (n <= capacity_)
+            return;
         for (auto parray : parrays_)
             parray->reserve(n);
+        capacity_ = n;
     }
 
     // resize all arrays to size n
@@ -305,18 +692,24 @@ public:
         for (auto& parray : parrays_)
             parray->resize(n);
         size_ = n;
+        capacity_ = std::max(capacity_, n);
     }
 
     // free unused space in all arrays
-    void free_memory() const
+    void free_memory()
     {
         for (auto parray : parrays_)
             parray->free_memory();
+        capacity_ = size_;
     }
 
     // add a new element to each vector
     void push_back()
     {
+        // grow all arrays at once to amortize reallocations
+        if (size_ == capacity_)
+            reserve(std::max<size_t>(2 * capacity_, 16));
+
         for (auto& parray : parrays_)
             parray->push_back();
         ++size_;
@@ -329,9 +722,25 @@ public:
             parray->swap(i0, i1);
     }
 
+    // reorder all arrays such that element i is the former element order[i]
+    void permute(const std::vector<size_t>& order)
+    {
+        for (auto& parray : parrays_)
+            parray->permute(order);
+        size_ = capacity_ = order.size();
+    }
+
 private:
     std::vector<BasePropertyArray*> parrays_;
+
+    // property arrays by name, keys reference the names stored in the arrays
+    std::unordered_map<std::string_view, BasePropertyArray*> index_;
+
     size_t size_{0};
+    size_t capacity_{0};
+
+    // memory resource of all arrays, nullptr for the global heap
+    std::pmr::memory_resource* resource_{nullptr};
 };
 
 } // namespace pmp
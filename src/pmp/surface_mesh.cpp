@@ -3,10 +3,69 @@
 // Distributed under a MIT-style license, see LICENSE.txt for details.
 
 #include "pmp/surface_mesh.h"
+#include "pmp/surface_mesh_journal.h"
+
+#include <numeric>
 
 namespace pmp {
+namespace {
 
-SurfaceMesh::SurfaceMesh()
+// Compute the new-to-old index array of all non-deleted elements and the
+// old-to-new handle map by a blocked parallel prefix sum.
+template <class HandleT>
+std::vector<size_t> compaction_order(const Property<bool>& deleted, size_t n,
+                                     std::vector<HandleT>& map)
+{
+    const size_t block_size = 4096;
+    const size_t n_blocks = (n + block_size - 1) / block_size;
+
+    // count remaining elements per block
+    std::vector<size_t> offsets(n_blocks + 1, 0);
+#ifdef _OPENMP
+#pragma omp parallel for
+#endif
+    for (size_t b = 0; b < n_blocks; ++b)
+    {
+        const size_t end = std::min(n, (b + 1) * block_size);
+        for (size_t i = b * block_size; i < end; ++i)
+            if (!deleted[i])
+                ++offsets[b + 1];
+    }
+    std::partial_sum(offsets.begin(), offsets.end(), offsets.begin());
+
+    // scatter new indices
+    std::vector<size_t> order(offsets.back());
+    map.resize(n);
+#ifdef _OPENMP
+#pragma omp parallel for
+#endif
+    for (size_t b = 0; b < n_blocks; ++b)
+    {
+        size_t k = offsets[b];
+        const size_t end = std::min(n, (b + 1) * block_size);
+        for (size_t i = b * block_size; i < end; ++i)
+        {
+            if (deleted[i])
+            {
+                map[i] = HandleT();
+            }
+            else
+            {
+                map[i] = HandleT(k);
+                order[k++] = i;
+            }
+        }
+    }
+
+    return order;
+}
+
+} // namespace
+
+SurfaceMesh::SurfaceMesh() : SurfaceMesh(nullptr) {}
+
+SurfaceMesh::SurfaceMesh(std::pmr::memory_resource* resource)
+    : vprops_(resource), hprops_(resource), eprops_(resource), fprops_(resource)
 {
     // allocate standard properties
     // same list is used in operator=() and assign()
@@ -189,6 +248,9 @@ void SurfaceMesh::adjust_outgoing_halfedge(Vertex v)
 
 Vertex SurfaceMesh::add_vertex(const Point& p)
 {
+    SurfaceMeshJournal::Scope journal_scope(journal_);
+    journal_scope.record(SurfaceMeshJournal::Opcode::AddVertex, p);
+
     Vertex v = new_vertex();
     if (v.is_valid())
         vpoint_[v] = p;
@@ -216,6 +278,8 @@ Face SurfaceMesh::add_quad(Vertex v0, Vertex v1, Vertex v2, Vertex v3)
 
 Face SurfaceMesh::add_face(const std::vector<Vertex>& vertices)
 {
+    SurfaceMeshJournal::Scope journal_scope(journal_);
+
     const size_t n(vertices.size());
     assert(n > 2);
 
@@ -392,6 +456,8 @@ Face SurfaceMesh::add_face(const std::vector<Vertex>& vertices)
         }
     }
 
+    // record only faces that have been added successfully
+    journal_scope.record(SurfaceMeshJournal::Opcode::AddFace, vertices);
     return f;
 }
 
@@ -427,6 +493,9 @@ bool SurfaceMesh::is_quad_mesh() const
 
 void SurfaceMesh::split(Face f, Vertex v)
 {
+    SurfaceMeshJournal::Scope journal_scope(journal_);
+    journal_scope.record(SurfaceMeshJournal::Opcode::SplitFace, f, v);
+
     // Split an arbitrary face into triangles by connecting each vertex of face
     // f to vertex v . Face f will remain valid (it will become one of the
     // triangles). The halfedge handles of the new triangles will point to the
@@ -474,6 +543,9 @@ void SurfaceMesh::split(Face f, Vertex v)
 
 Halfedge SurfaceMesh::split(Edge e, Vertex v)
 {
+    SurfaceMeshJournal::Scope journal_scope(journal_);
+    journal_scope.record(SurfaceMeshJournal::Opcode::SplitEdge, e, v);
+
     Halfedge h0 = halfedge(e, 0);
     Halfedge o0 = halfedge(e, 1);
 
@@ -570,6 +642,9 @@ Halfedge SurfaceMesh::split(Edge e, Vertex v)
 
 Halfedge SurfaceMesh::insert_vertex(Halfedge h0, Vertex v)
 {
+    SurfaceMeshJournal::Scope journal_scope(journal_);
+    journal_scope.record(SurfaceMeshJournal::Opcode::InsertVertex, h0, v);
+
     // before:
     //
     // v0      h0       v2
@@ -623,6 +698,9 @@ Halfedge SurfaceMesh::insert_vertex(Halfedge h0, Vertex v)
 
 Halfedge SurfaceMesh::insert_edge(Halfedge h0, Halfedge h1)
 {
+    SurfaceMeshJournal::Scope journal_scope(journal_);
+    journal_scope.record(SurfaceMeshJournal::Opcode::InsertEdge, h0, h1);
+
     assert(face(h0) == face(h1));
     assert(face(h0).is_valid());
 
@@ -681,6 +759,9 @@ bool SurfaceMesh::is_flip_ok(Edge e) const
 
 void SurfaceMesh::flip(Edge e)
 {
+    SurfaceMeshJournal::Scope journal_scope(journal_);
+    journal_scope.record(SurfaceMeshJournal::Opcode::Flip, e);
+
     //let's make it sure it is actually checked
     assert(is_flip_ok(e));
 
@@ -805,6 +886,9 @@ bool SurfaceMesh::is_removal_ok(Edge e) const
 
 bool SurfaceMesh::remove_edge(Edge e)
 {
+    SurfaceMeshJournal::Scope journal_scope(journal_);
+    journal_scope.record(SurfaceMeshJournal::Opcode::RemoveEdge, e);
+
     if (!is_removal_ok(e))
         return false;
 
@@ -852,6 +936,9 @@ bool SurfaceMesh::remove_edge(Edge e)
 
 void SurfaceMesh::collapse(Halfedge h)
 {
+    SurfaceMeshJournal::Scope journal_scope(journal_);
+    journal_scope.record(SurfaceMeshJournal::Opcode::Collapse, h);
+
     Halfedge h0 = h;
     Halfedge h1 = prev_halfedge(h0);
     Halfedge o0 = opposite_halfedge(h0);
@@ -964,8 +1051,10 @@ void SurfaceMesh::remove_loop_helper(Halfedge h)
 
 void SurfaceMesh::delete_vertex(Vertex v)
 {
+    SurfaceMeshJournal::Scope journal_scope(journal_);
     if (is_deleted(v))
         return;
+    journal_scope.record(SurfaceMeshJournal::Opcode::DeleteVertex, v);
 
     // collect incident faces
     std::vector<Face> incident_faces;
@@ -989,8 +1078,10 @@ void SurfaceMesh::delete_vertex(Vertex v)
 
 void SurfaceMesh::delete_edge(Edge e)
 {
+    SurfaceMeshJournal::Scope journal_scope(journal_);
     if (is_deleted(e))
         return;
+    journal_scope.record(SurfaceMeshJournal::Opcode::DeleteEdge, e);
 
     Face f0 = face(halfedge(e, 0));
     Face f1 = face(halfedge(e, 1));
@@ -1003,8 +1094,10 @@ void SurfaceMesh::delete_edge(Edge e)
 
 void SurfaceMesh::delete_face(Face f)
 {
+    SurfaceMeshJournal::Scope journal_scope(journal_);
     if (fdeleted_[f])
         return;
+    journal_scope.record(SurfaceMeshJournal::Opcode::DeleteFace, f);
 
     // mark face deleted
     if (!fdeleted_[f])
@@ -1109,6 +1202,9 @@ void SurfaceMesh::delete_face(Face f)
 
 void SurfaceMesh::garbage_collection()
 {
+    SurfaceMeshJournal::Scope journal_scope(journal_);
+    journal_scope.record(SurfaceMeshJournal::Opcode::GarbageCollection);
+
     if (!has_garbage_)
         return;
 
@@ -1249,4 +1345,161 @@ void SurfaceMesh::garbage_collection()
     has_garbage_ = false;
 }
 
+HandleMaps SurfaceMesh::stable_garbage_collection()
+{
+    SurfaceMeshJournal::Scope journal_scope(journal_);
+    journal_scope.record(SurfaceMeshJournal::Opcode::StableGarbageCollection);
+
+    HandleMaps maps;
+
+    // new-to-old index arrays
+    const auto vorder = compaction_order(vdeleted_, vertices_size(),
+                                         maps.vertices);
+    const auto eorder = compaction_order(edeleted_, edges_size(), maps.edges);
+    const auto forder = compaction_order(fdeleted_, faces_size(), maps.faces);
+
+    // halfedges follow their edges
+    std::vector<size_t> horder(2 * eorder.size());
+    maps.halfedges.resize(halfedges_size());
+    for (size_t i = 0; i < maps.edges.size(); ++i)
+    {
+        const auto e = maps.edges[i];
+        maps.halfedges[2 * i] = e.is_valid() ? halfedge(e, 0) : Halfedge();
+        maps.halfedges[2 * i + 1] = e.is_valid() ? halfedge(e, 1) : Halfedge();
+    }
+    for (size_t i = 0; i < eorder.size(); ++i)
+    {
+        horder[2 * i] = 2 * eorder[i];
+        horder[2 * i + 1] = 2 * eorder[i] + 1;
+    }
+
+    // compact all property arrays
+    vprops_.permute(vorder);
+    hprops_.permute(horder);
+    eprops_.permute(eorder);
+    fprops_.permute(forder);
+
+    // update connectivity
+    const auto& vmap = maps.vertices;
+    const auto& hmap = maps.halfedges;
+    const auto& fmap = maps.faces;
+    const auto nV = vertices_size();
+    const auto nH = halfedges_size();
+    const auto nF = faces_size();
+
+#ifdef _OPENMP
+#pragma omp parallel for
+#endif
+    for (size_t i = 0; i < nV; ++i)
+    {
+        auto& h = vconn_[Vertex(i)].halfedge_;
+        if (h.is_valid())
+            h = hmap[h.idx()];
+    }
+
+#ifdef _OPENMP
+#pragma omp parallel for
+#endif
+    for (size_t i = 0; i < nH; ++i)
+    {
+        auto& hc = hconn_[Halfedge(i)];
+        hc.vertex_ = vmap[hc.vertex_.idx()];
+        hc.next_halfedge_ = hmap[hc.next_halfedge_.idx()];
+        hc.prev_halfedge_ = hmap[hc.prev_halfedge_.idx()];
+        if (hc.face_.is_valid())
+            hc.face_ = fmap[hc.face_.idx()];
+    }
+
+#ifdef _OPENMP
+#pragma omp parallel for
+#endif
+    for (size_t i = 0; i < nF; ++i)
+    {
+        auto& h = fconn_[Face(i)].halfedge_;
+        h = hmap[h.idx()];
+    }
+
+    deleted_vertices_ = deleted_edges_ = deleted_faces_ = 0;
+    has_garbage_ = false;
+
+    return maps;
+}
+
+void SurfaceMesh::permute(const std::vector<Vertex>& vertex_order,
+                          const std::vector<Edge>& edge_order,
+                          const std::vector<Face>& face_order)
+{
+    SurfaceMeshJournal::Scope journal_scope(journal_);
+    journal_scope.record(SurfaceMeshJournal::Opcode::Permute, vertex_order,
+                         edge_order, face_order);
+
+    const auto nV = vertices_size();
+    const auto nE = edges_size();
+    const auto nF = faces_size();
+
+    if (vertex_order.size() != nV || edge_order.size() != nE ||
+        face_order.size() != nF)
+    {
+        auto what = "SurfaceMesh::permute: Order does not match mesh size.";
+        throw InvalidInputException(what);
+    }
+
+    // new-to-old index arrays and their old-to-new inverse
+    std::vector<size_t> vorder(nV), horder(2 * nE), eorder(nE), forder(nF);
+    std::vector<IndexType> vmap(nV), hmap(2 * nE), fmap(nF);
+
+    for (size_t i = 0; i < nV; ++i)
+    {
+        vorder[i] = vertex_order[i].idx();
+        vmap[vorder[i]] = static_cast<IndexType>(i);
+    }
+    for (size_t i = 0; i < nE; ++i)
+    {
+        eorder[i] = edge_order[i].idx();
+        horder[2 * i] = 2 * eorder[i];
+        horder[2 * i + 1] = 2 * eorder[i] + 1;
+        hmap[horder[2 * i]] = static_cast<IndexType>(2 * i);
+        hmap[horder[2 * i + 1]] = static_cast<IndexType>(2 * i + 1);
+    }
+    for (size_t i = 0; i < nF; ++i)
+    {
+        forder[i] = face_order[i].idx();
+        fmap[forder[i]] = static_cast<IndexType>(i);
+    }
+
+    // move all property data
+    vprops_.permute(vorder);
+    hprops_.permute(horder);
+    eprops_.permute(eorder);
+    fprops_.permute(forder);
+
+    // update connectivity
+    for (size_t i = 0; i < nV; ++i)
+    {
+        auto& h = vconn_[Vertex(i)].halfedge_;
+        if (h.is_valid())
+            h = Halfedge(hmap[h.idx()]);
+    }
+
+    for (size_t i = 0; i < 2 * nE; ++i)
+    {
+        auto& hc = hconn_[Halfedge(i)];
+        if (hc.vertex_.is_valid())
+            hc.vertex_ = Vertex(vmap[hc.vertex_.idx()]);
+        if (hc.next_halfedge_.is_valid())
+            hc.next_halfedge_ = Halfedge(hmap[hc.next_halfedge_.idx()]);
+        if (hc.prev_halfedge_.is_valid())
+            hc.prev_halfedge_ = Halfedge(hmap[hc.prev_halfedge_.idx()]);
+        if (hc.face_.is_valid())
+            hc.face_ = Face(fmap[hc.face_.idx()]);
+    }
+
+    for (size_t i = 0; i < nF; ++i)
+    {
+        auto& h = fconn_[Face(i)].halfedge_;
+        if (h.is_valid())
+            h = Halfedge(hmap[h.idx()]);
+    }
+}
+
 } // namespace pmp
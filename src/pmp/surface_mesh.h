@@ -10,6 +10,7 @@
 #include <iterator>
 #include <ostream>
 #include <string>
+#include <string_view>
 #include <utility>
 #include <vector>
 
@@ -197,6 +198,20 @@ public:
     }
 };
 
+class SurfaceMeshJournal;
+
+//! \brief Old-to-new handle maps returned by
+//! SurfaceMesh::stable_garbage_collection().
+//! \details Each vector is indexed by the old element index. Deleted
+//! elements are mapped to an invalid handle.
+struct HandleMaps
+{
+    std::vector<Vertex> vertices;   //!< vertex map
+    std::vector<Halfedge> halfedges; //!< halfedge map
+    std::vector<Edge> edges;         //!< edge map
+    std::vector<Face> faces;         //!< face map
+};
+
 //! \brief A class for representing polygon surface meshes.
 //! \details This class implements a half-edge data structure for surface meshes.
 //! See \cite sieger_2011_design for details on the design and implementation.
@@ -1181,17 +1196,37 @@ public:
     //! default constructor
     SurfaceMesh();
 
+    //! \brief Construct a mesh allocating all property data from \p resource.
+    //! \details This includes properties added later, e.g., by algorithms,
+    //! and copies of the mesh. Using an arena such as
+    //! std::pmr::monotonic_buffer_resource for many small meshes avoids heap
+    //! fragmentation and releases their memory at once.
+    //! \pre \p resource outlives the mesh and all of its copies.
+    explicit SurfaceMesh(std::pmr::memory_resource* resource);
+
     //! destructor
     virtual ~SurfaceMesh();
 
-    //! copy constructor: copies \p rhs to \p *this. performs a deep copy of all
-    //! properties.
-    SurfaceMesh(const SurfaceMesh& rhs) { operator=(rhs); }
+    //! copy constructor: copies \p rhs to \p *this, including its memory
+    //! resource. properties are copied on write, i.e., their data is shared
+    //! until either mesh modifies it. this makes snapshots, e.g., for undo,
+    //! cheap.
+    SurfaceMesh(const SurfaceMesh& rhs)
+        : vprops_(rhs.vprops_.resource()),
+          hprops_(rhs.hprops_.resource()),
+          eprops_(rhs.eprops_.resource()),
+          fprops_(rhs.fprops_.resource())
+    {
+        operator=(rhs);
+    }
 
-    //! assign \p rhs to \p *this. performs a deep copy of all properties.
+    //! assign \p rhs to \p *this. properties are copied on write. the mesh
+    //! keeps its memory resource, and the data is copied right away if \p rhs
+    //! uses a different one.
     SurfaceMesh& operator=(const SurfaceMesh& rhs);
 
-    //! assign \p rhs to \p *this. does not copy custom properties.
+    //! assign \p rhs to \p *this. does not copy custom properties. the mesh
+    //! keeps its memory resource.
     SurfaceMesh& assign(const SurfaceMesh& rhs);
 
     //!@}
@@ -1257,6 +1292,42 @@ public:
     //! remove deleted elements
     void garbage_collection();
 
+    //! \brief Remove deleted elements while preserving the order of the
+    //! remaining ones.
+    //! \details In contrast to garbage_collection(), every property array is
+    //! compacted by a single bulk move, and the old-to-new handle maps are
+    //! returned such that external references can be updated.
+    //! \return maps from old to new handles
+    HandleMaps stable_garbage_collection();
+
+    //! \brief Reorder vertices, edges, and faces.
+    //! \details After reordering, vertex \c i is the former vertex
+    //! \c vertex_order[i], and likewise for edges and faces. The two halfedges
+    //! of an edge are moved along with it. All properties are permuted
+    //! accordingly and the connectivity is updated.
+    //! \pre Each order is a permutation of all elements of its kind,
+    //! including deleted ones.
+    //! \throw InvalidInputException if the size of an order does not match.
+    void permute(const std::vector<Vertex>& vertex_order,
+                 const std::vector<Edge>& edge_order,
+                 const std::vector<Face>& face_order);
+
+    //! \return the memory resource of the property data, or \c nullptr for
+    //! the global heap
+    std::pmr::memory_resource* memory_resource() const
+    {
+        return vprops_.resource();
+    }
+
+    //! \brief Record all subsequent edits to \p journal.
+    //! \details Pass \c nullptr to stop recording. The journal is owned by
+    //! the caller and not copied along with the mesh.
+    //! \sa SurfaceMeshJournal
+    void set_journal(SurfaceMeshJournal* journal) { journal_ = journal; }
+
+    //! \return the journal recording edits of this mesh, or \c nullptr
+    SurfaceMeshJournal* journal() const { return journal_; }
+
     //! \return whether vertex \p v is deleted
     //! \sa garbage_collection()
     bool is_deleted(Vertex v) const { return vdeleted_[v]; }
@@ -1453,7 +1524,7 @@ public:
     //! since the name has to be unique. in this case it returns an
     //! invalid property
     template <class T>
-    VertexProperty<T> add_vertex_property(const std::string& name,
+    VertexProperty<T> add_vertex_property(std::string_view name,
                                           const T t = T())
     {
         return VertexProperty<T>(vprops_.add<T>(name, t));
@@ -1463,16 +1534,23 @@ public:
     //! invalid VertexProperty if the property does not exist or if the
     //! type does not match.
     template <class T>
-    VertexProperty<T> get_vertex_property(const std::string& name) const
+    VertexProperty<T> get_vertex_property(std::string_view name) const
     {
         return VertexProperty<T>(vprops_.get<T>(name));
     }
 
+    //! get the vertex property identified by the typed key \p key
+    template <class T>
+    VertexProperty<T> get_vertex_property(PropertyKey<T> key) const
+    {
+        return VertexProperty<T>(vprops_.get<T>(key.name()));
+    }
+
     //! if a vertex property of type \p T with name \p name exists, it is
     //! returned. otherwise this property is added (with default value \c
     //! t)
     template <class T>
-    VertexProperty<T> vertex_property(const std::string& name, const T t = T())
+    VertexProperty<T> vertex_property(std::string_view name, const T t = T())
     {
         return VertexProperty<T>(vprops_.get_or_add<T>(name, t));
     }
@@ -1485,7 +1563,7 @@ public:
     }
 
     //! does the mesh have a vertex property with name \p name?
-    bool has_vertex_property(const std::string& name) const
+    bool has_vertex_property(std::string_view name) const
     {
         return vprops_.exists(name);
     }
@@ -1495,7 +1573,7 @@ public:
     //! since the name has to be unique. in this case it returns an
     //! invalid property.
     template <class T>
-    HalfedgeProperty<T> add_halfedge_property(const std::string& name,
+    HalfedgeProperty<T> add_halfedge_property(std::string_view name,
                                               const T t = T())
     {
         return HalfedgeProperty<T>(hprops_.add<T>(name, t));
@@ -1506,7 +1584,7 @@ public:
     //! since the name has to be unique.  in this case it returns an
     //! invalid property.
     template <class T>
-    EdgeProperty<T> add_edge_property(const std::string& name, const T t = T())
+    EdgeProperty<T> add_edge_property(std::string_view name, const T t = T())
     {
         return EdgeProperty<T>(eprops_.add<T>(name, t));
     }
@@ -1515,25 +1593,39 @@ public:
     //! invalid VertexProperty if the property does not exist or if the
     //! type does not match.
     template <class T>
-    HalfedgeProperty<T> get_halfedge_property(const std::string& name) const
+    HalfedgeProperty<T> get_halfedge_property(std::string_view name) const
     {
         return HalfedgeProperty<T>(hprops_.get<T>(name));
     }
 
+    //! get the halfedge property identified by the typed key \p key
+    template <class T>
+    HalfedgeProperty<T> get_halfedge_property(PropertyKey<T> key) const
+    {
+        return HalfedgeProperty<T>(hprops_.get<T>(key.name()));
+    }
+
     //! get the edge property named \p name of type \p T. returns an
     //! invalid VertexProperty if the property does not exist or if the
     //! type does not match.
     template <class T>
-    EdgeProperty<T> get_edge_property(const std::string& name) const
+    EdgeProperty<T> get_edge_property(std::string_view name) const
     {
         return EdgeProperty<T>(eprops_.get<T>(name));
     }
 
+    //! get the edge property identified by the typed key \p key
+    template <class T>
+    EdgeProperty<T> get_edge_property(PropertyKey<T> key) const
+    {
+        return EdgeProperty<T>(eprops_.get<T>(key.name()));
+    }
+
     //! if a halfedge property of type \p T with name \p name exists, it is
     //! returned.  otherwise this property is added (with default value \c
     //! t)
     template <class T>
-    HalfedgeProperty<T> halfedge_property(const std::string& name,
+    HalfedgeProperty<T> halfedge_property(std::string_view name,
                                           const T t = T())
     {
         return HalfedgeProperty<T>(hprops_.get_or_add<T>(name, t));
@@ -1543,7 +1635,7 @@ public:
     //! returned.  otherwise this property is added (with default value \c
     //! t)
     template <class T>
-    EdgeProperty<T> edge_property(const std::string& name, const T t = T())
+    EdgeProperty<T> edge_property(std::string_view name, const T t = T())
     {
         return EdgeProperty<T>(eprops_.get_or_add<T>(name, t));
     }
@@ -1556,7 +1648,7 @@ public:
     }
 
     //! does the mesh have a halfedge property with name \p name?
-    bool has_halfedge_property(const std::string& name) const
+    bool has_halfedge_property(std::string_view name) const
     {
         return hprops_.exists(name);
     }
@@ -1569,7 +1661,7 @@ public:
     }
 
     //! does the mesh have an edge property with name \p name?
-    bool has_edge_property(const std::string& name) const
+    bool has_edge_property(std::string_view name) const
     {
         return eprops_.exists(name);
     }
@@ -1596,7 +1688,7 @@ public:
     //! t.  fails if a property named \p name exists already, since the name has
     //! to be unique.  in this case it returns an invalid property
     template <class T>
-    FaceProperty<T> add_face_property(const std::string& name, const T t = T())
+    FaceProperty<T> add_face_property(std::string_view name, const T t = T())
     {
         return FaceProperty<T>(fprops_.add<T>(name, t));
     }
@@ -1605,15 +1697,22 @@ public:
     //! VertexProperty if the property does not exist or if the type does not
     //! match.
     template <class T>
-    FaceProperty<T> get_face_property(const std::string& name) const
+    FaceProperty<T> get_face_property(std::string_view name) const
     {
         return FaceProperty<T>(fprops_.get<T>(name));
     }
 
+    //! get the face property identified by the typed key \p key
+    template <class T>
+    FaceProperty<T> get_face_property(PropertyKey<T> key) const
+    {
+        return FaceProperty<T>(fprops_.get<T>(key.name()));
+    }
+
     //! if a face property of type \p T with name \p name exists, it is
     //! returned.  otherwise this property is added (with default value \p t)
     template <class T>
-    FaceProperty<T> face_property(const std::string& name, const T t = T())
+    FaceProperty<T> face_property(std::string_view name, const T t = T())
     {
         return FaceProperty<T>(fprops_.get_or_add<T>(name, t));
     }
@@ -1626,7 +1725,7 @@ public:
     }
 
     //! does the mesh have a face property with name \p name?
-    bool has_face_property(const std::string& name) const
+    bool has_face_property(std::string_view name) const
     {
         return fprops_.exists(name);
     }
@@ -1897,7 +1996,7 @@ public:
     Point& position(Vertex v) { return vpoint_[v]; }
 
     //! \return vector of point positions
-    std::vector<Point>& positions() { return vpoint_.vector(); }
+    PropertyArray<Point>::VectorType& positions() { return vpoint_.vector(); }
 
     //!@}
 
@@ -2020,6 +2119,9 @@ private:
     friend void write_pmp(const SurfaceMesh&, const std::filesystem::path&,
                           const IOFlags&);
 
+    // replays property writes by name
+    friend class SurfaceMeshJournal;
+
     // property containers for each entity type and object
     PropertyContainer vprops_;
     PropertyContainer hprops_;
@@ -2047,6 +2149,9 @@ private:
     // indicate garbage present
     bool has_garbage_{false};
 
+    // journal recording edits, not copied
+    SurfaceMeshJournal* journal_{nullptr};
+
     // helper data for add_face()
     using NextCacheEntry = std::pair<Halfedge, Halfedge>;
     using NextCache = std::vector<NextCacheEntry>;
@@ -0,0 +1,307 @@
+// Copyright 2023 the Polygon Mesh Processing Library developers.
+// Distributed under a MIT-style license, see LICENSE.txt for details.
+
+#include "pmp/surface_mesh_journal.h"
+
+namespace pmp {
+namespace {
+
+[[noreturn]] void fail(const std::string& what)
+{
+    throw InvalidInputException("SurfaceMeshJournal::replay: " + what);
+}
+
+// sequential decoding of a journal, checking all bounds
+class Reader
+{
+public:
+    explicit Reader(const std::vector<uint8_t>& data) : data_(data) {}
+
+    bool at_end() const { return pos_ == data_.size(); }
+
+    const uint8_t* bytes(size_t n)
+    {
+        if (n > data_.size() - pos_)
+            fail("Malformed journal.");
+        const uint8_t* p = data_.data() + pos_;
+        pos_ += n;
+        return p;
+    }
+
+    uint8_t byte() { return *bytes(1); }
+
+    uint64_t integer()
+    {
+        uint64_t x = 0;
+        for (int shift = 0; shift < 64; shift += 7)
+        {
+            const uint8_t b = byte();
+            x |= uint64_t(b & 0x7f) << shift;
+            if (!(b & 0x80))
+                return x;
+        }
+        fail("Malformed journal.");
+    }
+
+    Point point()
+    {
+        Point p;
+        std::memcpy(&p, bytes(sizeof(Point)), sizeof(Point));
+        return p;
+    }
+
+    // a valid handle with index less than n
+    template <class HandleT>
+    HandleT handle(size_t n)
+    {
+        const uint64_t i = integer();
+        if (i == 0 || i > n)
+            fail("Invalid element.");
+        return HandleT(static_cast<IndexType>(i - 1));
+    }
+
+    Vertex vertex(const SurfaceMesh& mesh)
+    {
+        return handle<Vertex>(mesh.vertices_size());
+    }
+
+    // an isolated vertex, as required for inserting it into the mesh
+    Vertex isolated_vertex(const SurfaceMesh& mesh)
+    {
+        const Vertex v = vertex(mesh);
+        if (mesh.is_deleted(v) || !mesh.is_isolated(v))
+            fail("Vertex is not isolated.");
+        return v;
+    }
+
+    // elements that are not deleted
+    template <class HandleT>
+    HandleT existing(const SurfaceMesh& mesh, HandleT h)
+    {
+        if (mesh.is_deleted(h))
+            fail("Deleted element.");
+        return h;
+    }
+
+    Halfedge halfedge(const SurfaceMesh& mesh)
+    {
+        return handle<Halfedge>(mesh.halfedges_size());
+    }
+
+    Edge edge(const SurfaceMesh& mesh)
+    {
+        return handle<Edge>(mesh.edges_size());
+    }
+
+    Face face(const SurfaceMesh& mesh)
+    {
+        return handle<Face>(mesh.faces_size());
+    }
+
+    // a permutation of n handles
+    template <class HandleT>
+    std::vector<HandleT> handles(size_t n)
+    {
+        const uint64_t size = integer();
+        if (size != n)
+            fail("Invalid element order.");
+        std::vector<HandleT> result(n);
+        std::vector<bool> seen(n, false);
+        for (auto& h : result)
+        {
+            h = handle<HandleT>(n);
+            if (seen[h.idx()])
+                fail("Invalid element order.");
+            seen[h.idx()] = true;
+        }
+        return result;
+    }
+
+private:
+    const std::vector<uint8_t>& data_;
+    size_t pos_{0};
+};
+
+// detach the journal of a mesh during replay
+class DetachJournal
+{
+public:
+    explicit DetachJournal(SurfaceMesh& mesh)
+        : mesh_(mesh), journal_(mesh.journal())
+    {
+        mesh_.set_journal(nullptr);
+    }
+
+    ~DetachJournal() { mesh_.set_journal(journal_); }
+
+    DetachJournal(const DetachJournal&) = delete;
+    DetachJournal& operator=(const DetachJournal&) = delete;
+
+private:
+    SurfaceMesh& mesh_;
+    SurfaceMeshJournal* journal_;
+};
+
+} // namespace
+
+void SurfaceMeshJournal::replay(SurfaceMesh& mesh) const
+{
+    DetachJournal detach(mesh);
+    Reader in(data_);
+    std::vector<Vertex> vertices;
+
+    while (!in.at_end())
+    {
+        const auto op = static_cast<Opcode>(in.byte());
+        switch (op)
+        {
+            case Opcode::AddVertex:
+                mesh.add_vertex(in.point());
+                break;
+
+            case Opcode::AddFace:
+            {
+                const uint64_t n = in.integer();
+                if (n < 3 || n > mesh.vertices_size())
+                    fail("Invalid face.");
+                vertices.resize(n);
+                for (auto& v : vertices)
+                    v = in.vertex(mesh);
+                try
+                {
+                    mesh.add_face(vertices);
+                }
+                catch (const TopologyException& e)
+                {
+                    fail(e.what());
+                }
+                break;
+            }
+
+            case Opcode::SplitFace:
+            {
+                const Face f = in.existing(mesh, in.face(mesh));
+                const Vertex v = in.isolated_vertex(mesh);
+                mesh.split(f, v);
+                break;
+            }
+
+            case Opcode::SplitEdge:
+            {
+                const Edge e = in.existing(mesh, in.edge(mesh));
+                const Vertex v = in.isolated_vertex(mesh);
+                mesh.split(e, v);
+                break;
+            }
+
+            case Opcode::InsertVertex:
+            {
+                const Halfedge h = in.existing(mesh, in.halfedge(mesh));
+                const Vertex v = in.isolated_vertex(mesh);
+                mesh.insert_vertex(h, v);
+                break;
+            }
+
+            case Opcode::InsertEdge:
+            {
+                // both halfedges in the same face, not adjacent
+                const Halfedge h0 = in.existing(mesh, in.halfedge(mesh));
+                const Halfedge h1 = in.existing(mesh, in.halfedge(mesh));
+                const Face f = mesh.face(h0);
+                if (!f.is_valid() || mesh.face(h1) != f || h0 == h1 ||
+                    mesh.next_halfedge(h0) == h1 ||
+                    mesh.next_halfedge(h1) == h0)
+                    fail("Edge insertion not possible.");
+                mesh.insert_edge(h0, h1);
+                break;
+            }
+
+            case Opcode::Flip:
+            {
+                const Edge e = in.existing(mesh, in.edge(mesh));
+                if (!mesh.is_flip_ok(e))
+                    fail("Edge flip not possible.");
+                mesh.flip(e);
+                break;
+            }
+
+            case Opcode::Collapse:
+            {
+                const Halfedge h = in.existing(mesh, in.halfedge(mesh));
+                if (!mesh.is_collapse_ok(h))
+                    fail("Halfedge collapse not possible.");
+                mesh.collapse(h);
+                break;
+            }
+
+            case Opcode::RemoveEdge:
+            {
+                const Edge e = in.existing(mesh, in.edge(mesh));
+                if (!mesh.is_removal_ok(e))
+                    fail("Edge removal not possible.");
+                mesh.remove_edge(e);
+                break;
+            }
+
+            case Opcode::DeleteVertex:
+                mesh.delete_vertex(in.existing(mesh, in.vertex(mesh)));
+                break;
+
+            case Opcode::DeleteEdge:
+                mesh.delete_edge(in.existing(mesh, in.edge(mesh)));
+                break;
+
+            case Opcode::DeleteFace:
+                mesh.delete_face(in.existing(mesh, in.face(mesh)));
+                break;
+
+            case Opcode::GarbageCollection:
+                mesh.garbage_collection();
+                break;
+
+            case Opcode::StableGarbageCollection:
+                mesh.stable_garbage_collection();
+                break;
+
+            case Opcode::Permute:
+            {
+                const auto vorder = in.handles<Vertex>(mesh.vertices_size());
+                const auto eorder = in.handles<Edge>(mesh.edges_size());
+                const auto forder = in.handles<Face>(mesh.faces_size());
+                mesh.permute(vorder, eorder, forder);
+                break;
+            }
+
+            case Opcode::VertexProperty:
+            case Opcode::HalfedgeProperty:
+            case Opcode::EdgeProperty:
+            case Opcode::FaceProperty:
+            {
+                const uint64_t length = in.integer();
+                const auto* name = reinterpret_cast<const char*>(
+                    in.bytes(static_cast<size_t>(length)));
+                const uint64_t idx = in.integer();
+                const uint64_t size = in.integer();
+                const auto* value = in.bytes(static_cast<size_t>(size));
+
+                PropertyContainer& container =
+                    op == Opcode::VertexProperty     ? mesh.vprops_
+                    : op == Opcode::HalfedgeProperty ? mesh.hprops_
+                    : op == Opcode::EdgeProperty     ? mesh.eprops_
+                                                     : mesh.fprops_;
+                auto* array = container.find(
+                    std::string_view(name, static_cast<size_t>(length)));
+                if (!array ||
+                    !array->set_bytes(static_cast<size_t>(idx), value,
+                                      static_cast<size_t>(size)))
+                    fail("Invalid property write.");
+                break;
+            }
+
+            default:
+                fail("Malformed journal.");
+        }
+    }
+}
+
+} // namespace pmp
@@ -0,0 +1,222 @@
+// Copyright 2023 the Polygon Mesh Processing Library developers.
+// Distributed under a MIT-style license, see LICENSE.txt for details.
+
+#pragma once
+
+#include <cstdint>
+#include <cstring>
+#include <string_view>
+#include <type_traits>
+#include <vector>
+
+#include "pmp/surface_mesh.h"
+
+namespace pmp {
+
+//! \brief A compact binary log of edits of a SurfaceMesh.
+//! \details Once attached by SurfaceMesh::set_journal(), the mesh records
+//! its topological operators, i.e., adding vertices and faces, splits,
+//! flips, collapses, edge insertion and removal, deletion, and garbage
+//! collection. Writes to properties are recorded explicitly by record().
+//! Applying a journal to a copy of the mesh in its state at the time of
+//! attaching the journal reproduces the edits, e.g., to synchronize remote
+//! copies of a mesh:
+//! \code
+//! SurfaceMeshJournal journal;
+//! mesh.set_journal(&journal);
+//! mesh.flip(e);
+//! mesh.position(v) = p;
+//! journal.record(mesh.get_vertex_property<Point>("v:point"), v);
+//! send(journal.data());
+//!
+//! // on the remote side
+//! SurfaceMeshJournal(receive()).replay(remote_mesh);
+//! \endcode
+//! \note Only the outermost operator is recorded. Low-level connectivity
+//! setters such as SurfaceMesh::set_next_halfedge() are not recorded.
+//! \note Handle indices are stored as variable-length integers, positions
+//! and property values as raw bytes. Journals can therefore only be
+//! exchanged between builds using the same \c Scalar type and byte order.
+//! \ingroup core
+class SurfaceMeshJournal
+{
+public:
+    //! Construct an empty journal.
+    SurfaceMeshJournal() = default;
+
+    //! Construct from the data() of another journal.
+    explicit SurfaceMeshJournal(std::vector<uint8_t> data)
+        : data_(std::move(data))
+    {
+    }
+
+    //! \return the encoded journal
+    const std::vector<uint8_t>& data() const { return data_; }
+
+    //! \return whether the journal contains no records
+    bool empty() const { return data_.empty(); }
+
+    //! Remove all records.
+    void clear() { data_.clear(); }
+
+    //! \brief Record the value of property \p p at vertex \p v.
+    //! \details \p T has to be trivially copyable.
+    template <class T>
+    void record(const VertexProperty<T>& p, Vertex v)
+    {
+        record_property(Opcode::VertexProperty, p, v.idx());
+    }
+
+    //! \brief Record the value of property \p p at halfedge \p h.
+    //! \details \p T has to be trivially copyable.
+    template <class T>
+    void record(const HalfedgeProperty<T>& p, Halfedge h)
+    {
+        record_property(Opcode::HalfedgeProperty, p, h.idx());
+    }
+
+    //! \brief Record the value of property \p p at edge \p e.
+    //! \details \p T has to be trivially copyable.
+    template <class T>
+    void record(const EdgeProperty<T>& p, Edge e)
+    {
+        record_property(Opcode::EdgeProperty, p, e.idx());
+    }
+
+    //! \brief Record the value of property \p p at face \p f.
+    //! \details \p T has to be trivially copyable.
+    template <class T>
+    void record(const FaceProperty<T>& p, Face f)
+    {
+        record_property(Opcode::FaceProperty, p, f.idx());
+    }
+
+    //! \brief Apply all recorded edits to \p mesh.
+    //! \details Edits are not recorded again if \p mesh has a journal.
+    //! \throw InvalidInputException if the journal is malformed, refers to
+    //! elements or properties missing in \p mesh, or if the preconditions
+    //! of an operator do not hold, e.g., for deleting a deleted element or
+    //! inserting an edge between halfedges of different faces.
+    void replay(SurfaceMesh& mesh) const;
+
+private:
+    friend class SurfaceMesh;
+
+    enum class Opcode : uint8_t
+    {
+        AddVertex,
+        AddFace,
+        SplitFace,
+        SplitEdge,
+        InsertVertex,
+        InsertEdge,
+        Flip,
+        Collapse,
+        RemoveEdge,
+        DeleteVertex,
+        DeleteEdge,
+        DeleteFace,
+        GarbageCollection,
+        StableGarbageCollection,
+        Permute,
+        VertexProperty,
+        HalfedgeProperty,
+        EdgeProperty,
+        FaceProperty
+    };
+
+    // counts nested operators, such that only the outermost is recorded
+    class Scope
+    {
+    public:
+        explicit Scope(SurfaceMeshJournal* journal) : journal_(journal)
+        {
+            if (journal_)
+                ++journal_->depth_;
+        }
+
+        ~Scope()
+        {
+            if (journal_)
+                --journal_->depth_;
+        }
+
+        Scope(const Scope&) = delete;
+        Scope& operator=(const Scope&) = delete;
+
+        // record operator op with its arguments, unless nested
+        template <class... Args>
+        void record(Opcode op, const Args&... args)
+        {
+            if (journal_ && journal_->depth_ == 1)
+            {
+                journal_->put(op);
+                (journal_->put_arg(args), ...);
+            }
+        }
+
+    private:
+        SurfaceMeshJournal* journal_;
+    };
+
+    void put(Opcode op) { data_.push_back(static_cast<uint8_t>(op)); }
+
+    // LEB128 encoding of unsigned integers
+    void put(uint64_t x)
+    {
+        while (x >= 0x80)
+        {
+            data_.push_back(static_cast<uint8_t>(x | 0x80));
+            x >>= 7;
+        }
+        data_.push_back(static_cast<uint8_t>(x));
+    }
+
+    // invalid handles are stored as zero, valid ones as index + 1
+    template <class HandleT>
+    void put_handle(HandleT h)
+    {
+        put(h.is_valid() ? uint64_t(h.idx()) + 1 : uint64_t(0));
+    }
+
+    void put_bytes(const void* bytes, size_t n)
+    {
+        const auto* p = static_cast<const uint8_t*>(bytes);
+        data_.insert(data_.end(), p, p + n);
+    }
+
+    template <class HandleT>
+    void put_arg(HandleT h)
+    {
+        put_handle(h);
+    }
+
+    template <class HandleT>
+    void put_arg(const std::vector<HandleT>& handles)
+    {
+        put(uint64_t(handles.size()));
+        for (auto h : handles)
+            put_handle(h);
+    }
+
+    void put_arg(const Point& p) { put_bytes(&p, sizeof(Point)); }
+
+    template <class T>
+    void record_property(Opcode op, const Property<T>& p, size_t idx)
+    {
+        static_assert(std::is_trivially_copyable_v<T>,
+                      "Only trivially copyable properties can be recorded.");
+        const std::string& name = p.name();
+        put(op);
+        put(uint64_t(name.size()));
+        put_bytes(name.data(), name.size());
+        put(uint64_t(idx));
+        put(uint64_t(sizeof(T)));
+        put_bytes(&p[idx], sizeof(T));
+    }
+
+    std::vector<uint8_t> data_;
+    int depth_{0};
+};
+
+} // namespace pmp
@@ -0,0 +1,450 @@
+// Copyright 2023 the Polygon Mesh Processing Library developers.
+// Distributed under a MIT-style license, see LICENSE.txt for details.
+
+#pragma once
+
+#include <algorithm>
+#include <string_view>
+
+#include "pmp/surface_mesh.h"
+
+namespace pmp {
+
+//! \brief Read-only access to a property through a SurfaceMeshView.
+//! \details Stores a raw pointer to the property data, such that element
+//! access does not touch the property container.
+//! \ingroup core
+template <class HandleT, class T>
+class ReadOnlyProperty
+{
+public:
+    //! Construct an invalid property.
+    ReadOnlyProperty() = default;
+
+    //! Construct from a property of the viewed mesh.
+    explicit ReadOnlyProperty(const Property<T>& p)
+        : data_(p ? p.data() : nullptr), size_(p ? p.size() : 0)
+    {
+    }
+
+    //! \return whether the property exists
+    explicit operator bool() const { return data_ != nullptr; }
+
+    //! access the data stored for element \p h
+    const T& operator[](HandleT h) const
+    {
+        assert(data_ != nullptr && h.idx() < size_);
+        return data_[h.idx()];
+    }
+
+    //! Get pointer to the array of size() elements
+    const T* data() const { return data_; }
+
+    //! Get the number of elements
+    size_t size() const { return size_; }
+
+private:
+    const T* data_{nullptr};
+    size_t size_{0};
+};
+
+//! \brief Per-element storage owned by the caller instead of the mesh.
+//! \details Created by SurfaceMeshView for temporary per-thread data, e.g.,
+//! distances or visited flags of a query. Scratch properties use the memory
+//! resource of the viewed mesh.
+//! \ingroup core
+template <class HandleT, class T>
+class ScratchProperty
+{
+public:
+    //! \brief Construct storage for \p n elements initialized to \p t.
+    //! \details Memory is allocated from \p resource, if given.
+    ScratchProperty(size_t n, const T& t,
+                    std::pmr::memory_resource* resource = nullptr)
+        : array_("scratch", t, resource)
+    {
+        array_.resize(n);
+    }
+
+    //! access the data stored for element \p h
+    T& operator[](HandleT h) { return array_[h.idx()]; }
+
+    //! access the data stored for element \p h
+    const T& operator[](HandleT h) const { return array_[h.idx()]; }
+
+    //! Set all elements to \p t.
+    void fill(const T& t) { std::fill(data(), data() + size(), t); }
+
+    //! Get pointer to the aligned array of size() elements
+    T* data() { return array_.data(); }
+
+    //! Get pointer to the aligned array of size() elements
+    const T* data() const { return array_.data(); }
+
+    //! Get the number of elements
+    size_t size() const { return array_.size(); }
+
+private:
+    PropertyArray<T> array_;
+};
+
+template <class T>
+using VertexScratch = ScratchProperty<Vertex, T>;
+template <class T>
+using HalfedgeScratch = ScratchProperty<Halfedge, T>;
+template <class T>
+using EdgeScratch = ScratchProperty<Edge, T>;
+template <class T>
+using FaceScratch = ScratchProperty<Face, T>;
+
+//! \brief A frozen, read-only view of a SurfaceMesh.
+//! \details The view only exposes queries of the mesh, and properties only
+//! as ReadOnlyProperty, such that no function of the view can modify the
+//! mesh. Property lookups never add a property. Any number of threads can
+//! therefore query the same mesh through views concurrently without
+//! locking. Temporary per-element data is kept in scratch properties owned
+//! by the caller instead of the mesh, e.g.,
+//! \code
+//! SurfaceMeshView view(mesh);
+//! auto visited = view.vertex_scratch<bool>(false);
+//! for (auto vv : view.vertices(v))
+//!     visited[vv] = true;
+//! \endcode
+//! \warning The mesh must neither be modified nor destroyed while views on
+//! it are in use.
+//! \ingroup core
+class SurfaceMeshView
+{
+public:
+    //! Construct a view of \p mesh.
+    explicit SurfaceMeshView(const SurfaceMesh& mesh) : mesh_(&mesh) {}
+
+    //! \name Memory management
+    //!@{
+
+    //! \return number of (deleted and valid) vertices in the mesh
+    size_t vertices_size() const { return mesh_->vertices_size(); }
+
+    //! \return number of (deleted and valid) halfedges in the mesh
+    size_t halfedges_size() const { return mesh_->halfedges_size(); }
+
+    //! \return number of (deleted and valid) edges in the mesh
+    size_t edges_size() const { return mesh_->edges_size(); }
+
+    //! \return number of (deleted and valid) faces in the mesh
+    size_t faces_size() const { return mesh_->faces_size(); }
+
+    //! \return number of vertices in the mesh
+    size_t n_vertices() const { return mesh_->n_vertices(); }
+
+    //! \return number of halfedge in the mesh
+    size_t n_halfedges() const { return mesh_->n_halfedges(); }
+
+    //! \return number of edges in the mesh
+    size_t n_edges() const { return mesh_->n_edges(); }
+
+    //! \return number of faces in the mesh
+    size_t n_faces() const { return mesh_->n_faces(); }
+
+    //! \return true if the mesh is empty, i.e., has no vertices
+    bool is_empty() const { return mesh_->is_empty(); }
+
+    //! \return whether vertex \p v is deleted
+    bool is_deleted(Vertex v) const { return mesh_->is_deleted(v); }
+
+    //! \return whether halfedge \p h is deleted
+    bool is_deleted(Halfedge h) const { return mesh_->is_deleted(h); }
+
+    //! \return whether edge \p e is deleted
+    bool is_deleted(Edge e) const { return mesh_->is_deleted(e); }
+
+    //! \return whether face \p f is deleted
+    bool is_deleted(Face f) const { return mesh_->is_deleted(f); }
+
+    //! \return whether vertex \p v is valid
+    bool is_valid(Vertex v) const { return mesh_->is_valid(v); }
+
+    //! \return whether halfedge \p h is valid
+    bool is_valid(Halfedge h) const { return mesh_->is_valid(h); }
+
+    //! \return whether edge \p e is valid
+    bool is_valid(Edge e) const { return mesh_->is_valid(e); }
+
+    //! \return whether face \p f is valid
+    bool is_valid(Face f) const { return mesh_->is_valid(f); }
+
+    //!@}
+    //! \name Low-level connectivity
+    //!@{
+
+    //! \return an outgoing halfedge of vertex \p v
+    Halfedge halfedge(Vertex v) const { return mesh_->halfedge(v); }
+
+    //! \return whether \p v is a boundary vertex
+    bool is_boundary(Vertex v) const { return mesh_->is_boundary(v); }
+
+    //! \return whether \p v is isolated, i.e., not incident to any edge
+    bool is_isolated(Vertex v) const { return mesh_->is_isolated(v); }
+
+    //! \return whether \p v is a manifold vertex
+    bool is_manifold(Vertex v) const { return mesh_->is_manifold(v); }
+
+    //! \return the vertex the halfedge \p h points to
+    Vertex to_vertex(Halfedge h) const { return mesh_->to_vertex(h); }
+
+    //! \return the vertex the halfedge \p h emanates from
+    Vertex from_vertex(Halfedge h) const { return mesh_->from_vertex(h); }
+
+    //! \return the face incident to halfedge \p h
+    Face face(Halfedge h) const { return mesh_->face(h); }
+
+    //! \return the next halfedge within the incident face
+    Halfedge next_halfedge(Halfedge h) const
+    {
+        return mesh_->next_halfedge(h);
+    }
+
+    //! \return the previous halfedge within the incident face
+    Halfedge prev_halfedge(Halfedge h) const
+    {
+        return mesh_->prev_halfedge(h);
+    }
+
+    //! \return the opposite halfedge of \p h
+    Halfedge opposite_halfedge(Halfedge h) const
+    {
+        return mesh_->opposite_halfedge(h);
+    }
+
+    //! \return the halfedge that is rotated counter-clockwise around the
+    //! start vertex of \p h
+    Halfedge ccw_rotated_halfedge(Halfedge h) const
+    {
+        return mesh_->ccw_rotated_halfedge(h);
+    }
+
+    //! \return the halfedge that is rotated clockwise around the start
+    //! vertex of \p h
+    Halfedge cw_rotated_halfedge(Halfedge h) const
+    {
+        return mesh_->cw_rotated_halfedge(h);
+    }
+
+    //! \return the edge that contains halfedge \p h as one of its two
+    //! halfedges
+    Edge edge(Halfedge h) const { return mesh_->edge(h); }
+
+    //! \return whether h is a boundary halfedge, i.e., if its face does not
+    //! exist
+    bool is_boundary(Halfedge h) const { return mesh_->is_boundary(h); }
+
+    //! \return the \p i'th halfedge of edge \p e. \p i has to be 0 or 1
+    Halfedge halfedge(Edge e, unsigned int i) const
+    {
+        return mesh_->halfedge(e, i);
+    }
+
+    //! \return the \p i'th vertex of edge \p e. \p i has to be 0 or 1
+    Vertex vertex(Edge e, unsigned int i) const { return mesh_->vertex(e, i); }
+
+    //! \return the face incident to the \p i'th halfedge of edge \p e
+    Face face(Edge e, unsigned int i) const { return mesh_->face(e, i); }
+
+    //! \return whether \p e is a boundary edge
+    bool is_boundary(Edge e) const { return mesh_->is_boundary(e); }
+
+    //! \return a halfedge of face \p f
+    Halfedge halfedge(Face f) const { return mesh_->halfedge(f); }
+
+    //! \return whether \p f is a boundary face
+    bool is_boundary(Face f) const { return mesh_->is_boundary(f); }
+
+    //!@}
+    //! \name Read-only properties
+    //!@{
+
+    //! get the vertex property named \p name of type \p T. returns an
+    //! invalid ReadOnlyProperty if the property does not exist.
+    template <class T>
+    ReadOnlyProperty<Vertex, T> get_vertex_property(std::string_view name) const
+    {
+        return ReadOnlyProperty<Vertex, T>(mesh_->get_vertex_property<T>(name));
+    }
+
+    //! get the halfedge property named \p name of type \p T. returns an
+    //! invalid ReadOnlyProperty if the property does not exist.
+    template <class T>
+    ReadOnlyProperty<Halfedge, T> get_halfedge_property(
+        std::string_view name) const
+    {
+        return ReadOnlyProperty<Halfedge, T>(
+            mesh_->get_halfedge_property<T>(name));
+    }
+
+    //! get the edge property named \p name of type \p T. returns an
+    //! invalid ReadOnlyProperty if the property does not exist.
+    template <class T>
+    ReadOnlyProperty<Edge, T> get_edge_property(std::string_view name) const
+    {
+        return ReadOnlyProperty<Edge, T>(mesh_->get_edge_property<T>(name));
+    }
+
+    //! get the face property named \p name of type \p T. returns an
+    //! invalid ReadOnlyProperty if the property does not exist.
+    template <class T>
+    ReadOnlyProperty<Face, T> get_face_property(std::string_view name) const
+    {
+        return ReadOnlyProperty<Face, T>(mesh_->get_face_property<T>(name));
+    }
+
+    //! does the mesh have a vertex property with name \p name?
+    bool has_vertex_property(std::string_view name) const
+    {
+        return mesh_->has_vertex_property(name);
+    }
+
+    //! does the mesh have a halfedge property with name \p name?
+    bool has_halfedge_property(std::string_view name) const
+    {
+        return mesh_->has_halfedge_property(name);
+    }
+
+    //! does the mesh have an edge property with name \p name?
+    bool has_edge_property(std::string_view name) const
+    {
+        return mesh_->has_edge_property(name);
+    }
+
+    //! does the mesh have a face property with name \p name?
+    bool has_face_property(std::string_view name) const
+    {
+        return mesh_->has_face_property(name);
+    }
+
+    //!@}
+    //! \name Iterators and circulators
+    //!@{
+
+    //! \return vertex container for C++11 range-based for-loops
+    SurfaceMesh::VertexContainer vertices() const { return mesh_->vertices(); }
+
+    //! \return halfedge container for C++11 range-based for-loops
+    SurfaceMesh::HalfedgeContainer halfedges() const
+    {
+        return mesh_->halfedges();
+    }
+
+    //! \return edge container for C++11 range-based for-loops
+    SurfaceMesh::EdgeContainer edges() const { return mesh_->edges(); }
+
+    //! \return face container for C++11 range-based for-loops
+    SurfaceMesh::FaceContainer faces() const { return mesh_->faces(); }
+
+    //! \return circulator for vertices around vertex \p v
+    SurfaceMesh::VertexAroundVertexCirculator vertices(Vertex v) const
+    {
+        return mesh_->vertices(v);
+    }
+
+    //! \return circulator for edges around vertex \p v
+    SurfaceMesh::EdgeAroundVertexCirculator edges(Vertex v) const
+    {
+        return mesh_->edges(v);
+    }
+
+    //! \return circulator for outgoing halfedges around vertex \p v
+    SurfaceMesh::HalfedgeAroundVertexCirculator halfedges(Vertex v) const
+    {
+        return mesh_->halfedges(v);
+    }
+
+    //! \return circulator for faces around vertex \p v
+    SurfaceMesh::FaceAroundVertexCirculator faces(Vertex v) const
+    {
+        return mesh_->faces(v);
+    }
+
+    //! \return circulator for vertices of face \p f
+    SurfaceMesh::VertexAroundFaceCirculator vertices(Face f) const
+    {
+        return mesh_->vertices(f);
+    }
+
+    //! \return circulator for halfedges of face \p f
+    SurfaceMesh::HalfedgeAroundFaceCirculator halfedges(Face f) const
+    {
+        return mesh_->halfedges(f);
+    }
+
+    //!@}
+    //! \name Higher-level topological queries
+    //!@{
+
+    //! find the halfedge from \p start to \p end
+    Halfedge find_halfedge(Vertex start, Vertex end) const
+    {
+        return mesh_->find_halfedge(start, end);
+    }
+
+    //! find the edge (a,b)
+    Edge find_edge(Vertex a, Vertex b) const { return mesh_->find_edge(a, b); }
+
+    //! \return whether the mesh a triangle mesh
+    bool is_triangle_mesh() const { return mesh_->is_triangle_mesh(); }
+
+    //! \return whether the mesh a quad mesh
+    bool is_quad_mesh() const { return mesh_->is_quad_mesh(); }
+
+    //! \return the valence (number of incident edges or neighboring
+    //! vertices) of vertex \p v
+    size_t valence(Vertex v) const { return mesh_->valence(v); }
+
+    //! \return the valence of face \p f (its number of vertices)
+    size_t valence(Face f) const { return mesh_->valence(f); }
+
+    //! position of a vertex
+    const Point& position(Vertex v) const { return mesh_->position(v); }
+
+    //!@}
+    //! \name Scratch properties
+    //!@{
+
+    //! create caller-owned storage for all vertices, initialized to \p t
+    template <class T>
+    VertexScratch<T> vertex_scratch(const T& t = T()) const
+    {
+        return VertexScratch<T>(mesh_->vertices_size(), t,
+                                mesh_->memory_resource());
+    }
+
+    //! create caller-owned storage for all halfedges, initialized to \p t
+    template <class T>
+    HalfedgeScratch<T> halfedge_scratch(const T& t = T()) const
+    {
+        return HalfedgeScratch<T>(mesh_->halfedges_size(), t,
+                                  mesh_->memory_resource());
+    }
+
+    //! create caller-owned storage for all edges, initialized to \p t
+    template <class T>
+    EdgeScratch<T> edge_scratch(const T& t = T()) const
+    {
+        return EdgeScratch<T>(mesh_->edges_size(), t,
+                              mesh_->memory_resource());
+    }
+
+    //! create caller-owned storage for all faces, initialized to \p t
+    template <class T>
+    FaceScratch<T> face_scratch(const T& t = T()) const
+    {
+        return FaceScratch<T>(mesh_->faces_size(), t,
+                              mesh_->memory_resource());
+    }
+
+    //!@}
+
+private:
+    const SurfaceMesh* mesh_;
+};
+
+} // namespace pmp
@@ -0,0 +1,133 @@
+// Copyright 2023 the Polygon Mesh Processing Library developers.
+// Distributed under a MIT-style license, see LICENSE.txt for details.
+
+#include "pmp/trace.h"
+
+#include <fstream>
+#include <iomanip>
+
+#include "pmp/exceptions.h"
+#include "pmp/memory_usage.h"
+
+namespace pmp {
+namespace {
+
+// small consecutive indices for the threads recording events
+uint32_t thread_index()
+{
+    static std::atomic<uint32_t> n_threads{0};
+    thread_local const uint32_t index = n_threads++;
+    return index;
+}
+
+// write s as a JSON string
+void write_string(std::ofstream& ofs, const char* s)
+{
+    ofs << '"';
+    for (; *s; ++s)
+    {
+        if (*s == '"' || *s == '\\')
+            ofs << '\\';
+        ofs << *s;
+    }
+    ofs << '"';
+}
+
+} // namespace
+
+Tracer& Tracer::instance()
+{
+    static Tracer tracer;
+    return tracer;
+}
+
+Tracer::Tracer() : start_(Clock::now()) {}
+
+double Tracer::now() const
+{
+    using Microseconds = std::chrono::duration<double, std::micro>;
+    return Microseconds(Clock::now() - start_).count();
+}
+
+void Tracer::clear()
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    events_.clear();
+    counters_.clear();
+    start_ = Clock::now();
+}
+
+void Tracer::begin(const char* name)
+{
+    const auto thread = thread_index();
+    std::lock_guard<std::mutex> lock(mutex_);
+    events_.push_back({'B', name, now(), thread, 0, 0});
+}
+
+void Tracer::end(const char* name)
+{
+    // query memory outside of the lock, reading it may take a while
+    const auto thread = thread_index();
+    const auto peak = int64_t(MemoryUsage::max_size());
+    const auto current = int64_t(MemoryUsage::current_size());
+    std::lock_guard<std::mutex> lock(mutex_);
+    events_.push_back({'E', name, now(), thread, peak, current});
+}
+
+void Tracer::count(const char* name, int64_t delta)
+{
+    const auto thread = thread_index();
+    std::lock_guard<std::mutex> lock(mutex_);
+    const auto total = counters_[name] += delta;
+    events_.push_back({'C', name, now(), thread, total, 0});
+}
+
+int64_t Tracer::counter(const std::string& name) const
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = counters_.find(name);
+    return it == counters_.end() ? 0 : it->second;
+}
+
+std::vector<Tracer::Event> Tracer::events() const
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    return events_;
+}
+
+void Tracer::write(const std::filesystem::path& file) const
+{
+    std::ofstream ofs(file);
+    if (!ofs)
+        throw IOException("Failed to open file: " + file.string());
+
+    const auto events = this->events();
+    ofs << std::fixed << std::setprecision(3);
+    ofs << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+    for (size_t i = 0; i < events.size(); ++i)
+    {
+        const auto& e = events[i];
+        ofs << (i ? ",\n" : "\n") << "{\"name\":";
+        write_string(ofs, e.name);
+        ofs << ",\"ph\":\"" << e.phase << "\",\"ts\":" << e.timestamp
+            << ",\"pid\":0,\"tid\":" << e.thread;
+        if (e.phase == 'C')
+        {
+            ofs << ",\"args\":{";
+            write_string(ofs, e.name);
+            ofs << ":" << e.value << "}";
+        }
+        else if (e.phase == 'E')
+        {
+            ofs << ",\"args\":{\"peak_memory\":" << e.value
+                << ",\"memory\":" << e.memory << "}";
+        }
+        ofs << "}";
+    }
+    ofs << "\n]}\n";
+
+    if (!ofs)
+        throw IOException("Failed to write file: " + file.string());
+}
+
+} // namespace pmp
@@ -0,0 +1,155 @@
+// Copyright 2023 the Polygon Mesh Processing Library developers.
+// Distributed under a MIT-style license, see LICENSE.txt for details.
+
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <filesystem>
+#include <map>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace pmp {
+
+//! \brief Records nested timed regions, counters, and memory usage of
+//! algorithms.
+//! \details Algorithms are instrumented by the macros PMP_TRACE_SCOPE() and
+//! PMP_TRACE_COUNT(), which compile to nothing unless the library is built
+//! with \c PMP_ENABLE_TRACING, see the CMake option of the same name. Even
+//! then, nothing is recorded until the tracer is enabled. The recorded
+//! events are written in the Chrome trace event format, which can be viewed
+//! in Perfetto or \c chrome://tracing.
+//!
+//! \code
+//! Tracer::instance().enable();
+//! uniform_remeshing(mesh, edge_length);
+//! Tracer::instance().write("remeshing.json");
+//! \endcode
+//! \note Event names are not copied and need to outlive the tracer, e.g.,
+//! string literals.
+//! \ingroup core
+class Tracer
+{
+public:
+    //! A recorded event.
+    struct Event
+    {
+        char phase;        //!< 'B' begin, 'E' end of a region, 'C' counter
+        const char* name;  //!< name of the region or counter
+        double timestamp;  //!< microseconds since clear()
+        uint32_t thread;   //!< index of the recording thread
+        int64_t value;     //!< counter total or peak memory in bytes
+        int64_t memory;    //!< current memory in bytes at the end of a region
+    };
+
+    //! \return the global tracer.
+    static Tracer& instance();
+
+    //! Start or stop recording.
+    void enable(bool enabled = true)
+    {
+        enabled_.store(enabled, std::memory_order_relaxed);
+    }
+
+    //! \return whether events are recorded.
+    bool is_enabled() const
+    {
+        return enabled_.load(std::memory_order_relaxed);
+    }
+
+    //! Remove all events and counters and restart the clock.
+    void clear();
+
+    //! Begin a region named \p name on the calling thread.
+    void begin(const char* name);
+
+    //! \brief End the innermost region named \p name on the calling thread.
+    //! \details Records the current and peak memory usage, see MemoryUsage.
+    void end(const char* name);
+
+    //! Add \p delta to the counter \p name and record its new total.
+    void count(const char* name, int64_t delta);
+
+    //! \return the total of counter \p name.
+    int64_t counter(const std::string& name) const;
+
+    //! \return a copy of the recorded events.
+    std::vector<Event> events() const;
+
+    //! \brief Write the recorded events as Chrome trace JSON.
+    //! \throw IOException in case of failure to write the file.
+    void write(const std::filesystem::path& file) const;
+
+private:
+    Tracer();
+
+    double now() const;
+
+    using Clock = std::chrono::steady_clock;
+
+    std::atomic<bool> enabled_{false};
+    mutable std::mutex mutex_;
+    Clock::time_point start_;
+    std::vector<Event> events_;
+    std::map<std::string, int64_t> counters_;
+};
+
+//! \brief Records a region of the global Tracer from construction to
+//! destruction.
+//! \sa PMP_TRACE_SCOPE
+//! \ingroup core
+class TraceScope
+{
+public:
+    //! Begin region \p name if the tracer is enabled.
+    explicit TraceScope(const char* name)
+        : name_(Tracer::instance().is_enabled() ? name : nullptr)
+    {
+        if (name_)
+            Tracer::instance().begin(name_);
+    }
+
+    //! End the region.
+    ~TraceScope()
+    {
+        if (name_)
+            Tracer::instance().end(name_);
+    }
+
+    TraceScope(const TraceScope&) = delete;
+    TraceScope& operator=(const TraceScope&) = delete;
+
+private:
+    const char* name_;
+};
+
+} // namespace pmp
+
+#define PMP_TRACE_CONCAT_(a, b) a##b
+#define PMP_TRACE_CONCAT(a, b) PMP_TRACE_CONCAT_(a, b)
+
+#ifdef PMP_ENABLE_TRACING
+
+//! \brief Trace the enclosing scope as region \p name.
+//! \ingroup core
+#define PMP_TRACE_SCOPE(name)                                                  \
+    pmp::TraceScope PMP_TRACE_CONCAT(pmp_trace_scope_, __LINE__)(name)
+
+//! \brief Add \p delta to the trace counter \p name.
+//! \ingroup core
+#define PMP_TRACE_COUNT(name, delta)                                           \
+    do                                                                         \
+    {                                                                          \
+        if (pmp::Tracer::instance().is_enabled())                              \
+            pmp::Tracer::instance().count(name, int64_t(delta));               \
+    } while (false)
+
+#else
+
+#define PMP_TRACE_SCOPE(name) static_cast<void>(0)
+#define PMP_TRACE_COUNT(name, delta) static_cast<void>(delta)
+
+#endif
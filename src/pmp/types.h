@@ -55,6 +55,7 @@ using IndexType = std::uint_least32_t;
 //!   * BoundingBox: \copybrief BoundingBox
 //!   * StopWatch: \copybrief StopWatch
 //!   * MemoryUsage: \copybrief MemoryUsage
+//!   * Tracer: \copybrief Tracer
 
 //! \defgroup algorithms algorithms
 //! \brief Mesh processing algorithms.
@@ -6,6 +6,7 @@
 
 #include <iostream>
 #include <limits>
+#include <utility>
 
 #include <imgui.h>
 
@@ -35,6 +36,15 @@ MeshViewer::MeshViewer(const char* title, int width, int height, bool showgui)
 
 void MeshViewer::load_mesh(const char* filename)
 {
+    // discard the result of a running job
+    if (jobs_.is_busy())
+    {
+        jobs_.cancel();
+        jobs_.wait();
+        SurfaceMesh discarded;
+        jobs_.collect(discarded);
+    }
+
     // load mesh
     try
     {
@@ -133,8 +143,44 @@ void MeshViewer::update_mesh()
     renderer_.update_opengl_buffers();
 }
 
+bool MeshViewer::run_job(const std::string& name, JobRunner::Job job)
+{
+    return jobs_.start(name, mesh_, std::move(job));
+}
+
+void MeshViewer::do_processing()
+{
+    if (!jobs_.is_busy() || !jobs_.is_finished())
+        return;
+
+    if (jobs_.collect(mesh_))
+        update_mesh();
+    else
+        std::cerr << jobs_.name() << ": " << jobs_.error() << std::endl;
+}
+
+bool MeshViewer::check_idle() const
+{
+    if (!jobs_.is_busy())
+        return true;
+
+    std::cerr << jobs_.name() << " is running, cancel it or wait until it "
+              << "has finished.\n";
+    return false;
+}
+
 void MeshViewer::process_imgui()
 {
+    if (jobs_.is_busy())
+    {
+        ImGui::Text("%s", jobs_.name().c_str());
+        ImGui::ProgressBar(jobs_.progress(), ImVec2(100, 0));
+        ImGui::SameLine();
+        if (ImGui::Button("Cancel"))
+            jobs_.cancel();
+        ImGui::Spacing();
+    }
+
     if (ImGui::CollapsingHeader("Mesh Info", ImGuiTreeNodeFlags_DefaultOpen))
     {
         // output mesh statistics
@@ -4,6 +4,7 @@
 #pragma once
 
 #include "pmp/visualization/trackball_viewer.h"
+#include "pmp/job_runner.h"
 #include "pmp/surface_mesh.h"
 #include "pmp/visualization/renderer.h"
 
@@ -43,6 +44,22 @@ public:
     //! handle ImGUI interface
     void process_imgui() override;
 
+    //! \brief run \p job in the background on a copy of the mesh
+    //! \details The GUI shows its progress and allows to cancel it. Once the
+    //! job has finished, its result replaces the mesh and update_mesh() is
+    //! called.
+    //! \return \c false if another job is still running
+    bool run_job(const std::string& name, JobRunner::Job job);
+
+    //! collect the result of a finished background job
+    void do_processing() override;
+
+    //! \brief check whether the mesh may be modified directly
+    //! \details Edits made while a background job is running would be
+    //! overwritten once its result is collected. In that case a message is
+    //! printed and \c false is returned.
+    bool check_idle() const;
+
     //! this function handles keyboard events
     void keyboard(int key, int code, int action, int mod) override;
 
@@ -57,6 +74,7 @@ protected:
     Renderer renderer_;
     std::string filename_; //!< the current file
     float crease_angle_;
+    JobRunner jobs_; //!< runs background jobs, see run_job()
 };
 
 } // namespace pmp
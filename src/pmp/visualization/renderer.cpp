@@ -5,11 +5,14 @@
 
 #include <stb_image.h>
 
+#include <type_traits>
+#include <utility>
+
 #include "pmp/exceptions.h"
 #include "pmp/visualization/phong_shader.h"
 #include "pmp/visualization/mat_cap_shader.h"
 #include "pmp/visualization/cold_warm_texture.h"
-#include "pmp/algorithms/normals.h"
+#include "pmp/algorithms/render_buffers.h"
 
 namespace pmp {
 
@@ -21,6 +24,7 @@ Renderer::Renderer(const SurfaceMesh& mesh) : mesh_(mesh)
     color_buffer_ = 0;
     normal_buffer_ = 0;
     tex_coord_buffer_ = 0;
+    triangle_buffer_ = 0;
     edge_buffer_ = 0;
     feature_buffer_ = 0;
 
@@ -57,6 +61,7 @@ Renderer::~Renderer()
     glDeleteBuffers(1, &color_buffer_);
     glDeleteBuffers(1, &normal_buffer_);
     glDeleteBuffers(1, &tex_coord_buffer_);
+    glDeleteBuffers(1, &triangle_buffer_);
     glDeleteBuffers(1, &edge_buffer_);
     glDeleteBuffers(1, &feature_buffer_);
     glDeleteVertexArrays(1, &vertex_array_object_);
@@ -245,6 +250,7 @@ void Renderer::update_opengl_buffers()
         glGenBuffers(1, &color_buffer_);
         glGenBuffers(1, &normal_buffer_);
         glGenBuffers(1, &tex_coord_buffer_);
+        glGenBuffers(1, &triangle_buffer_);
         glGenBuffers(1, &edge_buffer_);
         glGenBuffers(1, &feature_buffer_);
     }
@@ -252,188 +258,13 @@ void Renderer::update_opengl_buffers()
     // activate VAO
     glBindVertexArray(vertex_array_object_);
 
-    // get properties
-    auto vpos = mesh_.get_vertex_property<Point>("v:point");
-    auto vcolor = mesh_.get_vertex_property<Color>("v:color");
-    auto vtex = mesh_.get_vertex_property<TexCoord>("v:tex");
-    auto htex = mesh_.get_halfedge_property<TexCoord>("h:tex");
-    auto fcolor = mesh_.get_face_property<Color>("f:color");
-
-    // index array for remapping vertex indices during duplication
-    // note: use vertices_size() instead of n_vertices() to also
-    // take deleted vertices into account
-    std::vector<size_t> vertex_indices(mesh_.vertices_size());
-
-    // produce arrays of points, normals, and texcoords
-    // (duplicate vertices to allow for flat shading)
-    std::vector<vec3> position_array;
-    std::vector<vec3> color_array;
-    std::vector<vec3> normal_array;
-    std::vector<vec2> tex_array;
-    std::vector<ivec3> triangles;
-
-    // we have a mesh: fill arrays by looping over faces
-    if (mesh_.n_faces())
-    {
-        // reserve memory
-        position_array.reserve(3 * mesh_.n_faces());
-        normal_array.reserve(3 * mesh_.n_faces());
-        if (htex || vtex)
-            tex_array.reserve(3 * mesh_.n_faces());
-
-        if ((vcolor || fcolor) && use_colors_)
-            color_array.reserve(3 * mesh_.n_faces());
-
-        // precompute normals for easy cases
-        std::vector<Normal> face_normals;
-        std::vector<Normal> vertex_normals;
-        if (crease_angle_ < 1)
-        {
-            // note: use faces_size() instead of n_faces() to
-            // take deleted faces into account
-            face_normals.resize(mesh_.faces_size());
-            for (auto f : mesh_.faces())
-                face_normals[f.idx()] = face_normal(mesh_, f);
-        }
-        else if (crease_angle_ > 170)
-        {
-            // note: use vertices_size() instead of n_vertices() to
-            // take deleted vertices into account
-            vertex_normals.resize(mesh_.vertices_size());
-            for (auto v : mesh_.vertices())
-                vertex_normals[v.idx()] = vertex_normal(mesh_, v);
-        }
-
-        // data per face (for all corners)
-        std::vector<Halfedge> corner_halfedges;
-        std::vector<Vertex> corner_vertices;
-        std::vector<vec3> corner_positions;
-        std::vector<vec3> corner_colors;
-        std::vector<vec3> corner_normals;
-        std::vector<vec2> corner_texcoords;
-
-        // convert from degrees to radians
-        const Scalar crease_angle_radians = crease_angle_ / 180.0 * M_PI;
-
-        size_t vidx(0);
-
-        // loop over all faces
-        for (auto f : mesh_.faces())
-        {
-            // collect corner positions and normals
-            corner_halfedges.clear();
-            corner_vertices.clear();
-            corner_positions.clear();
-            corner_colors.clear();
-            corner_normals.clear();
-            corner_texcoords.clear();
-            Vertex v;
-            Normal n;
-
-            for (auto h : mesh_.halfedges(f))
-            {
-                v = mesh_.to_vertex(h);
-                corner_halfedges.push_back(h);
-                corner_vertices.push_back(v);
-                corner_positions.push_back((vec3)vpos[v]);
-
-                if (crease_angle_ < 1)
-                {
-                    n = face_normals[f.idx()];
-                }
-                else if (crease_angle_ > 170)
-                {
-                    n = vertex_normals[v.idx()];
-                }
-                else
-                {
-                    n = corner_normal(mesh_, h, crease_angle_radians);
-                }
-                corner_normals.push_back((vec3)n);
-
-                if (htex)
-                {
-                    corner_texcoords.push_back((vec2)htex[h]);
-                }
-                else if (vtex)
-                {
-                    corner_texcoords.push_back((vec2)vtex[v]);
-                }
-
-                if (vcolor && use_colors_)
-                {
-                    corner_colors.push_back((vec3)vcolor[v]);
-                }
-                else if (fcolor && use_colors_)
-                {
-                    corner_colors.push_back((vec3)fcolor[f]);
-                }
-            }
-            assert(corner_vertices.size() >= 3);
-
-            // tessellate face into triangles
-            tesselate(corner_positions, triangles);
-            for (auto& t : triangles)
-            {
-                int i0 = t[0];
-                int i1 = t[1];
-                int i2 = t[2];
-
-                position_array.push_back(corner_positions[i0]);
-                position_array.push_back(corner_positions[i1]);
-                position_array.push_back(corner_positions[i2]);
-
-                normal_array.push_back(corner_normals[i0]);
-                normal_array.push_back(corner_normals[i1]);
-                normal_array.push_back(corner_normals[i2]);
-
-                if (htex || vtex)
-                {
-                    tex_array.push_back(corner_texcoords[i0]);
-                    tex_array.push_back(corner_texcoords[i1]);
-                    tex_array.push_back(corner_texcoords[i2]);
-                }
-
-                if ((vcolor || fcolor) && use_colors_)
-                {
-                    color_array.push_back(corner_colors[i0]);
-                    color_array.push_back(corner_colors[i1]);
-                    color_array.push_back(corner_colors[i2]);
-                }
-
-                vertex_indices[corner_vertices[i0].idx()] = vidx++;
-                vertex_indices[corner_vertices[i1].idx()] = vidx++;
-                vertex_indices[corner_vertices[i2].idx()] = vidx++;
-            }
-        }
-    }
-
-    // we have a point cloud
-    else if (mesh_.n_vertices())
-    {
-        auto position = mesh_.get_vertex_property<Point>("v:point");
-        if (position)
-        {
-            position_array.reserve(mesh_.n_vertices());
-            for (auto v : mesh_.vertices())
-                position_array.push_back((vec3)position[v]);
-        }
-
-        auto normals = mesh_.get_vertex_property<Point>("v:normal");
-        if (normals)
-        {
-            normal_array.reserve(mesh_.n_vertices());
-            for (auto v : mesh_.vertices())
-                normal_array.push_back((vec3)normals[v]);
-        }
-
-        if (vcolor && use_colors_)
-        {
-            color_array.reserve(mesh_.n_vertices());
-            for (auto v : mesh_.vertices())
-                color_array.push_back((vec3)vcolor[v]);
-        }
-    }
+    // indexed arrays of unique corners
+    buffers_ = render_buffers(mesh_, crease_angle_, use_colors_);
+    const auto& buffers = buffers_;
+    const auto& position_array = buffers.positions;
+    const auto& normal_array = buffers.normals;
+    const auto& tex_array = buffers.texcoords;
+    const auto& color_array = buffers.colors;
 
     // upload vertices
     if (!position_array.empty())
@@ -497,57 +328,85 @@ void Renderer::update_opengl_buffers()
         has_vertex_colors_ = false;
     }
 
+    // triangle indices
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, triangle_buffer_);
+    glBufferData(GL_ELEMENT_ARRAY_BUFFER,
+                 buffers.triangles.size() * sizeof(unsigned int),
+                 buffers.triangles.data(), GL_STATIC_DRAW);
+    n_triangles_ = buffers.triangles.size() / 3;
+
     // edge indices
-    if (mesh_.n_edges())
-    {
-        std::vector<unsigned int> edge_indices;
-        edge_indices.reserve(mesh_.n_edges());
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, edge_buffer_);
+    glBufferData(GL_ELEMENT_ARRAY_BUFFER,
+                 buffers.edges.size() * sizeof(unsigned int),
+                 buffers.edges.data(), GL_STATIC_DRAW);
+    n_edges_ = buffers.edges.size();
 
-        for (auto e : mesh_.edges())
-        {
-            auto v0 = mesh_.vertex(e, 0).idx();
-            auto v1 = mesh_.vertex(e, 1).idx();
-            edge_indices.push_back(vertex_indices[v0]);
-            edge_indices.push_back(vertex_indices[v1]);
-        }
+    // feature edges
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, feature_buffer_);
+    glBufferData(GL_ELEMENT_ARRAY_BUFFER,
+                 buffers.features.size() * sizeof(unsigned int),
+                 buffers.features.data(), GL_STATIC_DRAW);
+    n_features_ = buffers.features.size();
 
-        glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, edge_buffer_);
-        glBufferData(GL_ELEMENT_ARRAY_BUFFER,
-                     edge_indices.size() * sizeof(unsigned int),
-                     edge_indices.data(), GL_STATIC_DRAW);
-        n_edges_ = edge_indices.size();
-    }
-    else
-        n_edges_ = 0;
+    // unbind vertex array
+    glBindVertexArray(0);
+}
 
-    // feature edges
-    auto efeature = mesh_.get_edge_property<bool>("e:feature");
-    if (efeature)
+void Renderer::update_opengl_buffers(const std::vector<Vertex>& vertices)
+{
+    std::vector<unsigned int> updated;
+    if (!vertex_array_object_ ||
+        !update_render_buffers(mesh_, buffers_, vertices, updated))
     {
-        std::vector<unsigned int> features;
-
-        for (auto e : mesh_.edges())
-        {
-            if (efeature[e])
-            {
-                auto v0 = mesh_.vertex(e, 0).idx();
-                auto v1 = mesh_.vertex(e, 1).idx();
-                features.push_back(vertex_indices[v0]);
-                features.push_back(vertex_indices[v1]);
-            }
-        }
+        update_opengl_buffers();
+        return;
+    }
+    upload_updated(updated);
+}
 
-        glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, feature_buffer_);
-        glBufferData(GL_ELEMENT_ARRAY_BUFFER,
-                     features.size() * sizeof(unsigned int), features.data(),
-                     GL_STATIC_DRAW);
-        n_features_ = features.size();
+void Renderer::update_opengl_buffers(const std::vector<Face>& faces)
+{
+    std::vector<unsigned int> updated;
+    if (!vertex_array_object_ ||
+        !update_render_buffers(mesh_, buffers_, faces, updated))
+    {
+        update_opengl_buffers();
+        return;
     }
-    else
-        n_features_ = 0;
+    upload_updated(updated);
+}
 
-    // unbind vertex array
-    glBindVertexArray(0);
+void Renderer::upload_updated(const std::vector<unsigned int>& updated)
+{
+    // merge the sorted indices into ranges, accepting small gaps to save
+    // calls to glBufferSubData
+    constexpr unsigned int max_gap = 16;
+    std::vector<std::pair<unsigned int, unsigned int>> ranges;
+    for (auto i : updated)
+    {
+        if (!ranges.empty() && i <= ranges.back().second + max_gap)
+            ranges.back().second = i;
+        else
+            ranges.emplace_back(i, i);
+    }
+
+    const auto upload = [&ranges](GLuint buffer, const auto& array) {
+        if (array.empty())
+            return;
+        using Element = typename std::decay_t<decltype(array)>::value_type;
+        glBindBuffer(GL_ARRAY_BUFFER, buffer);
+        for (const auto& [first, last] : ranges)
+            glBufferSubData(GL_ARRAY_BUFFER, first * sizeof(Element),
+                            (last - first + 1) * sizeof(Element),
+                            &array[first]);
+    };
+
+    upload(vertex_buffer_, buffers_.positions);
+    upload(normal_buffer_, buffers_.normals);
+    upload(tex_coord_buffer_, buffers_.texcoords);
+    upload(color_buffer_, buffers_.colors);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
 }
 
 void Renderer::draw(const mat4& projection_matrix, const mat4& modelview_matrix,
@@ -643,7 +502,7 @@ void Renderer::draw(const mat4& projection_matrix, const mat4& modelview_matrix,
         {
             // draw faces
             glDepthRange(0.01, 1.0);
-            glDrawArrays(GL_TRIANGLES, 0, n_vertices_);
+            draw_triangles();
             glDisable(GL_SAMPLE_ALPHA_TO_COVERAGE);
 
             // overlay edges
@@ -663,7 +522,7 @@ void Renderer::draw(const mat4& projection_matrix, const mat4& modelview_matrix,
     {
         if (mesh_.n_faces())
         {
-            glDrawArrays(GL_TRIANGLES, 0, n_vertices_);
+            draw_triangles();
         }
     }
 
@@ -679,7 +538,7 @@ void Renderer::draw(const mat4& projection_matrix, const mat4& modelview_matrix,
                 matcap_shader_.set_uniform("normal_matrix", n_matrix);
                 matcap_shader_.set_uniform("alpha", alpha_);
                 glBindTexture(GL_TEXTURE_2D, texture_);
-                glDrawArrays(GL_TRIANGLES, 0, n_vertices_);
+                draw_triangles();
             }
             else
             {
@@ -689,7 +548,7 @@ void Renderer::draw(const mat4& projection_matrix, const mat4& modelview_matrix,
                 phong_shader_.set_uniform("use_vertex_color", false);
                 phong_shader_.set_uniform("use_srgb", use_srgb_);
                 glBindTexture(GL_TEXTURE_2D, texture_);
-                glDrawArrays(GL_TRIANGLES, 0, n_vertices_);
+                draw_triangles();
             }
         }
     }
@@ -706,7 +565,7 @@ void Renderer::draw(const mat4& projection_matrix, const mat4& modelview_matrix,
             phong_shader_.set_uniform("front_color", vec3(0.8, 0.8, 0.8));
             phong_shader_.set_uniform("back_color", vec3(0.9, 0.0, 0.0));
             glDepthRange(0.01, 1.0);
-            glDrawArrays(GL_TRIANGLES, 0, n_vertices_);
+            draw_triangles();
 
             // overlay edges
             glDepthRange(0.0, 1.0);
@@ -741,99 +600,10 @@ void Renderer::draw(const mat4& projection_matrix, const mat4& modelview_matrix,
     glCheckError();
 }
 
-void Renderer::tesselate(const std::vector<vec3>& points,
-                         std::vector<ivec3>& triangles)
+void Renderer::draw_triangles()
 {
-    const int n = points.size();
-
-    triangles.clear();
-    triangles.reserve(n - 2);
-
-    // triangle? nothing to do
-    if (n == 3)
-    {
-        triangles.emplace_back(0, 1, 2);
-        return;
-    }
-
-    // quad? simply compare to two options
-    else if (n == 4)
-    {
-        if (area(points[0], points[1], points[2]) +
-                area(points[0], points[2], points[3]) <
-            area(points[0], points[1], points[3]) +
-                area(points[1], points[2], points[3]))
-        {
-            triangles.emplace_back(0, 1, 2);
-            triangles.emplace_back(0, 2, 3);
-        }
-        else
-        {
-            triangles.emplace_back(0, 1, 3);
-            triangles.emplace_back(1, 2, 3);
-        }
-        return;
-    }
-
-    // n-gon with n>4? compute triangulation by dynamic programming
-    init_triangulation(n);
-    int i, j, m, k, imin;
-    Scalar w, wmin;
-
-    // initialize 2-gons
-    for (i = 0; i < n - 1; ++i)
-    {
-        triangulation(i, i + 1) = Triangulation(0.0, -1);
-    }
-
-    // n-gons with n>2
-    for (j = 2; j < n; ++j)
-    {
-        // for all n-gons [i,i+j]
-        for (i = 0; i < n - j; ++i)
-        {
-            k = i + j;
-
-            wmin = std::numeric_limits<Scalar>::max();
-            imin = -1;
-
-            // find best split i < m < i+j
-            for (m = i + 1; m < k; ++m)
-            {
-                w = triangulation(i, m).area +
-                    area(points[i], points[m], points[k]) +
-                    triangulation(m, k).area;
-
-                if (w < wmin)
-                {
-                    wmin = w;
-                    imin = m;
-                }
-            }
-
-            triangulation(i, k) = Triangulation(wmin, imin);
-        }
-    }
-
-    // build triangles from triangulation table
-    std::vector<ivec2> todo;
-    todo.reserve(n);
-    todo.emplace_back(0, n - 1);
-    while (!todo.empty())
-    {
-        ivec2 tri = todo.back();
-        todo.pop_back();
-        int start = tri[0];
-        int end = tri[1];
-        if (end - start < 2)
-            continue;
-        int split = triangulation(start, end).split;
-
-        triangles.emplace_back(start, split, end);
-
-        todo.emplace_back(start, split);
-        todo.emplace_back(split, end);
-    }
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, triangle_buffer_);
+    glDrawElements(GL_TRIANGLES, 3 * n_triangles_, GL_UNSIGNED_INT, nullptr);
 }
 
 } // namespace pmp
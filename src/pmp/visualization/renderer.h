@@ -3,17 +3,16 @@
 
 #pragma once
 
-#include <limits>
+#include <vector>
 
 #include "pmp/types.h"
+#include "pmp/algorithms/render_buffers.h"
 #include "pmp/visualization/gl.h"
 #include "pmp/visualization/shader.h"
 #include "pmp/mat_vec.h"
 
 namespace pmp {
 
-class SurfaceMesh;
-
 //! Class for rendering surface meshes using OpenGL
 //! \ingroup visualization
 class Renderer
@@ -83,9 +82,22 @@ public:
     void draw(const mat4& projection_matrix, const mat4& modelview_matrix,
               const std::string& draw_mode);
 
-    //! Update all OpenGL buffers for rendering.
+    //! \brief Update all OpenGL buffers for rendering.
+    //! \details Uploads the indexed buffers computed by render_buffers().
     void update_opengl_buffers();
 
+    //! \brief Update the OpenGL buffers after moving \p vertices.
+    //! \details Only uploads the buffer vertices changed by
+    //! update_render_buffers(). Falls back to a full update if the buffers
+    //! cannot be updated in place.
+    void update_opengl_buffers(const std::vector<Vertex>& vertices);
+
+    //! \brief Update the OpenGL buffers after changing attributes of
+    //! \p faces, e.g., their colors.
+    //! \details Falls back to a full update if the buffers cannot be updated
+    //! in place.
+    void update_opengl_buffers(const std::vector<Face>& faces);
+
     //! Use color map to visualize scalar fields.
     void use_cold_warm_texture();
 
@@ -113,49 +125,16 @@ public:
     void load_matcap(const char* filename);
 
 protected:
-    const SurfaceMesh& mesh_;
-
-    // helpers for computing triangulation of a polygon
-    struct Triangulation
-    {
-        Triangulation(Scalar a = std::numeric_limits<Scalar>::max(), int s = -1)
-            : area(a), split(s)
-        {
-        }
-        Scalar area;
-        int split;
-    };
-
-    // table to hold triangulation data
-    std::vector<Triangulation> triangulation_;
-
-    // valence of currently triangulated polygon
-    unsigned int polygon_valence_;
-
-    // reserve n*n array for computing triangulation
-    void init_triangulation(unsigned int n)
-    {
-        triangulation_.clear();
-        triangulation_.resize(n * n);
-        polygon_valence_ = n;
-    }
+    // draw the triangles of the index buffer
+    void draw_triangles();
 
-    // access triangulation array
-    Triangulation& triangulation(int start, int end)
-    {
-        return triangulation_[polygon_valence_ * start + end];
-    }
+    // upload the given buffer vertices of buffers_
+    void upload_updated(const std::vector<unsigned int>& updated);
 
-    // compute squared area of triangle. used for triangulate().
-    inline Scalar area(const vec3& p0, const vec3& p1, const vec3& p2) const
-    {
-        return sqrnorm(cross(p1 - p0, p2 - p0));
-    }
+    const SurfaceMesh& mesh_;
 
-    // triangulate a polygon such that the sum of squared triangle areas is minimized.
-    // this prevents overlapping/folding triangles for non-convex polygons.
-    void tesselate(const std::vector<vec3>& points,
-                   std::vector<ivec3>& triangles);
+    // indexed buffers of the last update, kept for partial updates
+    RenderBuffers buffers_;
 
     // OpenGL buffers
     GLuint vertex_array_object_;
@@ -163,6 +142,7 @@ protected:
     GLuint color_buffer_;
     GLuint normal_buffer_;
     GLuint tex_coord_buffer_;
+    GLuint triangle_buffer_;
     GLuint edge_buffer_;
     GLuint feature_buffer_;
 
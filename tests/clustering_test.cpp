@@ -0,0 +1,68 @@
+// Copyright 2023 the Polygon Mesh Processing Library developers.
+// Distributed under a MIT-style license, see LICENSE.txt for details.
+
+#include "gtest/gtest.h"
+
+#include "pmp/algorithms/clustering.h"
+#include "pmp/algorithms/shapes.h"
+
+using namespace pmp;
+
+TEST(ClusteringTest, vertex_clustering)
+{
+    auto mesh = icosphere(5);
+    const auto nv = mesh.n_vertices();
+    vertex_clustering(mesh, 16);
+
+    EXPECT_LT(mesh.n_vertices(), nv / 5);
+    EXPECT_GT(mesh.n_vertices(), size_t(100));
+    EXPECT_EQ(mesh.n_vertices(), mesh.vertices_size());
+
+    // representatives stay close to the sphere
+    const Scalar cell_size = 2.0 / 16;
+    for (auto v : mesh.vertices())
+        EXPECT_NEAR(norm(mesh.position(v)), 1.0, 0.5 * cell_size);
+}
+
+TEST(ClusteringTest, fine_grid_keeps_mesh)
+{
+    auto mesh = icosphere(2);
+    const auto nv = mesh.n_vertices();
+    const auto nf = mesh.n_faces();
+    vertex_clustering(mesh, 1000);
+    EXPECT_EQ(mesh.n_vertices(), nv);
+    EXPECT_EQ(mesh.n_faces(), nf);
+}
+
+TEST(ClusteringTest, triangle_soup)
+{
+    auto mesh = icosphere(4);
+    auto soup = vertex_clustering_soup(mesh, 8);
+    EXPECT_GT(soup.triangles.size(), size_t(0));
+    for (const auto& t : soup.triangles)
+    {
+        for (auto i : t)
+            EXPECT_LT(i, soup.positions.size());
+        EXPECT_NE(t[0], t[1]);
+        EXPECT_NE(t[1], t[2]);
+        EXPECT_NE(t[2], t[0]);
+    }
+
+    // the soup contains at least the triangles of the manifold result
+    vertex_clustering(mesh, 8);
+    EXPECT_GE(soup.triangles.size(), mesh.n_faces());
+}
+
+TEST(ClusteringTest, quad_mesh)
+{
+    auto mesh = quad_sphere(4);
+    vertex_clustering(mesh, 8);
+    EXPECT_GT(mesh.n_faces(), size_t(0));
+    EXPECT_TRUE(mesh.is_triangle_mesh());
+}
+
+TEST(ClusteringTest, invalid_resolution)
+{
+    auto mesh = icosahedron();
+    EXPECT_THROW(vertex_clustering(mesh, 0), InvalidInputException);
+}
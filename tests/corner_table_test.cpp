@@ -0,0 +1,91 @@
+// Copyright 2023 the Polygon Mesh Processing Library developers.
+// Distributed under a MIT-style license, see LICENSE.txt for details.
+
+#include "gtest/gtest.h"
+
+#include "pmp/corner_table.h"
+#include "pmp/algorithms/shapes.h"
+#include "helpers.h"
+
+using namespace pmp;
+
+// count corners around v by swinging counter-clockwise
+size_t swing_valence(const CornerTable& ct, Vertex v)
+{
+    size_t n = 0;
+    auto c = ct.corner(v);
+    auto start = c;
+    while (c != PMP_MAX_INDEX)
+    {
+        ++n;
+        c = ct.swing(c);
+        if (c == start)
+            break;
+    }
+    return n;
+}
+
+TEST(CornerTableTest, closed_mesh)
+{
+    auto mesh = icosphere(2);
+    CornerTable ct(mesh);
+    EXPECT_EQ(ct.n_corners(), 3 * mesh.n_faces());
+    EXPECT_EQ(ct.n_vertices(), mesh.n_vertices());
+
+    for (IndexType c = 0; c < ct.n_corners(); ++c)
+    {
+        EXPECT_EQ(CornerTable::next(CornerTable::prev(c)), c);
+        EXPECT_EQ(CornerTable::face(CornerTable::next(c)), CornerTable::face(c));
+        EXPECT_FALSE(ct.is_boundary(c));
+        EXPECT_EQ(ct.opposite(ct.opposite(c)), c);
+    }
+
+    for (auto v : mesh.vertices())
+    {
+        EXPECT_EQ(ct.vertex(ct.corner(v)), v);
+        EXPECT_EQ(swing_valence(ct, v), mesh.valence(v));
+    }
+}
+
+TEST(CornerTableTest, mesh_with_boundary)
+{
+    auto mesh = vertex_onering();
+    CornerTable ct(mesh);
+
+    size_t n_boundary = 0;
+    for (IndexType c = 0; c < ct.n_corners(); ++c)
+        if (ct.is_boundary(c))
+            ++n_boundary;
+    EXPECT_EQ(n_boundary, 6u);
+
+    // center vertex is interior, all others are boundary vertices
+    for (auto v : mesh.vertices())
+    {
+        size_t n_faces = 0;
+        for ([[maybe_unused]] auto f : mesh.faces(v))
+            ++n_faces;
+        EXPECT_EQ(swing_valence(ct, v), n_faces);
+    }
+}
+
+TEST(CornerTableTest, matches_halfedge_connectivity)
+{
+    auto mesh = icosphere(1);
+    CornerTable ct(mesh);
+    for (auto f : mesh.faces())
+    {
+        unsigned int i = 0;
+        for (auto v : mesh.vertices(f))
+            EXPECT_EQ(ct.vertex(CornerTable::corner(f, i++)), v);
+    }
+}
+
+TEST(CornerTableTest, invalid_input)
+{
+    auto quads = quad_sphere(1);
+    EXPECT_THROW(CornerTable ct(quads), InvalidInputException);
+
+    auto mesh = icosahedron();
+    mesh.delete_vertex(Vertex(0));
+    EXPECT_THROW(CornerTable ct(mesh), InvalidInputException);
+}
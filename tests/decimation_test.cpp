@@ -4,9 +4,14 @@
 #include "gtest/gtest.h"
 
 #include "pmp/algorithms/decimation.h"
+#include "pmp/algorithms/distance_point_triangle.h"
 #include "pmp/algorithms/features.h"
+#include "pmp/algorithms/normals.h"
+#include "pmp/algorithms/shapes.h"
 #include "helpers.h"
 
+#include <algorithm>
+
 using namespace pmp;
 
 // plain simplification test
@@ -24,6 +29,131 @@ TEST(DecimationTest, simplification)
     EXPECT_NEAR(mesh.n_vertices(), size_t(101), 2);
 }
 
+// maximum distance of the vertices of original to mesh
+Scalar max_distance(const SurfaceMesh& original, const SurfaceMesh& mesh)
+{
+    Scalar dmax = 0;
+    for (auto v : original.vertices())
+    {
+        Scalar dmin = std::numeric_limits<Scalar>::max();
+        for (auto f : mesh.faces())
+        {
+            auto fv = mesh.vertices(f);
+            const auto& p0 = mesh.position(*fv);
+            const auto& p1 = mesh.position(*(++fv));
+            const auto& p2 = mesh.position(*(++fv));
+            Point n;
+            dmin = std::min(dmin, dist_point_triangle(original.position(v),
+                                                      p0, p1, p2, n));
+        }
+        dmax = std::max(dmax, dmin);
+    }
+    return dmax;
+}
+
+// all original vertices stay within the Hausdorff error
+TEST(DecimationTest, hausdorff_error)
+{
+    auto mesh = icosphere(3);
+    auto original = mesh;
+    const Scalar max_error = 0.02;
+    decimate(mesh, 12,
+             0.0,        // aspect ratio
+             0.0,        // edge length
+             0,          // max valence
+             0.0,        // normal deviation
+             max_error); // Hausdorff
+    EXPECT_GT(mesh.n_vertices(), size_t(12));
+    EXPECT_LT(mesh.n_vertices(), original.n_vertices());
+    EXPECT_LT(max_distance(original, mesh), max_error);
+}
+
+// stop at a target number of faces
+TEST(DecimationTest, face_count_target)
+{
+    auto mesh = icosphere(3);
+    decimate(mesh, 0, 0.0, 0.0, 0, 0.0, 0.0, 1e-2, 1, 500);
+    EXPECT_LE(mesh.n_faces(), size_t(500));
+    EXPECT_GE(mesh.n_faces(), size_t(498));
+}
+
+// stop at a maximum quadric error
+TEST(DecimationTest, quadric_error_target)
+{
+    auto mesh = icosphere(3);
+    auto coarse = mesh;
+    decimate(mesh, 0, 0.0, 0.0, 0, 0.0, 0.0, 1e-2, 1, 0, 1e-3);
+    decimate(coarse, 0, 0.0, 0.0, 0, 0.0, 0.0, 1e-2, 1, 0, 1e-1);
+    EXPECT_LT(mesh.n_vertices(), icosphere(3).n_vertices());
+    EXPECT_GT(mesh.n_vertices(), coarse.n_vertices());
+}
+
+// the error budget ignores the attribute part of the quadrics
+TEST(DecimationTest, attribute_quadrics_quadric_error_target)
+{
+    auto mesh = icosphere(3);
+    auto colors = mesh.add_vertex_property<Color>("v:color");
+    for (auto v : mesh.vertices())
+        colors[v] = v.idx() % 2 ? Color(1, 0, 0) : Color(0, 0, 1);
+
+    auto plain = mesh;
+    decimate(plain, 0, 0.0, 0.0, 0, 0.0, 0.0, 1e-2, 1, 0, 1e-3);
+    decimate(mesh, 0, 0.0, 0.0, 0, 0.0, 0.0, 1e-2, 1, 0, 1e-3, true);
+
+    // optimal placement keeps the geometric error lower than plain
+    // decimation, even though the colors are far from smooth
+    EXPECT_LT(mesh.n_vertices(), plain.n_vertices() * 3 / 4);
+}
+
+// optimal placement approximates the original surface better
+TEST(DecimationTest, attribute_quadrics)
+{
+    auto original = icosphere(3);
+    vertex_normals(original);
+    auto colors = original.add_vertex_property<Color>("v:color");
+    for (auto v : original.vertices())
+        colors[v] = Scalar(0.5) * (original.position(v) + Point(1, 1, 1));
+
+    auto plain = original;
+    auto optimal = original;
+    decimate(plain, 100);
+    decimate(optimal, 100, 0.0, 0.0, 0, 0.0, 0.0, 1e-2, 1, 0, 0.0, true);
+    EXPECT_EQ(optimal.n_vertices(), size_t(100));
+    EXPECT_LT(max_distance(original, optimal), max_distance(original, plain));
+
+    auto normals = optimal.get_vertex_property<Normal>("v:normal");
+    colors = optimal.get_vertex_property<Color>("v:color");
+    for (auto v : optimal.vertices())
+    {
+        EXPECT_NEAR(norm(normals[v]), 1.0, 1e-5);
+        for (int i = 0; i < 3; ++i)
+        {
+            EXPECT_GE(colors[v][i], 0.0);
+            EXPECT_LE(colors[v][i], 1.0);
+        }
+    }
+}
+
+// boundary and seam vertices stay in place
+TEST(DecimationTest, attribute_quadrics_texture_mesh)
+{
+    auto mesh = texture_seams_mesh();
+    auto original = mesh;
+    decimate(mesh, 4, 0.0, 0.0, 0, 0.0, 0.0, 1e-2, 1, 0, 0.0, true);
+    EXPECT_LT(mesh.n_vertices(), original.n_vertices());
+    for (auto v : mesh.vertices())
+    {
+        if (mesh.is_boundary(v))
+        {
+            auto is_original = [&](Vertex w) {
+                return original.position(w) == mesh.position(v);
+            };
+            EXPECT_TRUE(std::any_of(original.vertices_begin(),
+                                    original.vertices_end(), is_original));
+        }
+    }
+}
+
 // simplify with feature edge preservation enabled
 TEST(DecimationTest, simplification_with_features)
 {
@@ -85,3 +215,29 @@ TEST(DecimationTest, simplification_texture_mesh)
     EXPECT_EQ(seams[se], 1);
     EXPECT_EQ(seams[se2], 1);
 }
+
+TEST(DecimationTest, progress)
+{
+    auto mesh = icosphere(3);
+    Progress progress;
+    decimate(mesh, mesh.n_vertices() / 4, 0.0, 0.0, 0, 0.0, 0.0, 1e-2, 1, 0,
+             0.0, false, &progress);
+    EXPECT_GT(progress.fraction(), 0.9f);
+}
+
+TEST(DecimationTest, cancel)
+{
+    auto mesh = icosphere(3);
+    const auto n_vertices = mesh.n_vertices();
+    Progress progress;
+    progress.cancel();
+    EXPECT_THROW(decimate(mesh, n_vertices / 4, 0.0, 0.0, 0, 0.0, 0.0, 1e-2,
+                          1, 0, 0.0, false, &progress),
+                 CanceledException);
+
+    // the mesh is left valid without temporary properties
+    EXPECT_EQ(mesh.n_vertices(), n_vertices);
+    EXPECT_EQ(mesh.vertices_size(), n_vertices);
+    EXPECT_FALSE(mesh.has_vertex_property("v:prio"));
+    EXPECT_FALSE(mesh.has_vertex_property("v:quadric"));
+}
@@ -87,3 +87,18 @@ TEST(GeodesicsTest, geodesic_maxnum)
         EXPECT_TRUE(distance[neighbors[i]] <= distance[neighbors[i + 1]]);
     }
 }
+
+TEST(GeodesicsTest, cancel)
+{
+    SurfaceMesh mesh = icosphere(3);
+    Progress progress;
+    progress.cancel();
+    EXPECT_THROW(geodesics(mesh, std::vector<Vertex>{Vertex(0)},
+                           std::numeric_limits<Scalar>::max(),
+                           std::numeric_limits<unsigned int>::max(), nullptr,
+                           &progress),
+                 CanceledException);
+    EXPECT_FALSE(mesh.has_vertex_property("geodesic:processed"));
+    EXPECT_THROW(geodesics_heat(mesh, {Vertex(0)}, &progress),
+                 CanceledException);
+}
@@ -34,3 +34,18 @@ TEST(HoleFillingTest, open_cone)
     h = find_boundary(mesh);
     EXPECT_FALSE(h.is_valid());
 }
+
+TEST(HoleFillingTest, cancel)
+{
+    auto mesh = open_cone();
+    const auto n_faces = mesh.n_faces();
+    Progress progress;
+    progress.cancel();
+    EXPECT_THROW(fill_hole(mesh, find_boundary(mesh), &progress),
+                 CanceledException);
+
+    // canceled during the triangulation, the hole is left open
+    EXPECT_EQ(mesh.n_faces(), n_faces);
+    EXPECT_FALSE(mesh.has_vertex_property("HoleFilling:vlocked"));
+    EXPECT_FALSE(mesh.has_edge_property("HoleFilling:elocked"));
+}
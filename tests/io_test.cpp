@@ -5,6 +5,7 @@
 #include "surface_mesh_test.h"
 
 #include <pmp/algorithms/normals.h>
+#include <pmp/algorithms/shapes.h>
 #include <pmp/io/io.h>
 
 using namespace pmp;
@@ -130,4 +131,362 @@ TEST_F(IOTest, write_stl_no_triangles)
     // try to write non-triangle mesh
     add_quad();
     ASSERT_THROW(write(mesh, "test.stl"), InvalidInputException);
-}
\ No newline at end of file
+}
+TEST_F(IOTest, ply_io)
+{
+    add_triangles();
+    vertex_normals(mesh);
+    mesh.add_vertex_property<Color>("v:color", Color(1, 0.5, 0));
+    mesh.add_vertex_property<TexCoord>("v:tex", TexCoord(0.25, 0.75));
+    auto quality = mesh.add_vertex_property<float>("v:quality");
+    quality[v1] = 0.5f;
+    auto label = mesh.add_face_property<int>("f:label");
+    label[f1] = -7;
+    auto flags = mesh.add_face_property<bool>("f:selected");
+    flags[f0] = true;
+    mesh.add_face_property<vec3>("f:direction", vec3(1, 2, 3));
+
+    IOFlags io_flags;
+    io_flags.use_vertex_normals = true;
+    io_flags.use_vertex_colors = true;
+    io_flags.use_vertex_texcoords = true;
+
+    for (auto [binary, big_endian] : {std::pair{false, false},
+                                      std::pair{true, false},
+                                      std::pair{true, true}})
+    {
+        io_flags.use_binary = binary;
+        io_flags.use_big_endian = big_endian;
+        write(mesh, "test.ply", io_flags);
+
+        SurfaceMesh result;
+        read(result, "test.ply");
+        EXPECT_EQ(result.n_vertices(), size_t(4));
+        EXPECT_EQ(result.n_faces(), size_t(2));
+        EXPECT_EQ(result.position(Vertex(3)), mesh.position(v3));
+
+        auto normals = result.get_vertex_property<Normal>("v:normal");
+        ASSERT_TRUE(normals);
+        EXPECT_LT(norm(normals[Vertex(0)] - Normal(0, 0, 1)), 1e-6);
+        auto colors = result.get_vertex_property<Color>("v:color");
+        ASSERT_TRUE(colors);
+        EXPECT_LT(norm(colors[Vertex(2)] - Color(1, 128.0 / 255.0, 0)), 1e-6);
+        auto tex = result.get_vertex_property<TexCoord>("v:tex");
+        ASSERT_TRUE(tex);
+        EXPECT_EQ(tex[Vertex(1)], TexCoord(0.25, 0.75));
+
+        auto q = result.get_vertex_property<float>("v:quality");
+        ASSERT_TRUE(q);
+        EXPECT_EQ(q[Vertex(1)], 0.5f);
+        auto l = result.get_face_property<int>("f:label");
+        ASSERT_TRUE(l);
+        EXPECT_EQ(l[Face(1)], -7);
+        auto s = result.get_face_property<uint8_t>("f:selected");
+        ASSERT_TRUE(s);
+        EXPECT_EQ(s[Face(0)], 1);
+        EXPECT_EQ(s[Face(1)], 0);
+        auto d = result.get_face_property<float>("f:direction_2");
+        ASSERT_TRUE(d);
+        EXPECT_EQ(d[Face(0)], 3.0f);
+    }
+}
+
+TEST_F(IOTest, ply_io_positions)
+{
+    // positions only take the bulk path for native binary files
+    for (int i = 0; i < 100; ++i)
+        mesh.add_vertex(Point(i, 0.5 * i, -i));
+    for (int i = 0; i + 2 < 100; ++i)
+        mesh.add_triangle(Vertex(0), Vertex(i + 1), Vertex(i + 2));
+    mesh.delete_vertex(Vertex(99));
+
+    IOFlags flags;
+    flags.use_binary = true;
+    write(mesh, "binary.ply", flags);
+    mesh.garbage_collection();
+
+    SurfaceMesh result;
+    read(result, "binary.ply");
+    ASSERT_EQ(result.n_vertices(), mesh.n_vertices());
+    ASSERT_EQ(result.n_faces(), mesh.n_faces());
+    EXPECT_EQ(result.positions(), mesh.positions());
+}
+
+TEST_F(IOTest, read_ply_ascii)
+{
+    auto file = fopen("test.ply", "w");
+    fprintf(file, "ply\r\n"
+                  "format ascii 1.0\r\n"
+                  "comment hand written\r\n"
+                  "element vertex 4\r\n"
+                  "property double x\r\n"
+                  "property double y\r\n"
+                  "property double z\r\n"
+                  "property ushort red\r\n"
+                  "property ushort green\r\n"
+                  "property ushort blue\r\n"
+                  "property list uchar int ignored\r\n"
+                  "property char id\r\n"
+                  "element face 2\r\n"
+                  "property list uchar uint vertex_index\r\n"
+                  "element edge 1\r\n"
+                  "property int vertex1\r\n"
+                  "property int vertex2\r\n"
+                  "end_header\r\n"
+                  "0 0 0 65535 0 0 2 1 2 -1\r\n"
+                  "1 0 0 0 65535 0 0 -2\r\n"
+                  "0 1 0 0 0 65535 0 -3\r\n"
+                  "1 1 0 0 0 0 0 -4\r\n"
+                  "4 0 1 3 2\r\n"
+                  "3 0 1 2\r\n"
+                  "0 1\r\n");
+    fclose(file);
+
+    read(mesh, "test.ply");
+    EXPECT_EQ(mesh.n_vertices(), size_t(4));
+    EXPECT_EQ(mesh.n_faces(), size_t(1)); // second face is non-manifold
+    EXPECT_EQ(mesh.position(Vertex(3)), Point(1, 1, 0));
+    auto colors = mesh.get_vertex_property<Color>("v:color");
+    ASSERT_TRUE(colors);
+    EXPECT_EQ(colors[Vertex(1)], Color(0, 1, 0));
+    auto ids = mesh.get_vertex_property<int8_t>("v:id");
+    ASSERT_TRUE(ids);
+    EXPECT_EQ(ids[Vertex(2)], -3);
+    EXPECT_FALSE(mesh.get_vertex_property<int>("v:ignored"));
+}
+
+TEST_F(IOTest, read_ply_invalid)
+{
+    auto file = fopen("test.ply", "w");
+    fprintf(file, "ply\nformat binary_little_endian 1.0\n"
+                  "element vertex 1\nproperty float x\nproperty float y\n"
+                  "property float z\nelement face 1\n"
+                  "property list uchar int vertex_indices\nend_header\n");
+    fclose(file);
+    EXPECT_THROW(read(mesh, "test.ply"), IOException);
+
+    file = fopen("test.ply", "w");
+    fprintf(file, "ply\nformat ascii 1.0\nelement vertex 3\nproperty float x\n"
+                  "property float y\nproperty float z\nelement face 1\n"
+                  "property list uchar int vertex_indices\nend_header\n"
+                  "0 0 0\n1 0 0\n0 1 0\n3 0 1 3\n");
+    fclose(file);
+    EXPECT_THROW(read(mesh, "test.ply"), IOException);
+
+    file = fopen("test.ply", "w");
+    fprintf(file, "ply\nformat unknown 1.0\nend_header\n");
+    fclose(file);
+    EXPECT_THROW(read(mesh, "test.ply"), IOException);
+
+    // negative and oversized element counts
+    file = fopen("test.ply", "w");
+    fprintf(file, "ply\nformat binary_little_endian 1.0\n"
+                  "element vertex -1\nproperty float x\nend_header\n");
+    fclose(file);
+    EXPECT_THROW(read(mesh, "test.ply"), IOException);
+
+    file = fopen("test.ply", "w");
+    fprintf(file, "ply\nformat binary_little_endian 1.0\n"
+                  "element vertex 1000000000\nproperty float x\n"
+                  "end_header\n");
+    fclose(file);
+    EXPECT_THROW(read(mesh, "test.ply"), IOException);
+    EXPECT_EQ(mesh.n_vertices(), size_t(0));
+
+    // index out of the range of int
+    file = fopen("test.ply", "w");
+    fprintf(file, "ply\nformat ascii 1.0\nelement vertex 3\nproperty float x\n"
+                  "property float y\nproperty float z\nelement face 1\n"
+                  "property list uchar uint vertex_indices\nend_header\n"
+                  "0 0 0\n1 0 0\n0 1 0\n3 0 1 4294967295\n");
+    fclose(file);
+    EXPECT_THROW(read(mesh, "test.ply"), IOException);
+
+    // scalar values out of the range of their type
+    for (const char* value : {"-1", "300", "nan"})
+    {
+        file = fopen("test.ply", "w");
+        fprintf(file,
+                "ply\nformat ascii 1.0\nelement vertex 1\nproperty float x\n"
+                "property float y\nproperty float z\nproperty uchar red\n"
+                "end_header\n0 0 0 %s\n",
+                value);
+        fclose(file);
+        EXPECT_THROW(read(mesh, "test.ply"), IOException) << value;
+    }
+}
+
+TEST_F(IOTest, glb_io)
+{
+    add_quad();
+    vertex_normals(mesh);
+    mesh.add_vertex_property<Color>("v:color", Color(1, 0.5, 0));
+    auto tex = mesh.add_vertex_property<TexCoord>("v:tex");
+    for (auto v : mesh.vertices())
+        tex[v] = TexCoord(mesh.position(v)[0], mesh.position(v)[1]);
+
+    IOFlags flags;
+    flags.use_vertex_normals = true;
+    flags.use_vertex_colors = true;
+    flags.use_vertex_texcoords = true;
+    write(mesh, "test.glb", flags);
+
+    SurfaceMesh result;
+    read(result, "test.glb");
+    EXPECT_EQ(result.n_vertices(), size_t(4));
+    EXPECT_EQ(result.n_faces(), size_t(2)); // quad is triangulated
+    for (auto v : mesh.vertices())
+        EXPECT_EQ(result.position(v), mesh.position(v));
+
+    auto normals = result.get_vertex_property<Normal>("v:normal");
+    auto colors = result.get_vertex_property<Color>("v:color");
+    auto texcoords = result.get_vertex_property<TexCoord>("v:tex");
+    ASSERT_TRUE(normals && colors && texcoords);
+    EXPECT_LT(norm(normals[v2] - Normal(0, 0, 1)), 1e-6);
+    EXPECT_EQ(colors[v1], Color(1, 0.5, 0));
+    EXPECT_LT(norm(texcoords[v3] - tex[v3]), 1e-6);
+}
+
+TEST_F(IOTest, glb_io_quantized)
+{
+    mesh = icosphere(4);
+    vertex_normals(mesh);
+    mesh.add_vertex_property<Color>("v:color", Color(0.2, 0.4, 0.6));
+
+    IOFlags flags;
+    flags.use_vertex_normals = true;
+    flags.use_vertex_colors = true;
+    write(mesh, "test.glb", flags);
+    const auto size = std::filesystem::file_size("test.glb");
+
+    flags.use_quantization = true;
+    write(mesh, "quantized.glb", flags);
+    EXPECT_LT(std::filesystem::file_size("quantized.glb"), size);
+
+    SurfaceMesh result;
+    read(result, "quantized.glb");
+    ASSERT_EQ(result.n_vertices(), mesh.n_vertices());
+    EXPECT_EQ(result.n_faces(), mesh.n_faces());
+
+    // within half a quantization step of the bounding box extent
+    auto normals = result.get_vertex_property<Normal>("v:normal");
+    auto colors = result.get_vertex_property<Color>("v:color");
+    ASSERT_TRUE(normals && colors);
+    for (auto v : mesh.vertices())
+    {
+        EXPECT_LT(norm(result.position(v) - mesh.position(v)), 1e-4);
+        EXPECT_LT(norm(normals[v] - mesh.get_vertex_property<Normal>(
+                                        "v:normal")[v]),
+                  2e-2);
+        EXPECT_LT(norm(colors[v] - Color(0.2, 0.4, 0.6)), 1e-2);
+    }
+}
+
+TEST_F(IOTest, glb_io_point_cloud)
+{
+    for (int i = 0; i < 6; ++i)
+        mesh.add_vertex(Point(i, 0.5 * i, -i));
+    mesh.add_vertex_property<Color>("v:color", Color(1, 0.5, 0));
+
+    IOFlags flags;
+    flags.use_vertex_colors = true;
+    write(mesh, "test.glb", flags);
+
+    SurfaceMesh result;
+    read(result, "test.glb");
+    ASSERT_EQ(result.n_vertices(), size_t(6));
+    EXPECT_EQ(result.n_faces(), size_t(0));
+    for (auto v : mesh.vertices())
+        EXPECT_EQ(result.position(v), mesh.position(v));
+    auto colors = result.get_vertex_property<Color>("v:color");
+    ASSERT_TRUE(colors);
+    EXPECT_EQ(colors[Vertex(5)], Color(1, 0.5, 0));
+}
+
+// write a GLB file with a JSON chunk and a binary chunk holding the
+// positions of a triangle
+void write_triangle_glb(const std::string& json)
+{
+    const float positions[9] = {0, 0, 0, 1, 0, 0, 0, 1, 0};
+    const std::string header =
+        R"({"asset":{"version":"2.0"},"buffers":[{"byteLength":36}],)"
+        R"("bufferViews":[{"buffer":0,"byteLength":36}],)"
+        R"("meshes":[{"primitives":[{"attributes":{"POSITION":0}}]}],)";
+    auto padded = header + json;
+    padded.resize((padded.size() + 3) / 4 * 4, ' ');
+
+    const uint32_t json_size = padded.size();
+    const uint32_t bin_size = sizeof(positions);
+    const uint32_t glb[3] = {0x46546C67, 2,
+                             12 + 8 + json_size + 8 + bin_size};
+    const uint32_t json_chunk[2] = {json_size, 0x4E4F534A};
+    const uint32_t bin_chunk[2] = {bin_size, 0x004E4942};
+
+    auto file = fopen("test.glb", "wb");
+    fwrite(glb, sizeof(glb), 1, file);
+    fwrite(json_chunk, sizeof(json_chunk), 1, file);
+    fwrite(padded.data(), padded.size(), 1, file);
+    fwrite(bin_chunk, sizeof(bin_chunk), 1, file);
+    fwrite(positions, sizeof(positions), 1, file);
+    fclose(file);
+}
+
+TEST_F(IOTest, read_glb_node_hierarchy)
+{
+    write_triangle_glb(
+        R"("accessors":[{"bufferView":0,"componentType":5126,"count":3,)"
+        R"("type":"VEC3"}],"scene":0,"scenes":[{"nodes":[0]}],)"
+        R"("nodes":[{"translation":[1,0,0],"children":[1]},)"
+        R"({"mesh":0,"scale":[2,2,2]}]})");
+    read(mesh, "test.glb");
+    ASSERT_EQ(mesh.n_vertices(), size_t(3));
+    EXPECT_EQ(mesh.position(Vertex(0)), Point(1, 0, 0));
+    EXPECT_EQ(mesh.position(Vertex(1)), Point(3, 0, 0));
+    EXPECT_EQ(mesh.position(Vertex(2)), Point(1, 2, 0));
+}
+
+TEST_F(IOTest, read_glb_invalid_accessor)
+{
+    write_triangle_glb(
+        R"("accessors":[{"bufferView":0,"componentType":5126,"count":4,)"
+        R"("type":"VEC2"}]})");
+    EXPECT_THROW(read(mesh, "test.glb"), IOException);
+}
+
+TEST_F(IOTest, read_glb_accessor_bounds)
+{
+    const std::string accessors[] = {
+        R"("bufferView":0,"count":4611686018427387904,"type":"VEC4")",
+        R"("bufferView":0,"count":4611686018427387904,"byteOffset":8)",
+        R"("bufferView":0,"count":3,"byteOffset":4)",
+        R"("bufferView":0,"count":3,"byteOffset":-4)",
+        R"("bufferView":0,"count":2.5)",
+        R"("bufferView":0,"count":1e300)",
+        R"("bufferView":1e30,"count":3)",
+        R"("count":4611686018427387904)",
+    };
+    for (const auto& accessor : accessors)
+    {
+        write_triangle_glb(R"("accessors":[{"componentType":5126,)" +
+                           accessor + R"(,"type":"VEC3"}]})");
+        EXPECT_THROW(read(mesh, "test.glb"), IOException) << accessor;
+    }
+}
+
+TEST_F(IOTest, read_glb_invalid)
+{
+    auto file = fopen("test.glb", "wb");
+    fprintf(file, "glTF");
+    fclose(file);
+    EXPECT_THROW(read(mesh, "test.glb"), IOException);
+
+    add_triangle();
+    write(mesh, "test.glb");
+
+    // corrupt the JSON chunk
+    file = fopen("test.glb", "r+b");
+    fseek(file, 20, SEEK_SET);
+    fputc('[', file);
+    fclose(file);
+    EXPECT_THROW(read(mesh, "test.glb"), IOException);
+}
@@ -0,0 +1,146 @@
+// Copyright 2023 the Polygon Mesh Processing Library developers.
+// Distributed under a MIT-style license, see LICENSE.txt for details.
+
+#include "gtest/gtest.h"
+
+#include "pmp/job_runner.h"
+#include "pmp/algorithms/shapes.h"
+#include "pmp/algorithms/subdivision.h"
+#include "pmp/exceptions.h"
+
+#include <chrono>
+#include <thread>
+#include <vector>
+
+using namespace pmp;
+
+TEST(JobRunnerTest, result)
+{
+    auto mesh = icosphere(1);
+    const auto n_faces = mesh.n_faces();
+
+    JobRunner jobs;
+    EXPECT_FALSE(jobs.is_busy());
+    EXPECT_TRUE(jobs.start("subdivide", mesh,
+                           [](SurfaceMesh& m, Progress& progress) {
+                               loop_subdivision(m);
+                               progress.set_fraction(0.5f);
+                               loop_subdivision(m);
+                           }));
+    EXPECT_TRUE(jobs.is_busy());
+    EXPECT_EQ(jobs.name(), "subdivide");
+
+    // the input is untouched while the job runs
+    EXPECT_EQ(mesh.n_faces(), n_faces);
+
+    jobs.wait();
+    EXPECT_TRUE(jobs.is_finished());
+    EXPECT_EQ(jobs.progress(), 1.0f);
+    EXPECT_EQ(mesh.n_faces(), n_faces);
+    EXPECT_TRUE(jobs.collect(mesh));
+    EXPECT_TRUE(jobs.error().empty());
+    EXPECT_FALSE(jobs.is_busy());
+    EXPECT_EQ(mesh.n_faces(), 16 * n_faces);
+
+    // nothing left to collect
+    EXPECT_FALSE(jobs.collect(mesh));
+}
+
+TEST(JobRunnerTest, busy)
+{
+    auto mesh = icosphere(1);
+    JobRunner jobs;
+    jobs.start("wait", mesh, [](SurfaceMesh&, Progress& progress) {
+        while (!progress.is_canceled())
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    });
+    EXPECT_FALSE(jobs.start("other", mesh, [](SurfaceMesh&, Progress&) {}));
+    EXPECT_FALSE(jobs.collect(mesh));
+    EXPECT_EQ(jobs.name(), "wait");
+    jobs.cancel();
+    jobs.wait();
+    EXPECT_FALSE(jobs.collect(mesh));
+    EXPECT_TRUE(jobs.start("other", mesh, [](SurfaceMesh&, Progress&) {}));
+    jobs.wait();
+    EXPECT_TRUE(jobs.collect(mesh));
+}
+
+TEST(JobRunnerTest, cancel)
+{
+    auto mesh = icosphere(1);
+    const auto n_faces = mesh.n_faces();
+
+    JobRunner jobs;
+    jobs.start("cancel", mesh, [](SurfaceMesh& m, Progress& progress) {
+        while (!progress.is_canceled())
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        m.clear();
+    });
+    jobs.cancel();
+    jobs.wait();
+    EXPECT_FALSE(jobs.collect(mesh));
+    EXPECT_EQ(jobs.error(), "Canceled");
+    EXPECT_FALSE(jobs.is_busy());
+    EXPECT_EQ(mesh.n_faces(), n_faces);
+}
+
+TEST(JobRunnerTest, cancel_keeps_input)
+{
+    auto mesh = icosphere(1);
+    const auto& input = mesh;
+    std::vector<Point> points;
+    for (auto v : input.vertices())
+        points.push_back(input.position(v));
+
+    JobRunner jobs;
+    jobs.start("scale", mesh, [](SurfaceMesh& m, Progress& progress) {
+        for (auto v : m.vertices())
+            m.position(v) *= 2;
+        auto normals = m.vertex_property<Normal>("v:normal");
+        for (auto v : m.vertices())
+            normals[v] = Normal(0, 0, 1);
+        while (!progress.is_canceled())
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    });
+    jobs.cancel();
+    jobs.wait();
+    EXPECT_FALSE(jobs.collect(mesh));
+    for (auto v : input.vertices())
+        EXPECT_EQ(input.position(v), points[v.idx()]);
+    EXPECT_FALSE(mesh.has_vertex_property("v:normal"));
+}
+
+TEST(JobRunnerTest, error)
+{
+    auto mesh = icosphere(1);
+    JobRunner jobs;
+    jobs.start("throw", mesh, [](SurfaceMesh&, Progress&) {
+        throw InvalidInputException("Input is not a triangle mesh!");
+    });
+    jobs.wait();
+    EXPECT_FALSE(jobs.collect(mesh));
+    EXPECT_EQ(jobs.error(), "Input is not a triangle mesh!");
+}
+
+TEST(JobRunnerTest, destructor_cancels)
+{
+    auto mesh = icosphere(1);
+    JobRunner jobs;
+    jobs.start("wait", mesh, [](SurfaceMesh&, Progress& progress) {
+        while (!progress.is_canceled())
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    });
+}
+
+TEST(JobRunnerTest, progress)
+{
+    Progress progress;
+    progress.set_fraction(2.0f);
+    EXPECT_EQ(progress.fraction(), 1.0f);
+    progress.set_fraction(-1.0f);
+    EXPECT_EQ(progress.fraction(), 0.0f);
+    progress.cancel();
+    EXPECT_TRUE(progress.is_canceled());
+    progress.reset();
+    EXPECT_FALSE(progress.is_canceled());
+}
@@ -0,0 +1,200 @@
+// Copyright 2023 the Polygon Mesh Processing Library developers.
+// Distributed under a MIT-style license, see LICENSE.txt for details.
+
+#include "gtest/gtest.h"
+
+#include "pmp/algorithms/meshlets.h"
+#include "pmp/algorithms/normals.h"
+#include "pmp/algorithms/shapes.h"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstdio>
+
+using namespace pmp;
+
+// sorted position indices of the triangles of the meshlets of a level
+std::vector<std::array<uint32_t, 3>> level_triangles(const Meshlets& m,
+                                                     uint32_t level)
+{
+    std::vector<std::array<uint32_t, 3>> result;
+    for (const auto& meshlet : m.meshlets)
+    {
+        if (meshlet.level != level)
+            continue;
+        for (size_t t = 0; t < meshlet.n_triangles; ++t)
+        {
+            std::array<uint32_t, 3> tri;
+            for (size_t k = 0; k < 3; ++k)
+                tri[k] = m.vertices[meshlet.vertex_offset +
+                                    m.triangles[meshlet.triangle_offset +
+                                                3 * t + k]];
+            std::rotate(tri.begin(), std::min_element(tri.begin(), tri.end()),
+                        tri.end());
+            result.push_back(tri);
+        }
+    }
+    std::sort(result.begin(), result.end());
+    return result;
+}
+
+TEST(MeshletsTest, meshlets)
+{
+    const auto mesh = icosphere(4);
+    const auto m = meshlets(mesh, 32, 48);
+    EXPECT_EQ(m.n_levels(), size_t(1));
+    EXPECT_EQ(m.positions.size(), mesh.n_vertices());
+
+    size_t n_triangles = 0;
+    for (const auto& meshlet : m.meshlets)
+    {
+        EXPECT_LE(meshlet.n_vertices, 32u);
+        EXPECT_LE(meshlet.n_triangles, 48u);
+        n_triangles += meshlet.n_triangles;
+
+        // vertices are inside the bounding sphere, face normals inside the
+        // normal cone
+        for (size_t i = 0; i < meshlet.n_vertices; ++i)
+        {
+            const auto& p = m.positions[m.vertices[meshlet.vertex_offset + i]];
+            EXPECT_LE(norm(p - meshlet.center), meshlet.radius * 1.0001);
+        }
+        const auto position = [&](size_t i) {
+            const auto local = m.triangles[meshlet.triangle_offset + i];
+            return m.positions[m.vertices[meshlet.vertex_offset + local]];
+        };
+        for (size_t t = 0; t < meshlet.n_triangles; ++t)
+        {
+            const auto p0 = position(3 * t);
+            const auto p1 = position(3 * t + 1);
+            const auto p2 = position(3 * t + 2);
+            const auto n = normalize(cross(p1 - p0, p2 - p0));
+            EXPECT_GE(dot(n, meshlet.cone_axis),
+                      std::cos(meshlet.cone_angle) - 1e-4);
+        }
+        EXPECT_LT(meshlet.cone_angle, M_PI / 2);
+    }
+    EXPECT_EQ(n_triangles, mesh.n_faces());
+
+    // meshlets are well filled
+    EXPECT_LT(m.meshlets.size(), 2 * mesh.n_faces() / 48);
+}
+
+TEST(MeshletsTest, meshlet_lod)
+{
+    const auto mesh = icosphere(5);
+    const auto m = meshlet_lod(mesh);
+    ASSERT_GT(m.n_levels(), size_t(2));
+
+    // the finest level is the input mesh
+    const auto finest = level_triangles(m, 0);
+    EXPECT_EQ(finest.size(), mesh.n_faces());
+
+    size_t n_roots = 0;
+    size_t n_previous = finest.size();
+    for (uint32_t l = 1; l < m.n_levels(); ++l)
+    {
+        const auto n = level_triangles(m, l).size();
+        EXPECT_LT(n, n_previous);
+        n_previous = n;
+    }
+    for (const auto& meshlet : m.meshlets)
+    {
+        EXPECT_LE(meshlet.error, meshlet.parent_error);
+        if (meshlet.parent_error == std::numeric_limits<Scalar>::max())
+        {
+            ++n_roots;
+            EXPECT_EQ(meshlet.level, m.n_levels() - 1);
+        }
+        if (meshlet.level == 0)
+        {
+            EXPECT_EQ(meshlet.error, 0);
+        }
+    }
+    EXPECT_GE(n_roots, size_t(1));
+
+    // a cut through the hierarchy is a closed mesh
+    std::vector<Scalar> errors;
+    for (const auto& meshlet : m.meshlets)
+        errors.push_back(meshlet.error);
+    std::sort(errors.begin(), errors.end());
+    for (auto threshold : {errors[errors.size() / 2], errors.back()})
+    {
+        SurfaceMesh cut;
+        for (const auto& p : m.positions)
+            cut.add_vertex(p);
+        for (const auto& meshlet : m.meshlets)
+        {
+            if (meshlet.error > threshold || meshlet.parent_error <= threshold)
+                continue;
+            for (size_t t = 0; t < meshlet.n_triangles; ++t)
+            {
+                std::array<Vertex, 3> v;
+                for (size_t k = 0; k < 3; ++k)
+                    v[k] = Vertex(
+                        m.vertices[meshlet.vertex_offset +
+                                   m.triangles[meshlet.triangle_offset +
+                                               3 * t + k]]);
+                cut.add_triangle(v[0], v[1], v[2]);
+            }
+        }
+        for (auto e : cut.edges())
+            EXPECT_FALSE(cut.is_boundary(e));
+    }
+
+    // meshlets are sorted from coarse to fine
+    EXPECT_TRUE(std::is_sorted(m.meshlets.begin(), m.meshlets.end(),
+                               [](const Meshlet& a, const Meshlet& b) {
+                                   return a.level > b.level;
+                               }));
+}
+
+TEST(MeshletsTest, write_read)
+{
+    const auto m = meshlet_lod(icosphere(4));
+    m.write("meshlets.pmpml");
+
+    Meshlets m2;
+    m2.read("meshlets.pmpml");
+    EXPECT_EQ(m2.n_levels(), m.n_levels());
+    EXPECT_EQ(m2.positions, m.positions);
+    EXPECT_EQ(m2.vertices, m.vertices);
+    EXPECT_EQ(m2.triangles, m.triangles);
+    ASSERT_EQ(m2.meshlets.size(), m.meshlets.size());
+    for (size_t i = 0; i < m.meshlets.size(); ++i)
+    {
+        EXPECT_EQ(m2.meshlets[i].vertex_offset, m.meshlets[i].vertex_offset);
+        EXPECT_EQ(m2.meshlets[i].level, m.meshlets[i].level);
+        EXPECT_EQ(m2.meshlets[i].center, m.meshlets[i].center);
+        EXPECT_EQ(m2.meshlets[i].parent_error, m.meshlets[i].parent_error);
+    }
+
+    // the coarsest level only
+    Meshlets coarse;
+    coarse.read("meshlets.pmpml", 1);
+    EXPECT_EQ(coarse.n_levels(), size_t(1));
+    for (const auto& meshlet : coarse.meshlets)
+        EXPECT_EQ(meshlet.parent_error, std::numeric_limits<Scalar>::max());
+    EXPECT_LT(coarse.positions.size(), m.positions.size());
+
+    EXPECT_THROW(m2.read("nonexistent.pmpml"), IOException);
+
+    // counts exceeding the file size
+    auto file = fopen("meshlets.pmpml", "wb");
+    const uint32_t header[5] = {1, 0xFFFFFFFF, 0xFFFFFFFF, 0xFFFFFFFF,
+                                0xFFFFFFFF};
+    fwrite("PMPML", 1, 5, file);
+    fwrite(header, sizeof(header), 1, file);
+    fclose(file);
+    EXPECT_THROW(m2.read("meshlets.pmpml"), IOException);
+    EXPECT_TRUE(m2.positions.empty());
+}
+
+TEST(MeshletsTest, invalid_input)
+{
+    EXPECT_THROW(meshlets(quad_sphere(1)), InvalidInputException);
+    EXPECT_THROW(meshlets(icosphere(1), 2), InvalidInputException);
+    EXPECT_THROW(meshlets(icosphere(1), 257), InvalidInputException);
+    EXPECT_THROW(meshlet_lod(icosphere(1), 64, 0), InvalidInputException);
+}
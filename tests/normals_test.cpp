@@ -18,6 +18,24 @@ TEST(NormalsTest, vertex_normals)
     EXPECT_GT(norm(vn0), 0);
 }
 
+TEST(NormalsTest, vertex_normals_corner_table)
+{
+    auto mesh = icosphere(3);
+    auto expected = mesh;
+    vertex_normals(expected);
+    vertex_normals(mesh, CornerTable(mesh));
+
+    auto vnormals = mesh.get_vertex_property<Normal>("v:normal");
+    auto expected_normals = expected.get_vertex_property<Normal>("v:normal");
+    ASSERT_TRUE(vnormals);
+    for (auto v : mesh.vertices())
+        EXPECT_LT(norm(vnormals[v] - expected_normals[v]), 1e-5);
+
+    mesh.add_vertex(Point(0, 0, 0));
+    EXPECT_THROW(vertex_normals(mesh, CornerTable(icosphere(3))),
+                 InvalidInputException);
+}
+
 TEST(NormalsTest, face_normals)
 {
     auto mesh = icosahedron();
@@ -48,3 +66,58 @@ TEST(NormalsTest, polygonal_face_normal)
     auto n0 = face_normal(mesh, f0);
     EXPECT_GT(norm(n0), 0);
 }
+
+TEST(NormalsTest, corner_normals)
+{
+    // corners at the sharp edges of a cube keep their face normals
+    auto mesh = hexahedron();
+    corner_normals(mesh, (Scalar)M_PI / 3.0);
+    auto hnormals = mesh.get_halfedge_property<Normal>("h:normal");
+    ASSERT_TRUE(hnormals);
+    for (auto h : mesh.halfedges())
+        EXPECT_EQ(hnormals[h], face_normal(mesh, mesh.face(h)));
+
+    // a crease angle above the dihedral angles results in vertex normals
+    corner_normals(mesh, (Scalar)M_PI * 0.6);
+    for (auto h : mesh.halfedges())
+        EXPECT_LT(norm(hnormals[h] - vertex_normal(mesh, mesh.to_vertex(h))),
+                  1e-5);
+
+    // smooth surfaces as well
+    mesh = icosphere(3);
+    corner_normals(mesh, (Scalar)M_PI / 3.0);
+    hnormals = mesh.get_halfedge_property<Normal>("h:normal");
+    for (auto h : mesh.halfedges())
+        EXPECT_LT(norm(hnormals[h] - vertex_normal(mesh, mesh.to_vertex(h))),
+                  1e-5);
+}
+
+TEST(NormalsTest, corner_normals_boundary)
+{
+    auto mesh = plane(2);
+    corner_normals(mesh, (Scalar)M_PI / 3.0);
+    auto hnormals = mesh.get_halfedge_property<Normal>("h:normal");
+    for (auto h : mesh.halfedges())
+    {
+        if (mesh.is_boundary(h))
+        {
+            EXPECT_EQ(hnormals[h], Normal(0, 0, 0));
+        }
+        else
+        {
+            EXPECT_LT(norm(hnormals[h] - Normal(0, 0, 1)), 1e-5);
+        }
+    }
+}
+
+TEST(NormalsTest, fan_normals)
+{
+    // the corners of a fan share the same normal
+    auto mesh = icosphere(2);
+    std::vector<Normal> normals;
+    const auto normal_of = [&](Face f) { return face_normal(mesh, f); };
+    fan_normals(mesh, Vertex(0), (Scalar)M_PI / 3.0, normal_of, normals);
+    ASSERT_EQ(normals.size(), mesh.valence(Vertex(0)));
+    for (const auto& n : normals)
+        EXPECT_EQ(n, normals.front());
+}
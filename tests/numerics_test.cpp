@@ -35,4 +35,19 @@ TEST(NumericsTest, mesh_to_matrices)
     EXPECT_TRUE(V.rows() == 3);
     EXPECT_TRUE(F.cols() == 3);
     EXPECT_TRUE(F.rows() == 1);
-}
\ No newline at end of file
+}
+TEST(NumericsTest, cholesky_solve_canceled)
+{
+    SparseMatrix A(2, 2);
+    A.insert(0, 0) = 2;
+    A.insert(1, 1) = 2;
+    DenseMatrix B = DenseMatrix::Ones(2, 1);
+    EXPECT_NEAR(cholesky_solve(A, B)(1, 0), 0.5, 1e-12);
+
+    Progress progress;
+    progress.cancel();
+    EXPECT_THROW(cholesky_solve(A, B, &progress), CanceledException);
+    auto is_constrained = [](unsigned int i) { return i == 0; };
+    EXPECT_THROW(cholesky_solve(A, B, is_constrained, B, &progress),
+                 CanceledException);
+}
@@ -0,0 +1,134 @@
+// Copyright 2023 the Polygon Mesh Processing Library developers.
+// Distributed under a MIT-style license, see LICENSE.txt for details.
+
+#include "gtest/gtest.h"
+
+#include "pmp/algorithms/decimation.h"
+#include "pmp/algorithms/progressive_mesh.h"
+#include "pmp/algorithms/shapes.h"
+
+#include <cstdio>
+
+using namespace pmp;
+
+size_t n_boundary_edges(const SurfaceMesh& mesh)
+{
+    size_t n = 0;
+    for (auto e : mesh.edges())
+        if (mesh.is_boundary(e))
+            ++n;
+    return n;
+}
+
+TEST(ProgressiveMeshTest, extract)
+{
+    auto mesh = icosphere(3);
+    auto pm = progressive_mesh(mesh, 50);
+    EXPECT_EQ(pm.n_vertices(), mesh.n_vertices());
+    EXPECT_EQ(pm.n_base_vertices(), size_t(50));
+
+    // finest level is the input mesh
+    auto finest = pm.extract(pm.n_vertices());
+    EXPECT_EQ(finest.n_vertices(), mesh.n_vertices());
+    EXPECT_EQ(finest.n_faces(), mesh.n_faces());
+
+    // coarsest level matches decimation
+    auto decimated = mesh;
+    decimate(decimated, 50);
+    auto coarsest = pm.extract(0);
+    EXPECT_EQ(coarsest.n_vertices(), decimated.n_vertices());
+    EXPECT_EQ(coarsest.n_faces(), decimated.n_faces());
+
+    // intermediate levels are closed meshes of genus zero
+    for (size_t n : {100, 200, 400})
+    {
+        size_t n_skipped = 1;
+        auto lod = pm.extract(n, &n_skipped);
+        EXPECT_EQ(n_skipped, size_t(0));
+        EXPECT_EQ(lod.n_vertices(), n);
+        EXPECT_EQ(lod.n_faces(), 2 * n - 4);
+        EXPECT_EQ(n_boundary_edges(lod), size_t(0));
+    }
+}
+
+TEST(ProgressiveMeshTest, vertices_are_ordered_by_level)
+{
+    auto pm = progressive_mesh(icosphere(2), 20);
+    for (size_t i = 0; i < pm.n_collapses(); ++i)
+    {
+        const auto& c = pm.collapse(i);
+        EXPECT_EQ(c.v0, pm.n_vertices() - 1 - i);
+        EXPECT_LT(c.v1, c.v0);
+    }
+}
+
+TEST(ProgressiveMeshTest, view_dependent_refinement)
+{
+    auto pm = progressive_mesh(icosphere(3), 50);
+
+    // refine the upper hemisphere only
+    auto lod = pm.extract([&](const ProgressiveMesh::Collapse& c) {
+        return pm.position(c.v0)[2] > 0;
+    });
+    EXPECT_GT(lod.n_vertices(), pm.n_base_vertices());
+    EXPECT_LT(lod.n_vertices(), pm.n_vertices());
+    EXPECT_EQ(n_boundary_edges(lod), size_t(0));
+
+    size_t n_upper = 0;
+    for (auto v : lod.vertices())
+        if (lod.position(v)[2] > 0)
+            ++n_upper;
+    EXPECT_GT(n_upper, lod.n_vertices() / 2);
+
+    // refining everything yields the input mesh
+    auto finest = pm.extract([](const ProgressiveMesh::Collapse&) {
+        return true;
+    });
+    EXPECT_EQ(finest.n_vertices(), pm.n_vertices());
+}
+
+TEST(ProgressiveMeshTest, skipped_triangles)
+{
+    // collapsing a vertex into a non-adjacent one yields non-manifold fans
+    auto mesh = icosahedron();
+    const Vertex v0(0);
+    Vertex v1;
+    for (auto v : mesh.vertices())
+        if (v != v0 && !mesh.find_halfedge(v0, v).is_valid())
+            v1 = v;
+    ProgressiveMesh pm(mesh, {{v0.idx(), v1.idx(), PMP_MAX_INDEX,
+                               PMP_MAX_INDEX}});
+
+    size_t n_skipped = 0;
+    auto lod = pm.extract(size_t(0), &n_skipped);
+    EXPECT_GT(n_skipped, size_t(0));
+    EXPECT_EQ(lod.n_faces() + n_skipped, mesh.n_faces());
+}
+
+TEST(ProgressiveMeshTest, write_read)
+{
+    auto pm = progressive_mesh(icosphere(2), 20);
+    pm.write("progressive.pm");
+
+    ProgressiveMesh pm2;
+    pm2.read("progressive.pm");
+    EXPECT_EQ(pm2.n_vertices(), pm.n_vertices());
+    EXPECT_EQ(pm2.n_collapses(), pm.n_collapses());
+
+    auto lod = pm.extract(60);
+    auto lod2 = pm2.extract(60);
+    EXPECT_EQ(lod2.n_faces(), lod.n_faces());
+    for (auto v : lod.vertices())
+        EXPECT_EQ(lod2.position(v), lod.position(v));
+
+    EXPECT_THROW(pm2.read("nonexistent.pm"), IOException);
+
+    // counts exceeding the file size
+    auto file = fopen("progressive.pm", "wb");
+    const size_t header[3] = {size_t(1) << 60, size_t(1) << 60, 0};
+    fwrite("PMPPM", 1, 5, file);
+    fwrite(header, sizeof(header), 1, file);
+    fclose(file);
+    EXPECT_THROW(pm2.read("progressive.pm"), IOException);
+    EXPECT_EQ(pm2.n_vertices(), size_t(0));
+}
@@ -60,3 +60,27 @@ TEST(RemeshingTest, uniform_remeshing)
     uniform_remeshing(mesh, 0.5);
     EXPECT_EQ(mesh.n_vertices(), size_t(41));
 }
+
+TEST(RemeshingTest, remeshing_deadline)
+{
+    auto mesh = open_cone();
+    const auto n_vertices = mesh.n_vertices();
+    Progress progress;
+    progress.set_deadline(std::chrono::seconds(0));
+    EXPECT_TRUE(progress.is_canceled());
+    EXPECT_THROW(uniform_remeshing(mesh, 0.5, 10, true, &progress),
+                 CanceledException);
+    EXPECT_EQ(mesh.n_vertices(), n_vertices);
+    EXPECT_FALSE(mesh.has_vertex_property("v:sizing"));
+
+    auto bb = bounds(mesh).size();
+    EXPECT_THROW(adaptive_remeshing(mesh, 0.001 * bb, 1.0 * bb, 0.001 * bb, 10,
+                                    true, &progress),
+                 CanceledException);
+
+    // a distant deadline does not cancel
+    progress.reset();
+    progress.set_deadline(std::chrono::hours(1));
+    uniform_remeshing(mesh, 0.5, 10, true, &progress);
+    EXPECT_EQ(progress.fraction(), 1.0f);
+}
@@ -0,0 +1,175 @@
+// Copyright 2023 the Polygon Mesh Processing Library developers.
+// Distributed under a MIT-style license, see LICENSE.txt for details.
+
+#include "gtest/gtest.h"
+
+#include "pmp/algorithms/render_buffers.h"
+#include "pmp/algorithms/shapes.h"
+#include "helpers.h"
+
+#include <algorithm>
+#include <set>
+#include <utility>
+
+using namespace pmp;
+
+// check that all corners refer to buffer vertices of their vertex
+void check_corners(const SurfaceMesh& mesh, const RenderBuffers& buffers)
+{
+    ASSERT_EQ(buffers.corners.size(), mesh.halfedges_size());
+    for (auto h : mesh.halfedges())
+    {
+        const auto idx = buffers.corners[h.idx()];
+        if (mesh.is_boundary(h))
+        {
+            EXPECT_EQ(idx, RenderBuffers::invalid_index);
+            continue;
+        }
+        ASSERT_LT(idx, buffers.positions.size());
+        EXPECT_EQ(buffers.vertices[idx], mesh.to_vertex(h));
+        EXPECT_EQ(buffers.positions[idx],
+                  vec3(mesh.position(mesh.to_vertex(h))));
+    }
+}
+
+TEST(RenderBuffersTest, smooth_shading)
+{
+    const auto mesh = icosphere(3);
+    const auto buffers = render_buffers(mesh);
+    check_corners(mesh, buffers);
+
+    // one buffer vertex per mesh vertex
+    EXPECT_EQ(buffers.positions.size(), mesh.n_vertices());
+    EXPECT_EQ(buffers.normals.size(), mesh.n_vertices());
+    EXPECT_TRUE(buffers.texcoords.empty());
+    EXPECT_TRUE(buffers.colors.empty());
+    EXPECT_EQ(buffers.triangles.size(), 3 * mesh.n_faces());
+    EXPECT_EQ(buffers.edges.size(), 2 * mesh.n_edges());
+    EXPECT_TRUE(buffers.features.empty());
+}
+
+TEST(RenderBuffersTest, creases)
+{
+    // the corners of a cube are split at the creases
+    const auto mesh = hexahedron();
+    const auto buffers = render_buffers(mesh, 45);
+    check_corners(mesh, buffers);
+    EXPECT_EQ(buffers.positions.size(), size_t(24));
+    EXPECT_EQ(buffers.triangles.size(), size_t(36));
+
+    // the same as flat shading
+    EXPECT_EQ(render_buffers(mesh, 0).positions.size(), size_t(24));
+
+    // but not below the crease angle
+    EXPECT_EQ(render_buffers(mesh, 100).positions.size(), size_t(8));
+}
+
+TEST(RenderBuffersTest, texture_seams)
+{
+    const auto mesh = texture_seams_mesh();
+    const auto buffers = render_buffers(mesh);
+    check_corners(mesh, buffers);
+
+    // corners are split only at seams
+    auto htex = mesh.get_halfedge_property<TexCoord>("h:tex");
+    std::set<std::pair<IndexType, std::pair<Scalar, Scalar>>> unique;
+    for (auto h : mesh.halfedges())
+        if (!mesh.is_boundary(h))
+            unique.insert({mesh.to_vertex(h).idx(), {htex[h][0], htex[h][1]}});
+    EXPECT_GT(unique.size(), mesh.n_vertices());
+    EXPECT_EQ(buffers.positions.size(), unique.size());
+    EXPECT_EQ(buffers.texcoords.size(), unique.size());
+}
+
+TEST(RenderBuffersTest, polygons)
+{
+    auto mesh = quad_sphere(2);
+    auto fcolor = mesh.add_face_property<Color>("f:color", Color(1, 0, 0));
+    fcolor[Face(0)] = Color(0, 1, 0);
+    const auto buffers = render_buffers(mesh);
+    check_corners(mesh, buffers);
+
+    // quads are split into two triangles, the face color splits corners
+    EXPECT_EQ(buffers.triangles.size(), 6 * mesh.n_faces());
+    EXPECT_EQ(buffers.positions.size(), mesh.n_vertices() + 4);
+    EXPECT_EQ(buffers.colors.size(), buffers.positions.size());
+
+    // without colors, there is no seam
+    EXPECT_EQ(render_buffers(mesh, 180, false).positions.size(),
+              mesh.n_vertices());
+}
+
+TEST(RenderBuffersTest, point_cloud)
+{
+    SurfaceMesh mesh;
+    mesh.add_vertex(Point(0, 0, 0));
+    mesh.add_vertex(Point(1, 0, 0));
+    const auto buffers = render_buffers(mesh);
+    EXPECT_EQ(buffers.positions.size(), size_t(2));
+    EXPECT_TRUE(buffers.normals.empty());
+    EXPECT_TRUE(buffers.triangles.empty());
+    EXPECT_TRUE(buffers.corners.empty());
+}
+
+// check that all corners have the same attributes as in a rebuild
+void check_update(const SurfaceMesh& mesh, const RenderBuffers& buffers)
+{
+    const auto rebuilt =
+        render_buffers(mesh, buffers.crease_angle, buffers.use_colors);
+    ASSERT_EQ(rebuilt.positions.size(), buffers.positions.size());
+    for (auto h : mesh.halfedges())
+    {
+        if (mesh.is_boundary(h))
+            continue;
+        const auto i = buffers.corners[h.idx()];
+        const auto j = rebuilt.corners[h.idx()];
+        EXPECT_EQ(buffers.positions[i], rebuilt.positions[j]);
+        EXPECT_EQ(buffers.normals[i], rebuilt.normals[j]);
+        if (!buffers.colors.empty())
+        {
+            EXPECT_EQ(buffers.colors[i], rebuilt.colors[j]);
+        }
+    }
+}
+
+TEST(RenderBuffersTest, update_vertices)
+{
+    auto mesh = icosphere(3);
+    auto buffers = render_buffers(mesh, 60);
+
+    const Vertex v(10);
+    mesh.position(v) *= 1.02;
+    std::vector<unsigned int> updated;
+    ASSERT_TRUE(update_render_buffers(mesh, buffers, {v}, updated));
+    check_update(mesh, buffers);
+
+    // the vertex and its one-ring
+    EXPECT_EQ(updated.size(), mesh.valence(v) + 1);
+    EXPECT_TRUE(std::is_sorted(updated.begin(), updated.end()));
+
+    // a new crease requires a rebuild
+    mesh.position(v) *= 2.0;
+    EXPECT_FALSE(update_render_buffers(mesh, buffers, {v}, updated));
+}
+
+TEST(RenderBuffersTest, update_faces)
+{
+    auto mesh = quad_sphere(2);
+    auto fcolor = mesh.add_face_property<Color>("f:color", Color(1, 0, 0));
+    fcolor[Face(0)] = Color(0, 1, 0);
+    auto buffers = render_buffers(mesh);
+
+    fcolor[Face(0)] = Color(0, 0, 1);
+    std::vector<unsigned int> updated;
+    ASSERT_TRUE(update_render_buffers(mesh, buffers, {Face(0)}, updated));
+    check_update(mesh, buffers);
+
+    // a new color seam requires a rebuild
+    fcolor[Face(1)] = Color(0, 0, 1);
+    EXPECT_FALSE(update_render_buffers(mesh, buffers, {Face(1)}, updated));
+
+    // and so does a change of connectivity
+    mesh.delete_vertex(Vertex(0));
+    mesh.garbage_collection();
+    EXPECT_FALSE(update_render_buffers(mesh, buffers, {Face(0)}, updated));
+}
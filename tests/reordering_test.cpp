@@ -0,0 +1,126 @@
+// Copyright 2023 the Polygon Mesh Processing Library developers.
+// Distributed under a MIT-style license, see LICENSE.txt for details.
+
+#include "gtest/gtest.h"
+
+#include "pmp/algorithms/reordering.h"
+#include "pmp/algorithms/shapes.h"
+
+#include <algorithm>
+#include <random>
+
+using namespace pmp;
+
+// maximum index difference of two adjacent vertices
+size_t bandwidth(const SurfaceMesh& mesh)
+{
+    size_t b = 0;
+    for (auto e : mesh.edges())
+    {
+        const auto i0 = mesh.vertex(e, 0).idx();
+        const auto i1 = mesh.vertex(e, 1).idx();
+        b = std::max<size_t>(b, i0 > i1 ? i0 - i1 : i1 - i0);
+    }
+    return b;
+}
+
+void shuffle(SurfaceMesh& mesh)
+{
+    std::mt19937 rng(42);
+    std::vector<Vertex> vorder(mesh.vertices_begin(), mesh.vertices_end());
+    std::vector<Edge> eorder(mesh.edges_begin(), mesh.edges_end());
+    std::vector<Face> forder(mesh.faces_begin(), mesh.faces_end());
+    std::shuffle(vorder.begin(), vorder.end(), rng);
+    std::shuffle(eorder.begin(), eorder.end(), rng);
+    std::shuffle(forder.begin(), forder.end(), rng);
+    mesh.permute(vorder, eorder, forder);
+}
+
+void check_connectivity(const SurfaceMesh& mesh)
+{
+    for (auto v : mesh.vertices())
+    {
+        auto h = mesh.halfedge(v);
+        ASSERT_TRUE(h.is_valid());
+        EXPECT_EQ(mesh.from_vertex(h), v);
+    }
+    for (auto h : mesh.halfedges())
+    {
+        EXPECT_EQ(mesh.prev_halfedge(mesh.next_halfedge(h)), h);
+        EXPECT_EQ(mesh.to_vertex(h), mesh.from_vertex(mesh.next_halfedge(h)));
+        EXPECT_EQ(mesh.face(h), mesh.face(mesh.next_halfedge(h)));
+    }
+    for (auto f : mesh.faces())
+        EXPECT_EQ(mesh.face(mesh.halfedge(f)), f);
+}
+
+TEST(ReorderingTest, permute_preserves_properties)
+{
+    auto mesh = icosphere(2);
+    auto original = mesh.add_vertex_property<Point>("v:original");
+    for (auto v : mesh.vertices())
+        original[v] = mesh.position(v);
+    auto face_valence = mesh.add_face_property<size_t>("f:valence");
+    for (auto f : mesh.faces())
+        face_valence[f] = mesh.valence(f);
+
+    const auto nv = mesh.n_vertices();
+    const auto ne = mesh.n_edges();
+    const auto nf = mesh.n_faces();
+
+    shuffle(mesh);
+
+    EXPECT_EQ(mesh.n_vertices(), nv);
+    EXPECT_EQ(mesh.n_edges(), ne);
+    EXPECT_EQ(mesh.n_faces(), nf);
+    check_connectivity(mesh);
+    for (auto v : mesh.vertices())
+        EXPECT_EQ(original[v], mesh.position(v));
+    for (auto f : mesh.faces())
+        EXPECT_EQ(face_valence[f], mesh.valence(f));
+}
+
+TEST(ReorderingTest, permute_invalid_order)
+{
+    auto mesh = icosahedron();
+    std::vector<Vertex> vorder(mesh.vertices_begin(), mesh.vertices_end());
+    std::vector<Edge> eorder(mesh.edges_begin(), mesh.edges_end());
+    std::vector<Face> forder(mesh.faces_begin(), mesh.faces_end());
+    vorder.pop_back();
+    EXPECT_THROW(mesh.permute(vorder, eorder, forder), InvalidInputException);
+}
+
+TEST(ReorderingTest, morton)
+{
+    auto mesh = icosphere(3);
+    shuffle(mesh);
+    const auto shuffled_bandwidth = bandwidth(mesh);
+    const auto nv = mesh.n_vertices();
+
+    reorder(mesh, ReorderingMethod::Morton);
+
+    EXPECT_EQ(mesh.n_vertices(), nv);
+    check_connectivity(mesh);
+    EXPECT_LT(bandwidth(mesh), shuffled_bandwidth);
+}
+
+TEST(ReorderingTest, reverse_cuthill_mckee)
+{
+    auto mesh = icosphere(3);
+    shuffle(mesh);
+    const auto shuffled_bandwidth = bandwidth(mesh);
+
+    reorder(mesh, ReorderingMethod::ReverseCuthillMcKee);
+
+    check_connectivity(mesh);
+    EXPECT_LT(bandwidth(mesh), shuffled_bandwidth / 4);
+}
+
+TEST(ReorderingTest, garbage_is_removed)
+{
+    auto mesh = icosphere(2);
+    mesh.delete_vertex(Vertex(0));
+    reorder(mesh, ReorderingMethod::ReverseCuthillMcKee);
+    EXPECT_EQ(mesh.n_vertices(), mesh.vertices_size());
+    check_connectivity(mesh);
+}
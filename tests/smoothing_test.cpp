@@ -36,3 +36,14 @@ TEST(SmoothingTest, explicit_smoothing)
     auto area_after = surface_area(mesh);
     EXPECT_LT(area_after, area_before);
 }
+
+TEST(SmoothingTest, implicit_smoothing_cancel)
+{
+    auto mesh = open_cone();
+    auto area_before = surface_area(mesh);
+    Progress progress;
+    progress.cancel();
+    EXPECT_THROW(implicit_smoothing(mesh, 0.01, 1, false, false, &progress),
+                 CanceledException);
+    EXPECT_EQ(surface_area(mesh), area_before);
+}
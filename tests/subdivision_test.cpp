@@ -74,3 +74,22 @@ TEST(SubdivisionTest, quad_tri_on_mixed)
     quad_tri_subdivision(mesh);
     EXPECT_EQ(mesh.n_faces(), size_t(20));
 }
+
+TEST(SubdivisionTest, cancel)
+{
+    auto mesh = icosphere(1);
+    const auto n_faces = mesh.n_faces();
+    Progress progress;
+    progress.cancel();
+    EXPECT_THROW(
+        loop_subdivision(mesh, BoundaryHandling::Interpolate, &progress),
+        CanceledException);
+    EXPECT_THROW(catmull_clark_subdivision(
+                     mesh, BoundaryHandling::Interpolate, &progress),
+                 CanceledException);
+    EXPECT_THROW(
+        quad_tri_subdivision(mesh, BoundaryHandling::Interpolate, &progress),
+        CanceledException);
+    EXPECT_THROW(linear_subdivision(mesh, &progress), CanceledException);
+    EXPECT_EQ(mesh.n_faces(), n_faces);
+}
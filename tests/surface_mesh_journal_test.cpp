@@ -0,0 +1,156 @@
+// Copyright 2023 the Polygon Mesh Processing Library developers.
+// Distributed under a MIT-style license, see LICENSE.txt for details.
+
+#include "gtest/gtest.h"
+
+#include "pmp/surface_mesh_journal.h"
+#include "pmp/algorithms/shapes.h"
+
+using namespace pmp;
+
+void expect_equal(const SurfaceMesh& a, const SurfaceMesh& b)
+{
+    ASSERT_EQ(a.vertices_size(), b.vertices_size());
+    ASSERT_EQ(a.halfedges_size(), b.halfedges_size());
+    ASSERT_EQ(a.faces_size(), b.faces_size());
+    EXPECT_EQ(a.n_vertices(), b.n_vertices());
+    EXPECT_EQ(a.n_faces(), b.n_faces());
+    for (auto v : a.vertices())
+        EXPECT_EQ(a.position(v), b.position(v));
+    for (auto h : a.halfedges())
+    {
+        EXPECT_EQ(a.next_halfedge(h), b.next_halfedge(h));
+        EXPECT_EQ(a.to_vertex(h), b.to_vertex(h));
+        EXPECT_EQ(a.face(h), b.face(h));
+    }
+}
+
+TEST(SurfaceMeshJournalTest, replay)
+{
+    auto mesh = icosphere(1);
+    mesh.add_vertex_property<int>("v:label", 0);
+    auto remote = mesh;
+
+    SurfaceMeshJournal journal;
+    mesh.set_journal(&journal);
+
+    // topological operators
+    mesh.split(Face(0), Point(0, 0, 2));
+    mesh.split(Edge(3), Point(0, 2, 0));
+    mesh.flip(Edge(10));
+    mesh.collapse(mesh.halfedge(Edge(20), 0));
+    mesh.add_vertex(Point(3, 3, 3));
+    mesh.delete_face(Face(5));
+    mesh.garbage_collection();
+
+    // property writes
+    mesh.position(Vertex(1)) = Point(4, 4, 4);
+    journal.record(mesh.get_vertex_property<Point>("v:point"), Vertex(1));
+    const Vertex v(2);
+    auto labels = mesh.get_vertex_property<int>("v:label");
+    labels[v] = 7;
+    journal.record(labels, v);
+
+    // nested operators are recorded once
+    EXPECT_LT(journal.data().size(), size_t(200));
+
+    journal.replay(remote);
+    expect_equal(mesh, remote);
+    EXPECT_EQ(remote.get_vertex_property<int>("v:label")[v], 7);
+
+    // transfer the encoded journal
+    auto remote2 = icosphere(1);
+    remote2.add_vertex_property<int>("v:label", 0);
+    SurfaceMeshJournal(journal.data()).replay(remote2);
+    expect_equal(mesh, remote2);
+}
+
+TEST(SurfaceMeshJournalTest, add_faces)
+{
+    SurfaceMesh mesh;
+    SurfaceMeshJournal journal;
+    mesh.set_journal(&journal);
+    auto v0 = mesh.add_vertex(Point(0, 0, 0));
+    auto v1 = mesh.add_vertex(Point(1, 0, 0));
+    auto v2 = mesh.add_vertex(Point(0, 1, 0));
+    auto v3 = mesh.add_vertex(Point(1, 1, 0));
+    mesh.add_triangle(v0, v1, v2);
+    mesh.add_triangle(v1, v3, v2);
+
+    // failed operators are not recorded
+    const auto size = journal.data().size();
+    EXPECT_THROW(mesh.add_triangle(v0, v1, v2), TopologyException);
+    EXPECT_EQ(journal.data().size(), size);
+
+    SurfaceMesh remote;
+    journal.replay(remote);
+    expect_equal(mesh, remote);
+}
+
+TEST(SurfaceMeshJournalTest, invalid_journal)
+{
+    auto mesh = icosphere(1);
+    SurfaceMeshJournal journal;
+    mesh.set_journal(&journal);
+    mesh.split(Face(0), Point(0, 0, 2));
+
+    // replaying on a smaller mesh fails
+    auto small = icosahedron();
+    small.delete_face(Face(0));
+    small.garbage_collection();
+    auto data = journal.data();
+    EXPECT_THROW(SurfaceMeshJournal(data).replay(small), InvalidInputException);
+
+    // truncated data fails
+    data.pop_back();
+    auto copy = icosphere(1);
+    EXPECT_THROW(SurfaceMeshJournal(data).replay(copy), InvalidInputException);
+
+    // missing properties fail
+    auto labels = mesh.add_vertex_property<int>("v:label");
+    journal.record(labels, Vertex(0));
+    auto other = icosphere(1);
+    EXPECT_THROW(journal.replay(other), InvalidInputException);
+}
+
+TEST(SurfaceMeshJournalTest, invalid_operators)
+{
+    // deleting a deleted element fails
+    auto mesh = icosahedron();
+    auto remote = mesh;
+    SurfaceMeshJournal journal;
+    mesh.set_journal(&journal);
+    mesh.delete_face(Face(0));
+    remote.delete_face(Face(0));
+    EXPECT_THROW(journal.replay(remote), InvalidInputException);
+
+    // no-op deletions are not recorded
+    journal.clear();
+    mesh.delete_face(Face(0));
+    EXPECT_TRUE(journal.empty());
+
+    // hand-crafted records, handles are stored as index + 1
+    const uint8_t insert_edge = 5, permute = 14;
+
+    // inserting an edge between halfedges of different faces fails
+    auto target = icosahedron();
+    const auto h0 = target.halfedge(Face(0));
+    const auto h1 = target.halfedge(Face(1));
+    SurfaceMeshJournal bad_insert(
+        {insert_edge, uint8_t(h0.idx() + 1), uint8_t(h1.idx() + 1)});
+    EXPECT_THROW(bad_insert.replay(target), InvalidInputException);
+
+    // adjacent halfedges fail as well
+    const auto h2 = target.next_halfedge(h0);
+    SurfaceMeshJournal adjacent(
+        {insert_edge, uint8_t(h0.idx() + 1), uint8_t(h2.idx() + 1)});
+    EXPECT_THROW(adjacent.replay(target), InvalidInputException);
+
+    // orders that are not permutations fail
+    std::vector<uint8_t> data{permute, uint8_t(target.vertices_size())};
+    for (size_t i = 0; i < target.vertices_size(); ++i)
+        data.push_back(uint8_t(i == 1 ? 1 : i + 1));
+    SurfaceMeshJournal duplicates(data);
+    EXPECT_THROW(duplicates.replay(target), InvalidInputException);
+    EXPECT_EQ(target.n_faces(), size_t(20));
+}
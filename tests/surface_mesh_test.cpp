@@ -4,6 +4,7 @@
 #include "surface_mesh_test.h"
 #include "helpers.h"
 
+#include <memory_resource>
 #include <vector>
 
 using namespace pmp;
@@ -97,6 +98,51 @@ TEST_F(SurfaceMeshTest, delete_center_edge)
     EXPECT_EQ(mesh.n_faces(), size_t(8));
 }
 
+TEST_F(SurfaceMeshTest, stable_garbage_collection)
+{
+    mesh = edge_onering();
+    auto idx = mesh.add_vertex_property<IndexType>("v:idx");
+    for (auto v : mesh.vertices())
+        idx[v] = v.idx();
+
+    auto e = mesh.find_edge(Vertex(4), Vertex(5));
+    mesh.delete_edge(e);
+    auto maps = mesh.stable_garbage_collection();
+
+    EXPECT_EQ(mesh.n_vertices(), size_t(10));
+    EXPECT_EQ(mesh.n_edges(), mesh.edges_size());
+    EXPECT_EQ(mesh.n_faces(), size_t(8));
+    EXPECT_FALSE(maps.edges[e.idx()].is_valid());
+    EXPECT_FALSE(maps.halfedges[mesh.halfedge(e, 0).idx()].is_valid());
+    EXPECT_EQ(maps.faces.size(), size_t(10));
+
+    // remaining elements keep their relative order
+    for (size_t i = 0; i < maps.vertices.size(); ++i)
+        EXPECT_EQ(maps.vertices[i], Vertex(i));
+    Edge prev;
+    for (const auto& ei : maps.edges)
+    {
+        if (!ei.is_valid())
+            continue;
+        if (prev.is_valid())
+        {
+            EXPECT_EQ(ei.idx(), prev.idx() + 1);
+        }
+        prev = ei;
+    }
+    for (auto v : mesh.vertices())
+        EXPECT_EQ(idx[v], v.idx());
+
+    // connectivity is consistent
+    for (auto h : mesh.halfedges())
+    {
+        EXPECT_EQ(mesh.prev_halfedge(mesh.next_halfedge(h)), h);
+        EXPECT_EQ(mesh.to_vertex(h), mesh.from_vertex(mesh.next_halfedge(h)));
+    }
+    for (auto f : mesh.faces())
+        EXPECT_EQ(mesh.face(mesh.halfedge(f)), f);
+}
+
 TEST_F(SurfaceMeshTest, copy)
 {
     add_triangle();
@@ -116,6 +162,133 @@ TEST_F(SurfaceMeshTest, assignment)
     EXPECT_EQ(m2.n_faces(), size_t(1));
 }
 
+TEST_F(SurfaceMeshTest, copy_on_write)
+{
+    add_triangle();
+    auto quality = mesh.add_vertex_property<Scalar>("v:quality", 1.0);
+
+    // copies share their data
+    SurfaceMesh snapshot = mesh;
+    const auto points = mesh.get_vertex_property<Point>("v:point");
+    const auto snapshot_points = snapshot.get_vertex_property<Point>("v:point");
+    EXPECT_EQ(points.data(), snapshot_points.data());
+
+    // reads through const references do not copy
+    const SurfaceMesh& csnapshot = snapshot;
+    EXPECT_EQ(csnapshot.position(Vertex(2)), Point(0, 1, 0));
+    EXPECT_TRUE(snapshot_points.is_shared());
+    EXPECT_EQ(points.data(), snapshot_points.data());
+
+    // modifications copy only the touched properties
+    mesh.position(Vertex(0)) = Point(5, 5, 5);
+    EXPECT_FALSE(snapshot_points.is_shared());
+    quality = mesh.get_vertex_property<Scalar>("v:quality");
+    const auto snapshot_quality =
+        snapshot.get_vertex_property<Scalar>("v:quality");
+    const auto cquality = quality;
+    EXPECT_EQ(cquality.data(), snapshot_quality.data());
+    EXPECT_NE(points.data(), snapshot_points.data());
+    EXPECT_EQ(snapshot.position(Vertex(0)), Point(0, 0, 0));
+
+    // topological changes leave the snapshot intact
+    mesh.add_vertex(Point(1, 1, 0));
+    mesh.delete_face(Face(0));
+    mesh.garbage_collection();
+    EXPECT_EQ(snapshot.n_vertices(), size_t(3));
+    EXPECT_EQ(snapshot.n_faces(), size_t(1));
+    EXPECT_EQ(snapshot_quality[Vertex(2)], 1.0);
+
+    // roll back
+    mesh = snapshot;
+    EXPECT_EQ(mesh.n_vertices(), size_t(3));
+    EXPECT_EQ(mesh.n_faces(), size_t(1));
+    EXPECT_EQ(mesh.position(Vertex(0)), Point(0, 0, 0));
+}
+
+TEST_F(SurfaceMeshTest, copy_on_write_handles)
+{
+    add_triangle();
+    auto normals = mesh.add_vertex_property<Normal>("v:normal");
+
+    // handles obtained before copying write to their own mesh only
+    SurfaceMesh copy = mesh;
+    normals[Vertex(0)] = Normal(0, 0, 1);
+    mesh.position(Vertex(1)) = Point(2, 0, 0);
+    EXPECT_EQ(copy.get_vertex_property<Normal>("v:normal")[Vertex(0)],
+              Normal(0, 0, 0));
+    EXPECT_EQ(copy.position(Vertex(1)), Point(1, 0, 0));
+
+    // and so do handles of the copy
+    auto copy_normals = copy.get_vertex_property<Normal>("v:normal");
+    copy_normals[Vertex(1)] = Normal(1, 0, 0);
+    copy.position(Vertex(2)) = Point(0, 2, 0);
+    EXPECT_EQ(normals[Vertex(1)], Normal(0, 0, 0));
+    EXPECT_EQ(mesh.position(Vertex(2)), Point(0, 1, 0));
+}
+
+TEST_F(SurfaceMeshTest, memory_resource)
+{
+    // counts the bytes allocated from an upstream resource
+    class CountingResource : public std::pmr::memory_resource
+    {
+    public:
+        size_t allocated{0};
+
+    private:
+        void* do_allocate(size_t bytes, size_t alignment) override
+        {
+            allocated += bytes;
+            return std::pmr::new_delete_resource()->allocate(bytes, alignment);
+        }
+        void do_deallocate(void* p, size_t bytes, size_t alignment) override
+        {
+            std::pmr::new_delete_resource()->deallocate(p, bytes, alignment);
+        }
+        bool do_is_equal(
+            const std::pmr::memory_resource& other) const noexcept override
+        {
+            return this == &other;
+        }
+    };
+
+    CountingResource resource;
+    {
+        SurfaceMesh arena_mesh(&resource);
+        EXPECT_EQ(arena_mesh.memory_resource(), &resource);
+        auto a = arena_mesh.add_vertex(Point(0, 0, 0));
+        auto b = arena_mesh.add_vertex(Point(1, 0, 0));
+        auto c = arena_mesh.add_vertex(Point(0, 1, 0));
+        arena_mesh.add_triangle(a, b, c);
+        const size_t allocated = resource.allocated;
+        EXPECT_GT(allocated, size_t(0));
+
+        // properties added later use the resource as well
+        arena_mesh.add_vertex_property<Scalar>("v:quality");
+        EXPECT_GT(resource.allocated, allocated);
+
+        // and so do copies
+        SurfaceMesh copy = arena_mesh;
+        EXPECT_EQ(copy.memory_resource(), &resource);
+        copy.position(a) = Point(1, 1, 1);
+        EXPECT_EQ(arena_mesh.position(a), Point(0, 0, 0));
+
+        // assignment keeps the resource of the target and copies the data
+        mesh = arena_mesh;
+        EXPECT_EQ(mesh.memory_resource(), nullptr);
+        const size_t before_edit = resource.allocated;
+        mesh.position(a) = Point(2, 2, 2);
+        mesh.add_vertex(Point(3, 3, 3));
+        EXPECT_EQ(resource.allocated, before_edit);
+    }
+
+    // the assigned mesh survives the arena mesh
+    EXPECT_EQ(mesh.n_vertices(), size_t(4));
+    EXPECT_EQ(mesh.position(Vertex(0)), Point(2, 2, 2));
+
+    // the default mesh does not use a resource
+    EXPECT_EQ(mesh.memory_resource(), nullptr);
+}
+
 TEST_F(SurfaceMeshTest, vertex_properties)
 {
     add_triangle();
@@ -136,6 +309,60 @@ TEST_F(SurfaceMeshTest, vertex_properties)
     EXPECT_EQ(mesh.vertex_properties().size(), osize);
 }
 
+TEST_F(SurfaceMeshTest, property_lookup)
+{
+    add_triangle();
+
+    constexpr PropertyKey<Point> vpoint_key("v:point");
+    auto points = mesh.get_vertex_property(vpoint_key);
+    EXPECT_TRUE(points);
+    EXPECT_EQ(points[v0], mesh.position(v0));
+
+    // type mismatch
+    EXPECT_FALSE(mesh.get_vertex_property(PropertyKey<int>("v:point")));
+
+    // index follows removal and copy
+    auto fidx = mesh.add_face_property<int>("f:idx", 42);
+    EXPECT_TRUE(mesh.has_face_property("f:idx"));
+    EXPECT_FALSE(mesh.add_face_property<int>("f:idx"));
+
+    SurfaceMesh copy = mesh;
+    mesh.remove_face_property(fidx);
+    EXPECT_FALSE(mesh.has_face_property("f:idx"));
+    EXPECT_FALSE(mesh.get_face_property<int>("f:idx"));
+    auto copied = copy.get_face_property<int>("f:idx");
+    ASSERT_TRUE(copied);
+    EXPECT_EQ(copied[Face(0)], 42);
+}
+
+TEST_F(SurfaceMeshTest, property_data)
+{
+    add_triangle();
+
+    // raw access to aligned storage
+    auto points = mesh.get_vertex_property<Point>("v:point");
+    EXPECT_EQ(points.size(), mesh.n_vertices());
+    EXPECT_EQ(reinterpret_cast<uintptr_t>(points.data()) %
+                  PMP_PROPERTY_ALIGNMENT,
+              0u);
+    points.data()[1] = Point(1, 2, 3);
+    EXPECT_EQ(mesh.position(v1), Point(1, 2, 3));
+
+    // flags are stored byte-wise
+    auto vselected = mesh.add_vertex_property<bool>("v:selected", false);
+    bool& selected = vselected[v2];
+    selected = true;
+    EXPECT_TRUE(vselected.data()[2]);
+    EXPECT_FALSE(vselected.data()[0]);
+
+    // arrays grow along with the mesh
+    for (int i = 0; i < 100; ++i)
+        mesh.add_vertex(Point(0, 0, 0));
+    EXPECT_EQ(vselected.size(), mesh.n_vertices());
+    EXPECT_TRUE(vselected[v2]);
+    EXPECT_FALSE(vselected[Vertex(102)]);
+}
+
 TEST_F(SurfaceMeshTest, halfedge_properties)
 {
     add_triangle();
@@ -0,0 +1,110 @@
+// Copyright 2023 the Polygon Mesh Processing Library developers.
+// Distributed under a MIT-style license, see LICENSE.txt for details.
+
+#include "gtest/gtest.h"
+
+#include "pmp/surface_mesh_view.h"
+#include "pmp/algorithms/shapes.h"
+
+#include <thread>
+
+using namespace pmp;
+
+// number of vertices within k rings of v
+size_t ring_size(const SurfaceMeshView& view, Vertex v, int k)
+{
+    auto visited = view.vertex_scratch<bool>(false);
+    std::vector<Vertex> ring{v}, next;
+    visited[v] = true;
+    size_t n = 1;
+    for (int i = 0; i < k; ++i)
+    {
+        next.clear();
+        for (auto vv : ring)
+            for (auto vn : view.vertices(vv))
+                if (!visited[vn])
+                {
+                    visited[vn] = true;
+                    next.push_back(vn);
+                }
+        n += next.size();
+        ring.swap(next);
+    }
+    return n;
+}
+
+TEST(SurfaceMeshViewTest, properties)
+{
+    auto mesh = icosphere(1);
+    auto vquality = mesh.add_vertex_property<Scalar>("v:quality", 1.0);
+    vquality[Vertex(0)] = 2.0;
+
+    const SurfaceMeshView view(mesh);
+    const auto nprops = mesh.vertex_properties().size();
+
+    auto quality = view.get_vertex_property<Scalar>("v:quality");
+    ASSERT_TRUE(quality);
+    EXPECT_EQ(quality[Vertex(0)], 2.0);
+    EXPECT_EQ(quality[Vertex(1)], 1.0);
+    EXPECT_EQ(quality.size(), mesh.vertices_size());
+
+    // lookups of missing properties do not add them
+    EXPECT_FALSE(view.get_vertex_property<Scalar>("v:missing"));
+    EXPECT_FALSE(view.get_face_property<int>("f:missing"));
+    EXPECT_EQ(mesh.vertex_properties().size(), nprops);
+
+    // scratch properties live outside the mesh
+    auto distance = view.vertex_scratch<Scalar>(-1.0);
+    auto flags = view.edge_scratch<bool>(true);
+    EXPECT_EQ(distance.size(), mesh.vertices_size());
+    EXPECT_EQ(flags.size(), mesh.edges_size());
+    EXPECT_EQ(distance[Vertex(3)], -1.0);
+    EXPECT_TRUE(flags[Edge(3)]);
+    distance.fill(0.0);
+    EXPECT_EQ(distance[Vertex(3)], 0.0);
+    EXPECT_EQ(mesh.vertex_properties().size(), nprops);
+}
+
+TEST(SurfaceMeshViewTest, queries)
+{
+    const auto mesh = icosphere(1);
+    const SurfaceMeshView view(mesh);
+    EXPECT_EQ(view.n_vertices(), mesh.n_vertices());
+    EXPECT_EQ(view.n_faces(), mesh.n_faces());
+    EXPECT_TRUE(view.is_triangle_mesh());
+
+    const Vertex v(0);
+    EXPECT_EQ(view.valence(v), mesh.valence(v));
+    EXPECT_EQ(view.position(v), mesh.position(v));
+    const auto h = view.halfedge(v);
+    EXPECT_EQ(view.find_halfedge(v, view.to_vertex(h)), h);
+
+    // property lookups only hand out read-only properties
+    static_assert(std::is_same_v<decltype(view.get_vertex_property<Point>(
+                                     "v:point")),
+                                 ReadOnlyProperty<Vertex, Point>>);
+}
+
+TEST(SurfaceMeshViewTest, concurrent_queries)
+{
+    const auto mesh = icosphere(3);
+    const SurfaceMeshView view(mesh);
+
+    std::vector<size_t> expected(mesh.n_vertices());
+    for (auto v : mesh.vertices())
+        expected[v.idx()] = ring_size(view, v, 3);
+
+    const size_t n_threads = 4;
+    std::vector<std::vector<size_t>> results(n_threads);
+    std::vector<std::thread> threads;
+    for (size_t t = 0; t < n_threads; ++t)
+        threads.emplace_back([&, t] {
+            for (auto v : view.vertices())
+                results[t].push_back(ring_size(view, v, 3));
+        });
+    for (auto& t : threads)
+        t.join();
+
+    for (const auto& r : results)
+        EXPECT_EQ(r, expected);
+}
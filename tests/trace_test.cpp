@@ -0,0 +1,121 @@
+// Copyright 2023 the Polygon Mesh Processing Library developers.
+// Distributed under a MIT-style license, see LICENSE.txt for details.
+
+#include "gtest/gtest.h"
+
+#include "pmp/trace.h"
+#include "pmp/algorithms/remeshing.h"
+#include "pmp/algorithms/shapes.h"
+#include "pmp/algorithms/utilities.h"
+
+#include <algorithm>
+#include <fstream>
+#include <sstream>
+
+using namespace pmp;
+
+class TraceTest : public ::testing::Test
+{
+protected:
+    void SetUp() override
+    {
+        Tracer::instance().clear();
+        Tracer::instance().enable();
+    }
+
+    void TearDown() override
+    {
+        Tracer::instance().enable(false);
+        Tracer::instance().clear();
+    }
+
+    // names of the events with the given phase
+    static std::vector<std::string> names(char phase)
+    {
+        std::vector<std::string> result;
+        for (const auto& e : Tracer::instance().events())
+            if (e.phase == phase)
+                result.emplace_back(e.name);
+        return result;
+    }
+};
+
+TEST_F(TraceTest, nested_scopes)
+{
+    {
+        TraceScope outer("outer");
+        {
+            TraceScope inner("inner");
+        }
+    }
+
+    const auto events = Tracer::instance().events();
+    ASSERT_EQ(events.size(), size_t(4));
+    EXPECT_EQ(events[0].phase, 'B');
+    EXPECT_STREQ(events[0].name, "outer");
+    EXPECT_STREQ(events[1].name, "inner");
+    EXPECT_EQ(events[2].phase, 'E');
+    EXPECT_STREQ(events[2].name, "inner");
+    EXPECT_STREQ(events[3].name, "outer");
+    EXPECT_GT(events[3].value, 0); // peak memory
+    for (size_t i = 1; i < events.size(); ++i)
+        EXPECT_GE(events[i].timestamp, events[i - 1].timestamp);
+}
+
+TEST_F(TraceTest, counters)
+{
+    Tracer::instance().count("flips", 3);
+    Tracer::instance().count("flips", 2);
+    EXPECT_EQ(Tracer::instance().counter("flips"), 5);
+    EXPECT_EQ(Tracer::instance().counter("splits"), 0);
+    EXPECT_EQ(Tracer::instance().events().back().value, 5);
+}
+
+TEST_F(TraceTest, disabled)
+{
+    Tracer::instance().enable(false);
+    {
+        TraceScope scope("scope");
+    }
+    EXPECT_TRUE(Tracer::instance().events().empty());
+}
+
+TEST_F(TraceTest, write)
+{
+    {
+        TraceScope scope("scope");
+        Tracer::instance().count("collapses", 7);
+    }
+    Tracer::instance().write("trace.json");
+
+    std::ifstream ifs("trace.json");
+    std::stringstream ss;
+    ss << ifs.rdbuf();
+    const auto json = ss.str();
+    EXPECT_EQ(json.find("{\"displayTimeUnit\":\"ms\",\"traceEvents\":["), 0u);
+    EXPECT_NE(json.find("\"name\":\"scope\",\"ph\":\"B\""), std::string::npos);
+    EXPECT_NE(json.find("\"args\":{\"collapses\":7}"), std::string::npos);
+    EXPECT_NE(json.find("\"peak_memory\":"), std::string::npos);
+    EXPECT_EQ(std::count(json.begin(), json.end(), '{'),
+              std::count(json.begin(), json.end(), '}'));
+
+    EXPECT_THROW(Tracer::instance().write("/nonexistent/trace.json"),
+                 IOException);
+}
+
+#ifdef PMP_ENABLE_TRACING
+TEST_F(TraceTest, uniform_remeshing)
+{
+    auto mesh = icosphere(3);
+    uniform_remeshing(mesh, 0.5 * mean_edge_length(mesh), 2);
+
+    const auto begins = names('B');
+    for (auto name : {"uniform_remeshing", "preprocessing", "kd_tree",
+                      "split_long_edges", "collapse_short_edges", "flip_edges",
+                      "tangential_smoothing", "projection", "remove_caps"})
+        EXPECT_NE(std::find(begins.begin(), begins.end(), name), begins.end())
+            << name;
+    EXPECT_EQ(begins.size(), names('E').size());
+    EXPECT_GT(Tracer::instance().counter("splits"), 0);
+}
+#endif
@@ -0,0 +1,167 @@
+// Copyright 2023 the Polygon Mesh Processing Library developers.
+// Distributed under a MIT-style license, see LICENSE.txt for details.
+
+#include "gtest/gtest.h"
+
+#include "pmp/algorithms/vertex_cache.h"
+#include "pmp/algorithms/shapes.h"
+
+#include <algorithm>
+#include <array>
+#include <deque>
+#include <random>
+
+using namespace pmp;
+
+// triangles of a mesh in random order
+std::vector<unsigned int> shuffled_triangles(const SurfaceMesh& mesh)
+{
+    std::vector<Face> faces(mesh.faces_begin(), mesh.faces_end());
+    std::shuffle(faces.begin(), faces.end(), std::mt19937(42));
+
+    std::vector<unsigned int> triangles;
+    for (auto f : faces)
+        for (auto v : mesh.vertices(f))
+            triangles.push_back(v.idx());
+    return triangles;
+}
+
+// average cache miss ratio of a FIFO cache of 16 entries
+double fifo_acmr(const std::vector<unsigned int>& triangles)
+{
+    std::deque<unsigned int> cache;
+    size_t misses = 0;
+    for (auto i : triangles)
+    {
+        if (std::find(cache.begin(), cache.end(), i) != cache.end())
+            continue;
+        ++misses;
+        cache.push_back(i);
+        if (cache.size() > 16)
+            cache.pop_front();
+    }
+    return double(misses) / double(triangles.size() / 3);
+}
+
+// triangles rotated such that the smallest index comes first, sorted
+std::vector<std::array<unsigned int, 3>> canonical_triangles(
+    const std::vector<unsigned int>& triangles)
+{
+    std::vector<std::array<unsigned int, 3>> result;
+    for (size_t i = 0; i < triangles.size(); i += 3)
+    {
+        std::array<unsigned int, 3> t{triangles[i], triangles[i + 1],
+                                      triangles[i + 2]};
+        std::rotate(t.begin(), std::min_element(t.begin(), t.end()), t.end());
+        result.push_back(t);
+    }
+    std::sort(result.begin(), result.end());
+    return result;
+}
+
+TEST(VertexCacheTest, optimize_vertex_cache)
+{
+    const auto mesh = icosphere(4);
+    auto triangles = shuffled_triangles(mesh);
+    const auto original = triangles;
+
+    optimize_vertex_cache(triangles, mesh.n_vertices());
+
+    // same triangles with the same orientation
+    EXPECT_EQ(canonical_triangles(triangles), canonical_triangles(original));
+
+    // a shuffled mesh has an ACMR close to 3, an optimized one close to 0.5
+    EXPECT_GT(fifo_acmr(original), 2.0);
+    EXPECT_LT(fifo_acmr(triangles), 0.8);
+}
+
+TEST(VertexCacheTest, invalid_input)
+{
+    std::vector<unsigned int> triangles{0, 1};
+    EXPECT_THROW(optimize_vertex_cache(triangles, 3), InvalidInputException);
+    triangles = {0, 1, 3};
+    EXPECT_THROW(optimize_vertex_cache(triangles, 3), InvalidInputException);
+    triangles.clear();
+    EXPECT_NO_THROW(optimize_vertex_cache(triangles, 0));
+}
+
+TEST(VertexCacheTest, statistics)
+{
+    const std::vector<unsigned int> triangles{0, 1, 2, 2, 1, 3};
+    const auto stats = vertex_cache_statistics(triangles, 4);
+    EXPECT_DOUBLE_EQ(stats.acmr, 2.0);
+    EXPECT_DOUBLE_EQ(stats.atvr, 1.0);
+
+    // a cache of one entry only keeps vertex 2
+    EXPECT_DOUBLE_EQ(vertex_cache_statistics(triangles, 4, 1).acmr, 2.5);
+
+    EXPECT_THROW(vertex_cache_statistics(triangles, 4, 0),
+                 InvalidInputException);
+    EXPECT_THROW(vertex_cache_statistics(quad_sphere(1)),
+                 InvalidInputException);
+}
+
+TEST(VertexCacheTest, optimize_overdraw)
+{
+    const auto mesh = icosphere(4);
+    auto triangles = shuffled_triangles(mesh);
+    const auto original = triangles;
+    std::vector<vec3> positions;
+    for (auto v : mesh.vertices())
+        positions.emplace_back(mesh.position(v));
+
+    optimize_vertex_cache(triangles, mesh.n_vertices());
+    const auto acmr = vertex_cache_statistics(triangles, positions.size()).acmr;
+    optimize_overdraw(triangles, positions);
+    EXPECT_EQ(canonical_triangles(triangles), canonical_triangles(original));
+
+    // restarting the cache at each cluster costs little
+    const auto stats = vertex_cache_statistics(triangles, positions.size());
+    EXPECT_LT(stats.acmr, 1.1 * acmr);
+}
+
+TEST(VertexCacheTest, optimize_vertex_fetch)
+{
+    std::vector<unsigned int> triangles{3, 1, 4, 4, 1, 0};
+    const auto order = optimize_vertex_fetch(triangles, 6);
+    EXPECT_EQ(triangles, (std::vector<unsigned int>{0, 1, 2, 2, 1, 3}));
+    EXPECT_EQ(order, (std::vector<unsigned int>{3, 1, 4, 0, 2, 5}));
+}
+
+TEST(VertexCacheTest, optimize_draw_order)
+{
+    auto mesh = icosphere(4);
+    std::vector<Vertex> vorder(mesh.vertices_begin(), mesh.vertices_end());
+    std::vector<Edge> eorder(mesh.edges_begin(), mesh.edges_end());
+    std::vector<Face> forder(mesh.faces_begin(), mesh.faces_end());
+    std::mt19937 rng(42);
+    std::shuffle(vorder.begin(), vorder.end(), rng);
+    std::shuffle(forder.begin(), forder.end(), rng);
+    mesh.permute(vorder, eorder, forder);
+
+    auto original = mesh.add_vertex_property<Point>("v:original");
+    for (auto v : mesh.vertices())
+        original[v] = mesh.position(v);
+    const auto before = vertex_cache_statistics(mesh);
+
+    optimize_draw_order(mesh, true);
+
+    const auto after = vertex_cache_statistics(mesh);
+    EXPECT_GT(before.acmr, 2.0);
+    EXPECT_LT(after.acmr, 0.8);
+    EXPECT_LT(after.atvr, 1.5);
+
+    // vertices are numbered by first use
+    std::vector<unsigned int> triangles;
+    for (auto f : mesh.faces())
+        for (auto v : mesh.vertices(f))
+            triangles.push_back(v.idx());
+    const auto order = optimize_vertex_fetch(triangles, mesh.n_vertices());
+    for (size_t i = 0; i < order.size(); ++i)
+        EXPECT_EQ(order[i], i);
+
+    // properties are permuted along with the vertices
+    original = mesh.get_vertex_property<Point>("v:original");
+    for (auto v : mesh.vertices())
+        EXPECT_EQ(original[v], mesh.position(v));
+}